@@ -52,9 +52,10 @@ FileData::FileData(FileType type, const fs::path& path, SystemData* system)
 	: mType(type), mPath(path), mSystem(system), mParent(NULL), metadata(type == GAME ? GAME_METADATA : FOLDER_METADATA) // metadata is REALLY set in the constructor!
 {
 	// metadata needs at least a name field (since that's what getName() will return)
+	// not in a tree yet: no other thread can see this node, no need for the game data lock
 	if(metadata.get("name").empty())
-		metadata.set("name", getCleanName());
-	metadata.set("system", system->getName());
+		metadata.setValue("name", getCleanName());
+	metadata.setValue("system", system->getName());
 }
 
 FileData::~FileData()
@@ -136,6 +137,7 @@ std::vector<FileData*> FileData::getHiddenRecursive(unsigned int typeMask) const
 
 void FileData::addChild(FileData* file)
 {
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
 	assert(mType == FOLDER);
 	assert(file->getParent() == NULL);
 
@@ -151,6 +153,7 @@ void FileData::addChild(FileData* file)
 
 void FileData::addAlreadyExistingChild(FileData* file)
 {
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
 	assert(mType == FOLDER);
 	mChildren.push_back(file);
 }
@@ -158,7 +161,9 @@ void FileData::addAlreadyExistingChild(FileData* file)
 
 void FileData::removeAlreadyExistingChild(FileData* file)
 {
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
 	assert(mType == FOLDER);
+	addGameDataRemoval();
 	for(auto it = mChildren.begin(); it != mChildren.end(); it++)
 	{
 		if(*it == file)
@@ -173,9 +178,11 @@ void FileData::removeAlreadyExistingChild(FileData* file)
 
 void FileData::removeChild(FileData* file)
 {
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
 	assert(mType == FOLDER);
 	assert(file->getParent() == this);
 
+	addGameDataRemoval();
 	mChildrenByFilename.erase(file->getPath().filename().string());
 	for(auto it = mChildren.begin(); it != mChildren.end(); it++)
 	{
@@ -189,6 +196,8 @@ void FileData::removeChild(FileData* file)
 
 void FileData::clear()
 {
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+	addGameDataRemoval();
 	mChildren.clear();
 }
 
@@ -65,6 +65,9 @@ public:
 	// Returns our best guess at the "real" name for this file (will strip parenthesis and attempt to perform MAME name translation)
 	std::string getCleanName() const;
 
+	// Returns the collation key of the name (case-folded, accents stripped, leading article skipped).
+	inline const std::string& getSortKey() const { return metadata.getSortKey(); }
+
 	bool isSingleGameFolder() const;
 
 	typedef bool ComparisonFunction(const FileData* a, const FileData* b);
@@ -0,0 +1,329 @@
+#include "FileSortIndex.h"
+#include "FileSorts.h"
+#include <algorithm>
+#include <unordered_set>
+
+FileSortIndex::FileSortIndex()
+{
+}
+
+void FileSortIndex::build(const std::vector<FileData*>& files)
+{
+	clear();
+
+	mEntries.reserve(files.size());
+	for (auto file : files)
+	{
+		std::unique_ptr<Entry>& entry = mEntries[file];
+		entry.reset(new Entry());
+		fillEntry(*entry, file);
+	}
+
+	for (int i = 0; i < ORDER_COUNT; i++)
+	{
+		std::vector<const Entry*>& ordered = mOrderings[i];
+		ordered.reserve(mEntries.size());
+		for (auto it = mEntries.begin(); it != mEntries.end(); it++)
+			ordered.push_back(it->second.get());
+
+		sort((Ordering)i, ordered);
+	}
+}
+
+void FileSortIndex::clear()
+{
+	for (int i = 0; i < ORDER_COUNT; i++)
+		mOrderings[i].clear();
+	mPending.clear();
+	mRemoved.clear();
+	mEntries.clear();
+}
+
+bool FileSortIndex::contains(FileData* file) const
+{
+	return mEntries.find(file) != mEntries.end();
+}
+
+void FileSortIndex::add(FileData* file)
+{
+	if (contains(file))
+		return;
+
+	std::unique_ptr<Entry>& entry = mEntries[file];
+	entry.reset(new Entry());
+	entry->file = file;
+	mPending.insert(entry.get());
+}
+
+void FileSortIndex::remove(FileData* file)
+{
+	auto it = mEntries.find(file);
+	if (it == mEntries.end())
+		return;
+
+	// the file may be deleted right away, but the orderings still point to its entry
+	mPending.erase(it->second.get());
+	mRemoved.push_back(std::move(it->second));
+	mEntries.erase(it);
+}
+
+void FileSortIndex::update(FileData* file)
+{
+	auto it = mEntries.find(file);
+	if (it == mEntries.end())
+	{
+		add(file);
+		return;
+	}
+
+	mPending.insert(it->second.get());
+}
+
+void FileSortIndex::flush()
+{
+	if (mPending.empty() && mRemoved.empty())
+		return;
+
+	// everything leaving the orderings, the pending entries come back below at their new place
+	std::unordered_set<const Entry*> leaving(mPending.begin(), mPending.end());
+	for (auto& entry : mRemoved)
+		leaving.insert(entry.get());
+
+	std::vector<const Entry*> batch;
+	batch.reserve(mPending.size());
+	for (auto entry : mPending)
+	{
+		fillEntry(*entry, entry->file);
+		batch.push_back(entry);
+	}
+
+	for (int i = 0; i < ORDER_COUNT; i++)
+	{
+		Ordering ordering = (Ordering)i;
+		auto comparator = [ordering](const Entry* a, const Entry* b) { return less(ordering, a, b); };
+		std::vector<const Entry*>& ordered = mOrderings[i];
+
+		ordered.erase(std::remove_if(ordered.begin(), ordered.end(), [&leaving](const Entry* entry) { return leaving.find(entry) != leaving.end(); }), ordered.end());
+
+		// one linear merge of the sorted batch, instead of one shift of the whole ordering per entry
+		std::sort(batch.begin(), batch.end(), comparator);
+		size_t middle = ordered.size();
+		ordered.insert(ordered.end(), batch.begin(), batch.end());
+		std::inplace_merge(ordered.begin(), ordered.begin() + middle, ordered.end(), comparator);
+	}
+
+	mPending.clear();
+	mRemoved.clear();
+}
+
+std::vector<FileData*> FileSortIndex::order(const std::vector<FileData*>& files, const FileData::SortType& sortType)
+{
+	const Ordering ordering = getOrdering(sortType.comparisonFunction);
+
+	// files that appeared since the index was built are indexed on the fly
+	for (auto file : files)
+		add(file);
+	flush();
+
+	std::vector<FileData*> out;
+	out.reserve(files.size());
+
+	if (files.size() * 16 < mEntries.size())
+	{
+		// small subset (a sub-folder for instance): cheaper to sort on the precomputed keys
+		std::vector<const Entry*> entries;
+		entries.reserve(files.size());
+		for (auto file : files)
+			entries.push_back(mEntries.find(file)->second.get());
+
+		std::sort(entries.begin(), entries.end(), [ordering](const Entry* a, const Entry* b) { return less(ordering, a, b); });
+		for (auto entry : entries)
+			out.push_back(entry->file);
+	}
+	else
+	{
+		// otherwise filter the maintained ordering, no comparison at all
+		std::unordered_set<FileData*> wanted(files.begin(), files.end());
+		for (auto entry : mOrderings[ordering])
+			if (wanted.find(entry->file) != wanted.end())
+				out.push_back(entry->file);
+	}
+
+	if (!sortType.ascending)
+		std::reverse(out.begin(), out.end());
+
+	return out;
+}
+
+bool FileSortIndex::isBefore(FileData* a, FileData* b, const FileData::SortType& sortType)
+{
+	add(a);
+	add(b);
+	flush();
+
+	const Entry* entryA = mEntries.find(a)->second.get();
+	const Entry* entryB = mEntries.find(b)->second.get();
+	const Ordering ordering = getOrdering(sortType.comparisonFunction);
+	return sortType.ascending ? less(ordering, entryA, entryB) : less(ordering, entryB, entryA);
+}
+
+FileSortIndex::Ordering FileSortIndex::getOrdering(FileData::ComparisonFunction* comparisonFunction)
+{
+	if (comparisonFunction == &FileSorts::compareRating)
+		return ORDER_RATING;
+	if (comparisonFunction == &FileSorts::compareTimesPlayed)
+		return ORDER_TIMES_PLAYED;
+	if (comparisonFunction == &FileSorts::compareLastPlayed)
+		return ORDER_LAST_PLAYED;
+	if (comparisonFunction == &FileSorts::compareNumberPlayers)
+		return ORDER_NUMBER_PLAYERS;
+	if (comparisonFunction == &FileSorts::compareDevelopper)
+		return ORDER_DEVELOPER;
+	if (comparisonFunction == &FileSorts::compareGenre)
+		return ORDER_GENRE;
+	return ORDER_NAME;
+}
+
+// Same criteria as the FileSorts comparison functions, plus a tie-break on name then
+// on the file itself: a strict total order is required to find entries back by binary search.
+// Folders carry default values for game-only metadata so that the order stays transitive.
+bool FileSortIndex::less(Ordering ordering, const Entry* a, const Entry* b)
+{
+	switch (ordering)
+	{
+		case ORDER_RATING:
+			if (a->rating != b->rating) return a->rating < b->rating;
+			break;
+		case ORDER_TIMES_PLAYED:
+			if (a->timesPlayed != b->timesPlayed) return a->timesPlayed < b->timesPlayed;
+			break;
+		case ORDER_LAST_PLAYED:
+			if (a->lastPlayed != b->lastPlayed) return a->lastPlayed < b->lastPlayed;
+			break;
+		case ORDER_NUMBER_PLAYERS:
+			if (a->players != b->players) return a->players < b->players;
+			break;
+		case ORDER_DEVELOPER:
+			if (a->developer != b->developer) return a->developer < b->developer;
+			break;
+		case ORDER_GENRE:
+			if (a->genre != b->genre) return a->genre < b->genre;
+			break;
+		default:
+			break;
+	}
+
+	if (a->name != b->name)
+		return a->name < b->name;
+	return a->file < b->file;
+}
+
+void FileSortIndex::fillEntry(Entry& entry, FileData* file)
+{
+	const MetaDataList& metadata = file->metadata;
+
+	entry.file = file;
+	entry.name = file->getSortKey();
+
+	//only games have sortable metadata
+	if (metadata.getType() == GAME_METADATA)
+	{
+		entry.developer = FileSorts::makeCollationKey(metadata.get("developer"), false);
+		entry.genre = FileSorts::makeCollationKey(metadata.get("genre"), false);
+		entry.rating = metadata.getFloat("rating");
+		entry.timesPlayed = metadata.getInt("playcount");
+		entry.players = metadata.getInt("players");
+		entry.lastPlayed = metadata.getTime("lastplayed");
+	}
+	else
+	{
+		entry.developer.clear();
+		entry.genre.clear();
+		entry.rating = 0;
+		entry.timesPlayed = 0;
+		entry.players = 0;
+		entry.lastPlayed = boost::posix_time::ptime();
+	}
+}
+
+void FileSortIndex::sort(Ordering ordering, std::vector<const Entry*>& ordered)
+{
+	std::string Entry::* key = nullptr;
+	switch (ordering)
+	{
+		case ORDER_NAME: key = &Entry::name; break;
+		case ORDER_DEVELOPER: key = &Entry::developer; break;
+		case ORDER_GENRE: key = &Entry::genre; break;
+		default: break;
+	}
+
+	auto comparator = [ordering](const Entry* a, const Entry* b) { return less(ordering, a, b); };
+
+	if (key == nullptr)
+	{
+		std::sort(ordered.begin(), ordered.end(), comparator);
+		return;
+	}
+
+	std::vector<const Entry*> buffer(ordered.size());
+	radixSort(ordered.begin(), ordered.end(), key, 0, buffer);
+
+	// entries sharing the same key still have to be ordered by the tie-breaks
+	for (auto begin = ordered.begin(); begin != ordered.end(); )
+	{
+		auto end = begin + 1;
+		while (end != ordered.end() && (*end)->*key == (*begin)->*key)
+			end++;
+		if (end - begin > 1)
+			std::sort(begin, end, comparator);
+		begin = end;
+	}
+}
+
+void FileSortIndex::radixSort(EntryIterator begin, EntryIterator end, std::string Entry::* key, size_t depth, std::vector<const Entry*>& buffer)
+{
+	const size_t count = end - begin;
+
+	// small buckets: insertion sort on the remaining characters
+	if (count <= 32)
+	{
+		for (auto it = begin + 1; it < end; it++)
+		{
+			const Entry* entry = *it;
+			auto hole = it;
+			while (hole != begin && ((*(hole - 1))->*key).compare(depth, std::string::npos, entry->*key, depth, std::string::npos) > 0)
+			{
+				*hole = *(hole - 1);
+				hole--;
+			}
+			*hole = entry;
+		}
+		return;
+	}
+
+	// bucket 0 holds keys ending at this depth, bucket n+1 keys whose current character is n
+	size_t counts[258] = { 0 };
+	for (auto it = begin; it != end; it++)
+	{
+		const std::string& str = (*it)->*key;
+		counts[(depth < str.length() ? (unsigned char)str[depth] + 1 : 0) + 1]++;
+	}
+	for (int i = 1; i < 258; i++)
+		counts[i] += counts[i - 1];
+
+	for (auto it = begin; it != end; it++)
+	{
+		const std::string& str = (*it)->*key;
+		buffer[counts[depth < str.length() ? (unsigned char)str[depth] + 1 : 0]++] = *it;
+	}
+	std::copy(buffer.begin(), buffer.begin() + count, begin);
+
+	// counts[i] is now the end of bucket i; bucket 0 is fully sorted already
+	for (int i = 1; i < 257; i++)
+	{
+		size_t bucketBegin = counts[i - 1];
+		size_t bucketEnd = counts[i];
+		if (bucketEnd - bucketBegin > 1)
+			radixSort(begin + bucketBegin, begin + bucketEnd, key, depth + 1, buffer);
+	}
+}
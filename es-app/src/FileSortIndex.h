@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "FileData.h"
+
+// Keeps the files of one system ordered by every comparison of FileSorts::SortTypes.
+// Orderings are built once from precomputed sort keys, then maintained by re-inserting
+// files whose metadata changed, so lists never have to be sorted again.
+// Changes are batched: they are merged into the orderings in a single pass the next time
+// an ordering is used, so that a scrape updating many files does not shift them every time.
+// Descending sort types share the ascending ordering and just walk it backward.
+class FileSortIndex
+{
+public:
+	FileSortIndex();
+
+	// Build every ordering from scratch
+	void build(const std::vector<FileData*>& files);
+	void clear();
+
+	bool contains(FileData* file) const;
+	inline size_t size() const { return mEntries.size(); }
+
+	void add(FileData* file);
+	void remove(FileData* file);
+	// Re-position a file after its metadata changed (adds it if not yet indexed)
+	void update(FileData* file);
+	// Apply the pending changes to the orderings, done by order() and isBefore() anyway
+	void flush();
+
+	// Return the given files in the order of the given sort type, without sorting them
+	std::vector<FileData*> order(const std::vector<FileData*>& files, const FileData::SortType& sortType);
+	// Whether a comes before b in the order of the given sort type
+	bool isBefore(FileData* a, FileData* b, const FileData::SortType& sortType);
+
+private:
+	enum Ordering
+	{
+		ORDER_NAME,
+		ORDER_RATING,
+		ORDER_TIMES_PLAYED,
+		ORDER_LAST_PLAYED,
+		ORDER_NUMBER_PLAYERS,
+		ORDER_DEVELOPER,
+		ORDER_GENRE,
+		ORDER_COUNT
+	};
+
+	// Snapshot of the metadata a file is sorted on, taken when the file is (re)indexed.
+	// Keeping it lets us find the old position of a file after its metadata has changed.
+	struct Entry
+	{
+		FileData* file;
+		std::string name;
+		std::string developer;
+		std::string genre;
+		float rating;
+		int timesPlayed;
+		int players;
+		boost::posix_time::ptime lastPlayed;
+	};
+
+	typedef std::vector<const Entry*>::iterator EntryIterator;
+
+	static Ordering getOrdering(FileData::ComparisonFunction* comparisonFunction);
+	static bool less(Ordering ordering, const Entry* a, const Entry* b);
+	static void fillEntry(Entry& entry, FileData* file);
+
+	// Byte-wise MSD radix sort of [begin, end) on the given key, starting at the given character
+	static void radixSort(EntryIterator begin, EntryIterator end, std::string Entry::* key, size_t depth, std::vector<const Entry*>& buffer);
+	// Sort an ordering from scratch, using radix sort for orderings on a collation key
+	static void sort(Ordering ordering, std::vector<const Entry*>& ordered);
+
+	// Entries are allocated separately so that their address is stable and outlives their removal until flush()
+	std::unordered_map<FileData*, std::unique_ptr<Entry> > mEntries;
+	std::vector<const Entry*> mOrderings[ORDER_COUNT];
+	// Entries to (re)insert, with keys not filled yet, and entries removed since the last flush
+	std::unordered_set<Entry*> mPending;
+	std::vector<std::unique_ptr<Entry> > mRemoved;
+};
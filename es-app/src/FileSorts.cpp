@@ -1,5 +1,6 @@
 #include "FileSorts.h"
 #include "Locale.h"
+#include <cstring>
 
 namespace FileSorts
 {
@@ -22,23 +23,100 @@ namespace FileSorts
 	SortTypes.push_back(FileData::SortType(&compareGenre, false, "\uF15e " + _("GENRE")));
   }
 
-	//returns if file1 should come before file2
-	bool compareFileName(const FileData* file1, const FileData* file2)
+	// Base letters of U+00C0 to U+00FF, nullptr when the character is not a letter
+	static const char* latin1Folding[64] =
+	{
+		"A", "A", "A", "A", "A", "A", "AE", "C",
+		"E", "E", "E", "E", "I", "I", "I", "I",
+		"D", "N", "O", "O", "O", "O", "O", nullptr,
+		"O", "U", "U", "U", "U", "Y", "TH", "SS",
+		"A", "A", "A", "A", "A", "A", "AE", "C",
+		"E", "E", "E", "E", "I", "I", "I", "I",
+		"D", "N", "O", "O", "O", "O", "O", nullptr,
+		"O", "U", "U", "U", "U", "Y", "TH", "Y"
+	};
+
+	// Base letters of U+0100 to U+017F (Latin Extended-A)
+	static const char latinExtendedAFolding[129] =
+		"AAAAAACCCCCCCCDDDDEEEEEEEEEEGGGG"
+		"GGGGHHHHIIIIIIIIIIIIJJKKKLLLLLLL"
+		"LLLNNNNNNNNNOOOOOOOORRRRRRSSSSSS"
+		"SSTTTTTTUUUUUUUUUUUUWWYYYZZZZZZS";
+
+	static const char* articles[] = { "THE ", "AN ", "A " };
+
+	std::string makeCollationKey(const std::string& str, bool skipArticle)
 	{
-		std::string name1 = file1->getName();
-		std::string name2 = file2->getName();
+		std::string key;
+		key.reserve(str.length());
+
+		for(unsigned int i = 0; i < str.length(); i++)
+		{
+			unsigned char c = (unsigned char)str[i];
+			if(c < 0x80)
+			{
+				key += (char)toupper(c);
+				continue;
+			}
+
+			// two bytes UTF-8 sequence: fold latin accented letters
+			if((c & 0xE0) == 0xC0 && i + 1 < str.length() && ((unsigned char)str[i + 1] & 0xC0) == 0x80)
+			{
+				unsigned int codepoint = ((c & 0x1F) << 6) | ((unsigned char)str[i + 1] & 0x3F);
+				if(codepoint >= 0xC0 && codepoint < 0x100 && latin1Folding[codepoint - 0xC0] != nullptr)
+				{
+					key += latin1Folding[codepoint - 0xC0];
+					i++;
+					continue;
+				}
+				if(codepoint >= 0x100 && codepoint < 0x180)
+				{
+					key += latinExtendedAFolding[codepoint - 0x100];
+					i++;
+					continue;
+				}
+			}
+
+			// anything else is kept as is, and so sorted after ASCII
+			key += (char)c;
+		}
+
+		if(skipArticle)
+		{
+			for(auto article : articles)
+			{
+				size_t length = strlen(article);
+				if(key.length() > length && key.compare(0, length, article) == 0)
+				{
+					key.erase(0, length);
+					break;
+				}
+			}
+		}
+
+		return key;
+	}
 
-		//min of name1/name2 .length()s
-		unsigned int count = name1.length() > name2.length() ? name2.length() : name1.length();
+	// case insensitive comparison, without copying strings
+	static bool lessNoCase(const std::string& str1, const std::string& str2)
+	{
+		//min of str1/str2 .length()s
+		unsigned int count = str1.length() > str2.length() ? str2.length() : str1.length();
 		for(unsigned int i = 0; i < count; i++)
 		{
-			if(toupper(name1[i]) != toupper(name2[i]))
+			if(toupper(str1[i]) != toupper(str2[i]))
 			{
-				return toupper(name1[i]) < toupper(name2[i]);
+				return toupper(str1[i]) < toupper(str2[i]);
 			}
 		}
 
-		return name1.length() < name2.length();
+		return str1.length() < str2.length();
+	}
+
+	//returns if file1 should come before file2
+	bool compareFileName(const FileData* file1, const FileData* file2)
+	{
+		return file1->getSortKey() < file2->getSortKey();
 	}
 
 	bool compareRating(const FileData* file1, const FileData* file2)
@@ -90,18 +168,7 @@ namespace FileSorts
 		//only games have developper metadata
 		if(file1->metadata.getType() == GAME_METADATA && file2->metadata.getType() == GAME_METADATA)
 		{
-			std::string dev1 = file1->metadata.get("developer");
-			std::string dev2 = file2->metadata.get("developer");
-
-		//min of dev1/dev2 .length()s
-		unsigned int count = dev1.length() > dev2.length() ? dev2.length() : dev1.length();
-		for(unsigned int i = 0; i < count; i++)
-		{
-			if(toupper(dev1[i]) != toupper(dev2[i]))
-			{
-				return toupper(dev1[i]) < toupper(dev2[i]);
-			}
-		}
+			return lessNoCase(file1->metadata.get("developer"), file2->metadata.get("developer"));
 		}
 
 		return false;
@@ -112,18 +179,7 @@ namespace FileSorts
 		//only games have genre metadata
 		if(file1->metadata.getType() == GAME_METADATA && file2->metadata.getType() == GAME_METADATA)
 		{
-			std::string genre1 = file1->metadata.get("genre");
-			std::string genre2 = file2->metadata.get("genre");
-
-		//min of genre1/genre2 .length()s
-		unsigned int count = genre1.length() > genre2.length() ? genre2.length() : genre1.length();
-		for(unsigned int i = 0; i < count; i++)
-		{
-			if(toupper(genre1[i]) != toupper(genre2[i]))
-			{
-				return toupper(genre1[i]) < toupper(genre2[i]);
-			}
-		}
+			return lessNoCase(file1->metadata.get("genre"), file2->metadata.get("genre"));
 		}
 
 		return false;
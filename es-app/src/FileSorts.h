@@ -15,4 +15,14 @@ namespace FileSorts
 
 	extern std::vector<FileData::SortType> SortTypes;
 	void init();
+
+	/*!
+	 * Build a key that sorts strings the way a user expects with a plain byte comparison:
+	 * ASCII is uppercased, latin accented letters are replaced by their base letter
+	 * and an optional leading article ("The", "A", "An") is skipped.
+	 * @param str UTF-8 string
+	 * @param skipArticle Skip the leading article if any
+	 * @return Collation key
+	 */
+	std::string makeCollationKey(const std::string& str, bool skipArticle);
 };
@@ -0,0 +1,319 @@
+#include "GameSearchIndex.h"
+#include "SystemData.h"
+#include "FileSorts.h"
+#include "Log.h"
+#include <algorithm>
+#include <iterator>
+
+GameSearchIndex* GameSearchIndex::sInstance = NULL;
+
+GameSearchIndex* GameSearchIndex::getInstance()
+{
+	if (sInstance == NULL)
+		sInstance = new GameSearchIndex();
+
+	return sInstance;
+}
+
+GameSearchIndex::GameSearchIndex() : mThread(nullptr), mReady(false), mBuilding(false), mCancel(false)
+{
+}
+
+static inline bool isWordSeparator(char c)
+{
+	return c == ' ' || c == '\n';
+}
+
+static inline void post(std::vector<unsigned int>& list, unsigned int id)
+{
+	// documents are added in id order, so lists stay sorted
+	if (list.empty() || list.back() != id)
+		list.push_back(id);
+}
+
+void GameSearchIndex::Content::clear()
+{
+	documents.clear();
+	ids.clear();
+	trigrams.clear();
+	prefixes.clear();
+	deadCount = 0;
+}
+
+void GameSearchIndex::Content::add(FileData* game, const std::string& text)
+{
+	const unsigned int id = (unsigned int) documents.size();
+	Document document = { game, text, true };
+	documents.push_back(document);
+	ids[game] = id;
+
+	for (size_t i = 0; i + 2 < text.size(); i++)
+	{
+		if (text[i] == '\n' || text[i + 1] == '\n' || text[i + 2] == '\n')
+			continue;
+		post(trigrams[(unsigned char)text[i] << 16 | (unsigned char)text[i + 1] << 8 | (unsigned char)text[i + 2]], id);
+	}
+
+	// one and two character prefixes of every word, for queries too short for trigrams
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		if (isWordSeparator(text[i]) || (i > 0 && !isWordSeparator(text[i - 1])))
+			continue;
+		post(prefixes[(unsigned char)text[i]], id);
+		if (i + 1 < text.size() && !isWordSeparator(text[i + 1]))
+			post(prefixes[(unsigned char)text[i] << 8 | (unsigned char)text[i + 1]], id);
+	}
+}
+
+void GameSearchIndex::Content::kill(FileData* game)
+{
+	auto it = ids.find(game);
+	if (it == ids.end())
+		return;
+
+	// posting lists are left as is, dead documents are skipped when checking candidates
+	documents[it->second].alive = false;
+	ids.erase(it);
+	deadCount++;
+}
+
+std::string GameSearchIndex::makeText(FileData* game)
+{
+	std::string text = FileSorts::makeCollationKey(game->getName(), false);
+	std::string cleanName = FileSorts::makeCollationKey(game->getCleanName(), false);
+	if (cleanName != text)
+		text += '\n' + cleanName;
+	text += '\n' + FileSorts::makeCollationKey(game->metadata.get("developer"), false);
+	text += '\n' + FileSorts::makeCollationKey(game->metadata.get("genre"), false);
+	return text;
+}
+
+bool GameSearchIndex::matches(const std::string& text, const std::string& word)
+{
+	if (word.size() >= 3)
+		return text.find(word) != std::string::npos;
+
+	// short words only match the beginning of a word
+	for (size_t pos = text.find(word); pos != std::string::npos; pos = text.find(word, pos + 1))
+		if (pos == 0 || isWordSeparator(text[pos - 1]))
+			return true;
+	return false;
+}
+
+void GameSearchIndex::build()
+{
+	clear();
+
+	mBuilding = true;
+	mThread = new std::thread(&GameSearchIndex::threadBuild, this);
+}
+
+void GameSearchIndex::clear()
+{
+	mCancel = true;
+	if (mThread != nullptr)
+	{
+		mThread->join();
+		delete mThread;
+		mThread = nullptr;
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mContent.clear();
+	mPendingUpdates.clear();
+	mPendingRemovals.clear();
+	mReady = false;
+	mBuilding = false;
+	mCancel = false;
+}
+
+void GameSearchIndex::threadBuild()
+{
+	// Systems are not added nor removed until clear() has joined this thread
+	Content content;
+	for (auto system : SystemData::sSystemVector)
+	{
+		if (mCancel)
+			break;
+		if (system->isFavorite())
+			continue;
+
+		// keys are computed under the game data lock, indexing itself does not need it
+		std::vector< std::pair<FileData*, std::string> > texts;
+		{
+			std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+			std::vector<FileData*> games = system->getRootFolder()->getFilesRecursive(GAME);
+			texts.reserve(games.size());
+			for (auto game : games)
+				texts.push_back(std::make_pair(game, makeText(game)));
+		}
+
+		for (auto& text : texts)
+			content.add(text.first, text.second);
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!mCancel)
+	{
+		std::swap(mContent, content);
+		mReady = true;
+		LOG(LogInfo) << "Search index built: " << mContent.documents.size() << " games, " << mContent.trigrams.size() << " trigrams";
+	}
+	mBuilding = false;
+}
+
+void GameSearchIndex::applyPending()
+{
+	if (mBuilding || (mPendingUpdates.empty() && mPendingRemovals.empty()))
+		return;
+
+	for (auto game : mPendingRemovals)
+		mContent.kill(game);
+	for (auto game : mPendingUpdates)
+	{
+		mContent.kill(game);
+		mContent.add(game, makeText(game));
+	}
+	mPendingRemovals.clear();
+	mPendingUpdates.clear();
+}
+
+void GameSearchIndex::compact()
+{
+	Content content;
+	for (auto& document : mContent.documents)
+		if (document.alive)
+			content.add(document.game, document.text);
+	std::swap(mContent, content);
+}
+
+void GameSearchIndex::update(FileData* game)
+{
+	if (game->getType() != GAME)
+		return;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (mBuilding)
+	{
+		mPendingUpdates.insert(game);
+		return;
+	}
+	if (!mReady)
+		return;
+	applyPending();
+
+	// most changes (play count, favorite, ...) don't touch the indexed fields
+	std::string text = makeText(game);
+	auto it = mContent.ids.find(game);
+	if (it != mContent.ids.end() && mContent.documents[it->second].text == text)
+		return;
+
+	mContent.kill(game);
+	mContent.add(game, text);
+	if (mContent.deadCount > mContent.documents.size() / 2)
+		compact();
+}
+
+void GameSearchIndex::remove(FileData* game)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (mBuilding)
+	{
+		mPendingUpdates.erase(game);
+		mPendingRemovals.insert(game);
+		return;
+	}
+	mContent.kill(game);
+}
+
+std::vector<FileData*> GameSearchIndex::search(const std::string& query, size_t maxResults, bool showHidden)
+{
+	std::vector<FileData*> results;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!mReady)
+		return results;
+	applyPending();
+
+	std::vector<std::string> words;
+	std::string folded = FileSorts::makeCollationKey(query, false);
+	for (size_t start = 0; start < folded.size(); )
+	{
+		size_t end = folded.find(' ', start);
+		if (end == std::string::npos)
+			end = folded.size();
+		if (end > start)
+			words.push_back(folded.substr(start, end - start));
+		start = end + 1;
+	}
+	if (words.empty())
+		return results;
+
+	// every word must be found: intersect all the posting lists, smallest first
+	std::vector<const std::vector<unsigned int>*> lists;
+	for (auto& word : words)
+	{
+		if (word.size() >= 3)
+		{
+			for (size_t i = 0; i + 2 < word.size(); i++)
+			{
+				auto it = mContent.trigrams.find((unsigned char)word[i] << 16 | (unsigned char)word[i + 1] << 8 | (unsigned char)word[i + 2]);
+				if (it == mContent.trigrams.end())
+					return results;
+				lists.push_back(&it->second);
+			}
+		}
+		else
+		{
+			auto it = mContent.prefixes.find(word.size() == 1 ? (unsigned char)word[0] : (unsigned char)word[0] << 8 | (unsigned char)word[1]);
+			if (it == mContent.prefixes.end())
+				return results;
+			lists.push_back(&it->second);
+		}
+	}
+	std::sort(lists.begin(), lists.end(), [](const std::vector<unsigned int>* a, const std::vector<unsigned int>* b) { return a->size() < b->size(); });
+
+	std::vector<unsigned int> candidates(*lists[0]);
+	std::vector<unsigned int> intersection;
+	for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+	{
+		intersection.clear();
+		std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(intersection));
+		candidates.swap(intersection);
+	}
+
+	// trigrams may match across words or in another order: check the candidates for real
+	std::lock_guard<std::recursive_mutex> gameDataLock(getGameDataMutex());
+	for (auto id : candidates)
+	{
+		const Document& document = mContent.documents[id];
+		if (!document.alive)
+			continue;
+		// hidden is not indexed, it changes more often than the indexed fields
+		if (!showHidden && document.game->metadata.get("hidden") == "true")
+			continue;
+
+		bool found = true;
+		for (auto& word : words)
+		{
+			if (!matches(document.text, word))
+			{
+				found = false;
+				break;
+			}
+		}
+		if (found)
+			results.push_back(document.game);
+	}
+
+	// the first results by name, not the first indexed ones
+	auto byName = [](FileData* a, FileData* b) { return a->getSortKey() < b->getSortKey(); };
+	if (results.size() > maxResults)
+	{
+		std::partial_sort(results.begin(), results.begin() + maxResults, results.end(), byName);
+		results.resize(maxResults);
+	}
+	else
+		std::sort(results.begin(), results.end(), byName);
+	return results;
+}
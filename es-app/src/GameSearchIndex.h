@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "FileData.h"
+
+// Type-ahead search over the games of every system.
+// Names, clean names, developers and genres are folded into collation keys, then indexed by
+// trigram (for words of 3 characters or more) and by word prefix (for shorter ones),
+// so a query only intersects a few sorted posting lists and checks the candidates left.
+// The index is built on a background thread after the systems are loaded, then kept up
+// to date by SystemData::updateIndexes / removeFromIndexes.
+class GameSearchIndex
+{
+public:
+	static GameSearchIndex* getInstance();
+
+	// Index every game of SystemData::sSystemVector in the background
+	void build();
+	// Stop a pending build and forget every game. Must be called before systems are deleted.
+	void clear();
+
+	inline bool isReady() const { return mReady; }
+
+	// Re-index a game after its metadata changed
+	void update(FileData* game);
+	// Forget a game about to be deleted
+	void remove(FileData* game);
+
+	// Games matching every word of the query, the first maxResults ones by name.
+	// Hidden games are left out before counting unless showHidden.
+	std::vector<FileData*> search(const std::string& query, size_t maxResults, bool showHidden);
+
+private:
+	GameSearchIndex();
+	static GameSearchIndex* sInstance;
+
+	struct Document
+	{
+		FileData* game;
+		// collation keys of the indexed fields, separated by '\n'
+		std::string text;
+		bool alive;
+	};
+
+	typedef std::unordered_map<unsigned int, std::vector<unsigned int> > PostingMap;
+
+	// Everything the index is made of, so that a build can fill its own copy and swap it in
+	struct Content
+	{
+		std::vector<Document> documents;
+		std::unordered_map<FileData*, unsigned int> ids;
+		PostingMap trigrams;
+		PostingMap prefixes;
+		size_t deadCount;
+
+		Content() : deadCount(0) {}
+		void clear();
+		void add(FileData* game, const std::string& text);
+		void kill(FileData* game);
+	};
+
+	static std::string makeText(FileData* game);
+	static bool matches(const std::string& text, const std::string& word);
+
+	void threadBuild();
+	// Apply changes recorded while a build was running
+	void applyPending();
+	void compact();
+
+	Content mContent;
+
+	// changes made while a build is running, replayed once it is swapped in
+	std::unordered_set<FileData*> mPendingUpdates;
+	std::unordered_set<FileData*> mPendingRemovals;
+
+	std::thread* mThread;
+	std::mutex mMutex;
+	std::atomic<bool> mReady;
+	std::atomic<bool> mBuilding;
+	std::atomic<bool> mCancel;
+};
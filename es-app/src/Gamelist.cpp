@@ -134,9 +134,11 @@ void parseGamelist(SystemData* system)
 				continue;
 			}
 
-			//load the metadata
+			//load the metadata, the tree may be displayed already when a gamelist is reloaded
+			MetaDataList metadata = MetaDataList::createFromXML(GAME_METADATA, fileNode, relativeTo);
+			std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
 			std::string defaultName = file->metadata.get("name");
-			file->metadata = MetaDataList::createFromXML(GAME_METADATA, fileNode, relativeTo);
+			file->metadata = metadata;
 
 			//make sure name gets set if one didn't exist
 			if(file->metadata.get("name").empty())
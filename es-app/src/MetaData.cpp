@@ -1,8 +1,10 @@
 #include "MetaData.h"
+#include "FileSorts.h"
 #include "components/TextComponent.h"
 #include "Log.h"
 #include "Util.h"
 #include <strings.h>
+#include <atomic>
 #include "Locale.h"
 
 namespace fs = boost::filesystem;
@@ -10,6 +12,24 @@ namespace fs = boost::filesystem;
 std::vector<MetaDataDecl> gameMDD;
 std::vector<MetaDataDecl> folderMDD;
 
+std::recursive_mutex& getGameDataMutex()
+{
+	static std::recursive_mutex mutex;
+	return mutex;
+}
+
+static std::atomic<unsigned long> sGameDataRemovals(0);
+
+unsigned long getGameDataRemovals()
+{
+	return sGameDataRemovals;
+}
+
+void addGameDataRemoval()
+{
+	sGameDataRemovals++;
+}
+
 void initMetadata() {
   gameMDD.push_back(MetaDataDecl("name",		MD_STRING,				"", 				false,	true,		_("Name"),			_("enter game name")));
   gameMDD.push_back(MetaDataDecl("hash",		MD_STRING,				"", 				true,	false,		_("hash"),			_("enter game hash")));
@@ -62,7 +82,7 @@ MetaDataList::MetaDataList(MetaDataListType type)
 {
 	const std::vector<MetaDataDecl>& mdd = getMDD();
 	for(auto iter = mdd.begin(); iter != mdd.end(); iter++)
-		set(iter->key, iter->defaultValue);
+		setValue(iter->key, iter->defaultValue);
 }
 
 
@@ -82,9 +102,9 @@ MetaDataList MetaDataList::createFromXML(MetaDataListType type, pugi::xml_node n
 			if(iter->type == MD_IMAGE_PATH)
 				value = resolvePath(value, relativeTo, true).generic_string();
 
-			mdl.set(iter->key, value);
+			mdl.setValue(iter->key, value);
 		}else{
-			mdl.set(iter->key, iter->defaultValue);
+			mdl.setValue(iter->key, iter->defaultValue);
 		}
 	}
 
@@ -116,9 +136,17 @@ void MetaDataList::appendToXML(pugi::xml_node parent, bool ignoreDefaults, const
 }
 
 void MetaDataList::set(const std::string& key, const std::string& value)
+{
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+	setValue(key, value);
+}
+
+void MetaDataList::setValue(const std::string& key, const std::string& value)
 {
 	mMap[key] = value;
 	mWasChanged = true;
+	if(key == "name")
+		mSortKey = FileSorts::makeCollationKey(value, true);
 }
 
 void MetaDataList::setTime(const std::string& key, const boost::posix_time::ptime& time)
@@ -148,6 +176,7 @@ boost::posix_time::ptime MetaDataList::getTime(const std::string& key) const
 
 void MetaDataList::merge(const MetaDataList& other) {
 	const std::vector<MetaDataDecl> &mdd = getMDD();
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
 
 	for (auto otherIter = other.mMap.begin(); otherIter != other.mMap.end(); otherIter++) {
 		bool mustMerge = true;
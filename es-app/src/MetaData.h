@@ -3,6 +3,8 @@
 #include "pugixml/pugixml.hpp"
 #include <string>
 #include <map>
+#include <mutex>
+#include <thread>
 #include "GuiComponent.h"
 #include <boost/date_time.hpp>
 #include <boost/filesystem.hpp>
@@ -62,6 +64,43 @@ enum MetaDataListType
 const std::vector<MetaDataDecl>& getMDDByType(MetaDataListType type);
 void initMetadata();
 
+// Guards the game trees and their metadata, which gamelists and the search index read from worker threads.
+// Recursive since deleting a folder removes its children.
+std::recursive_mutex& getGameDataMutex();
+// Count of files taken out of a game tree, changed under the game data lock.
+// Files read under an earlier hold of the lock may have been deleted since it changed.
+unsigned long getGameDataRemovals();
+void addGameDataRemoval();
+
+// Holds the game data lock over a long walk a batch of files at a time, so that the main thread
+// is not kept waiting for the whole walk.
+class GameDataBatchLock
+{
+public:
+	GameDataBatchLock() : mLock(getGameDataMutex()), mCount(0), mRemovals(getGameDataRemovals()) {}
+
+	// Count a file read, the lock is let go between batches.
+	// False once a file was removed meanwhile: the files read before must not be used anymore.
+	bool next()
+	{
+		if(++mCount < BATCH_SIZE)
+			return true;
+
+		mCount = 0;
+		mLock.unlock();
+		std::this_thread::yield();
+		mLock.lock();
+		return mRemovals == getGameDataRemovals();
+	}
+
+private:
+	static const int BATCH_SIZE = 256;
+
+	std::unique_lock<std::recursive_mutex> mLock;
+	int mCount;
+	unsigned long mRemovals;
+};
+
 class MetaDataList
 {
 public:
@@ -84,11 +123,21 @@ public:
 	bool wasChanged() const;
 	void resetChangedFlag();
 
+	// Collation key of the name, computed when the name is set so that readers on other threads never write it
+	inline const std::string& getSortKey() const { return mSortKey; }
+
 	inline MetaDataListType getType() const { return mType; }
 	inline const std::vector<MetaDataDecl>& getMDD() const { return getMDDByType(getType()); }
 
 private:
+	// FileData fills its list in its constructor, before the node is in a tree
+	friend class FileData;
+
+	// Lists being built are not shared yet, they need no lock
+	void setValue(const std::string& key, const std::string& value);
+
 	MetaDataListType mType;
 	std::map<std::string, std::string> mMap;
 	bool mWasChanged;
+	std::string mSortKey;
 };
@@ -1,32 +1,500 @@
 #include "ScraperCmdLine.h"
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <vector>
+#include <set>
+#include <map>
+#include <list>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <stdio.h>
 #include "SystemData.h"
+#include "FileData.h"
+#include "Gamelist.h"
 #include "Settings.h"
+#include "platform.h"
+#include "scrapers/ScraperScheduler.h"
+#include <boost/filesystem.hpp>
 #include <signal.h>
+#include <string.h>
 #include "Log.h"
 
+namespace fs = boost::filesystem;
+
 std::ostream& out = std::cout;
 
+static volatile sig_atomic_t sInterrupted = 0;
+
 void handle_interrupt_signal(int p)
 {
-	sleep(50);
+	// the scrape stops at the next update, a second interrupt kills us
+	sInterrupted = 1;
+	signal(SIGINT, SIG_DFL);
+}
+
+enum AcceptPolicy
+{
+	ACCEPT_FIRST,	// the first result
+	ACCEPT_SINGLE,	// a result only if it is the only one
+	ACCEPT_EXACT,	// the first result named like the file
+	ACCEPT_MANUAL	// asked on the console
+};
+
+struct ScrapeOptions
+{
+	ScrapeOptions() : headless(false), allGames(false), accept(ACCEPT_FIRST), jobs(2),
+		checkpoint(getHomePath() + "/.emulationstation/scraper_checkpoint"), restart(false) {}
+
+	bool headless;
+	std::vector<std::string> systems;	// all of them if empty
+	bool allGames;						// or only the games missing an image
+	AcceptPolicy accept;
+	int jobs;							// systems scraped at once
+	std::string checkpoint;
+	bool restart;						// the checkpoint is ignored
+};
+
+// Fields of the machine readable output and of the checkpoint are separated by tabs, one record per line
+static std::string escape(const std::string& value)
+{
+	std::string escaped;
+	escaped.reserve(value.size());
+	for(auto it = value.begin(); it != value.end(); it++)
+	{
+		switch(*it)
+		{
+		case '\\': escaped += "\\\\"; break;
+		case '\t': escaped += "\\t"; break;
+		case '\n': escaped += "\\n"; break;
+		case '\r': escaped += "\\r"; break;
+		default: escaped += *it; break;
+		}
+	}
+	return escaped;
+}
+
+static std::string unescape(const std::string& value)
+{
+	std::string unescaped;
+	unescaped.reserve(value.size());
+	for(size_t i = 0; i < value.size(); i++)
+	{
+		if(value[i] != '\\' || i + 1 == value.size())
+		{
+			unescaped += value[i];
+			continue;
+		}
 
-	LOG(LogInfo) << "Interrupt received during scrape...";
+		switch(value[++i])
+		{
+		case 't': unescaped += '\t'; break;
+		case 'n': unescaped += '\n'; break;
+		case 'r': unescaped += '\r'; break;
+		default: unescaped += value[i]; break;
+		}
+	}
+	return unescaped;
+}
 
-	SystemData::deleteSystems();
+static std::vector<std::string> split(const std::string& line, char separator)
+{
+	std::vector<std::string> fields;
+	std::stringstream stream(line);
+	std::string field;
+	while(std::getline(stream, field, separator))
+		fields.push_back(field);
+	return fields;
+}
 
-	exit(1);
+// One record of the progress output
+static void report(const std::vector<std::string>& fields)
+{
+	for(size_t i = 0; i < fields.size(); i++)
+		out << (i ? "\t" : "") << escape(fields[i]);
+	out << std::endl;
 }
 
-int run_scraper_cmdline()
+//
+// What an interrupted scrape already did, so that running it again goes on where it stopped.
+// Each game done is appended as it is done, with the metadata scraped: they are restored on resume,
+// as gamelists are only written once a system is complete.
+//   G <path> <key> <value>...	game scraped
+//   X <path>					game skipped
+//   S <system>					system complete, its gamelist written
+//
+class ScraperCheckpoint
 {
+public:
+	ScraperCheckpoint(const std::string& path) : mPath(path) {}
+
+	void load()
+	{
+		std::ifstream stream(mPath);
+		std::string line;
+		// a last line without its newline was cut by the interrupt
+		while(std::getline(stream, line) && !stream.eof())
+		{
+			std::vector<std::string> fields = split(line, '\t');
+			if(fields.size() < 2)
+				continue;
+
+			const std::string name = unescape(fields[1]);
+			if(fields[0] == "S")
+			{
+				mSystems.insert(name);
+			}else if(fields[0] == "G" || fields[0] == "X")
+			{
+				std::vector<std::string>& values = mGames[name];
+				values.clear();
+				for(size_t i = 2; i + 1 < fields.size(); i += 2)
+				{
+					values.push_back(unescape(fields[i]));
+					values.push_back(unescape(fields[i + 1]));
+				}
+			}
+		}
+	}
+
+	void clear()
+	{
+		boost::system::error_code ec;
+		fs::remove(mPath, ec);
+		mSystems.clear();
+		mGames.clear();
+	}
+
+	inline bool isSystemDone(SystemData* system) const { return mSystems.find(system->getName()) != mSystems.end(); }
+
+	// true if the game was done, its scraped metadata restored
+	bool restore(FileData* game) const
+	{
+		auto it = mGames.find(game->getPath().generic_string());
+		if(it == mGames.end())
+			return false;
+
+		if(!it->second.empty())
+		{
+			MetaDataList mdl(game->metadata.getType());
+			for(size_t i = 0; i + 1 < it->second.size(); i += 2)
+				mdl.set(it->second[i], it->second[i + 1]);
+			game->metadata.merge(mdl);
+			SystemData::updateIndexes(game);
+		}
+		return true;
+	}
+
+	void addGame(FileData* game, const MetaDataList& mdl)
+	{
+		std::string line = "G\t" + escape(game->getPath().generic_string());
+		const std::vector<MetaDataDecl>& mdd = mdl.getMDD();
+		for(auto it = mdd.begin(); it != mdd.end(); it++)
+		{
+			// what MetaDataList::merge takes
+			const std::string& value = mdl.get(it->key);
+			if(it->isStatistic || value == it->defaultValue)
+				continue;
+			line += "\t" + escape(it->key) + "\t" + escape(value);
+		}
+		append(line);
+	}
+
+	void addSkipped(FileData* game) { append("X\t" + escape(game->getPath().generic_string())); }
+	void addSystem(SystemData* system) { append("S\t" + escape(system->getName())); }
+
+private:
+	void append(const std::string& line)
+	{
+		if(!mStream.is_open())
+			mStream.open(mPath, std::ios::app);
+		mStream << line << std::endl;
+	}
+
+	std::string mPath;
+	std::ofstream mStream;
+	std::set<std::string> mSystems;
+	// scraped metadata by path, key then value
+	std::map<std::string, std::vector<std::string> > mGames;
+};
+
+// lower case letters and digits only
+static std::string simplifyName(const std::string& name)
+{
+	std::string simple;
+	for(auto it = name.begin(); it != name.end(); it++)
+	{
+		if(isalnum((unsigned char)*it))
+			simple += (char)tolower((unsigned char)*it);
+	}
+	return simple;
+}
+
+static int chooseResult(AcceptPolicy policy, const ScraperSearchParams& search, const std::vector<ScraperSearchResult>& results)
+{
+	switch(policy)
+	{
+	case ACCEPT_FIRST:
+		return 0;
+
+	case ACCEPT_SINGLE:
+		return results.size() == 1 ? 0 : -1;
+
+	case ACCEPT_EXACT:
+	{
+		const std::string name = simplifyName(removeParenthesis(search.game->getCleanName()));
+		for(unsigned int i = 0; i < results.size(); i++)
+		{
+			if(simplifyName(removeParenthesis(results.at(i).mdl.get("name"))) == name)
+				return i;
+		}
+		return -1;
+	}
+
+	case ACCEPT_MANUAL:
+		out << search.game->getPath().filename().string() << "\n";
+		for(unsigned int i = 0; i < results.size(); i++)
+			out << "   " << i << " - " << results.at(i).mdl.get("name") << "\n";
+
+		do {
+			out << "Your choice (nothing to skip): ";
+
+			std::string choice_str;
+			if(!std::getline(std::cin, choice_str) || choice_str.empty())
+				return -1;
+
+			int choice = -1;
+			std::stringstream choice_buff(choice_str); //convert to int
+			choice_buff >> choice;
+			if(choice >= 0 && choice < (int)results.size())
+				return choice;
+
+			out << "Invalid choice.\n";
+		} while(true);
+	}
+
+	return -1;
+}
+
+// A system being scraped
+struct SystemScrape
+{
+	SystemData* system;
+	std::unique_ptr<ScraperScheduler> scheduler;
+	int total;
+	int done;
+	bool changed;
+};
+
+static int scrape(const std::vector<SystemData*>& systems, const ScrapeOptions& options)
+{
+	ScraperCheckpoint checkpoint(options.checkpoint);
+	if(options.restart)
+		checkpoint.clear();
+	else
+		checkpoint.load();
+
+	// the systems scraped at once share what the scraper allows: no more systems
+	// than games or burst requests allowed at once, so each one gets at least one
+	ScraperLimits limits = getScraperLimits();
+	const int jobs = std::max(1, std::min(options.jobs, std::min(limits.maxGames, limits.burst)));
+	limits.maxGames = limits.maxGames / jobs;
+	limits.requestsPerSecond = limits.requestsPerSecond / jobs;
+	limits.burst = limits.burst / jobs;
+
+	std::list<SystemData*> pending;
+	for(auto it = systems.begin(); it != systems.end(); it++)
+	{
+		if(checkpoint.isSystemDone(*it))
+			report({ "system", (*it)->getName(), "done" });
+		else
+			pending.push_back(*it);
+	}
+
+	int scraped = 0;
+	int skipped = 0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::list< std::unique_ptr<SystemScrape> > running;
+
+	while(!sInterrupted && (!pending.empty() || !running.empty()))
+	{
+		while((int)running.size() < jobs && !pending.empty())
+		{
+			std::unique_ptr<SystemScrape> job(new SystemScrape());
+			job->system = pending.front();
+			job->done = 0;
+			job->changed = false;
+			pending.pop_front();
+
+			std::queue<ScraperSearchParams> searches;
+			std::vector<FileData*> games = job->system->getRootFolder()->getFilesRecursive(GAME);
+			for(auto it = games.begin(); it != games.end(); it++)
+			{
+				if(checkpoint.restore(*it))
+				{
+					job->changed = true;
+					continue;
+				}
+				if(!options.allGames && !(*it)->metadata.get("image").empty())
+					continue;
+
+				ScraperSearchParams search;
+				search.system = job->system;
+				search.game = *it;
+				searches.push(search);
+			}
+			job->total = (int)searches.size();
+			report({ "system", job->system->getName(), "start", std::to_string(job->total) });
+
+			SystemScrape* current = job.get();
+			job->scheduler.reset(new ScraperScheduler(searches, limits));
+			job->scheduler->setChooseCallback([&options](const ScraperSearchParams& search, const std::vector<ScraperSearchResult>& results)
+			{
+				return chooseResult(options.accept, search, results);
+			});
+			job->scheduler->setResultCallback([&, current](const ScraperSearchParams& search, const ScraperSearchResult& result)
+			{
+				search.game->metadata.merge(result.mdl);
+				SystemData::updateIndexes(search.game);
+				checkpoint.addGame(search.game, result.mdl);
+				current->changed = true;
+				current->done++;
+				scraped++;
+				report({ "game", current->system->getName(), search.game->getPath().generic_string(), "scraped", result.mdl.get("name") });
+				report({ "progress", current->system->getName(), std::to_string(current->done), std::to_string(current->total) });
+			});
+			job->scheduler->setSkipCallback([&, current](const ScraperSearchParams& search, const std::string& reason)
+			{
+				checkpoint.addSkipped(search.game);
+				current->done++;
+				skipped++;
+				report({ "game", current->system->getName(), search.game->getPath().generic_string(), "skipped", reason });
+				report({ "progress", current->system->getName(), std::to_string(current->done), std::to_string(current->total) });
+			});
+			running.push_back(std::move(job));
+		}
+
+		for(auto it = running.begin(); it != running.end(); )
+		{
+			SystemScrape& job = **it;
+			job.scheduler->update();
+			if(!job.scheduler->isDone())
+			{
+				it++;
+				continue;
+			}
+
+			// the whole system at once
+			if(job.changed)
+				updateGamelist(job.system);
+			checkpoint.addSystem(job.system);
+			report({ "system", job.system->getName(), "done" });
+			it = running.erase(it);
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	if(sInterrupted)
+	{
+		LOG(LogInfo) << "Interrupt received during scrape...";
+		for(auto it = running.begin(); it != running.end(); it++)
+			(*it)->scheduler->stop();
+		report({ "interrupted", std::to_string(scraped), std::to_string(skipped) });
+		return 1;
+	}
+
+	checkpoint.clear();
+
+	// throughput, to compare runs against the same server
+	const float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+	char rate[32];
+	snprintf(rate, sizeof(rate), "%.2f", seconds > 0 ? (scraped + skipped) / seconds : 0.0f);
+	report({ "done", std::to_string(scraped), std::to_string(skipped), std::to_string((int)(seconds * 1000)), rate });
+	return 0;
+}
+
+static bool parseOptions(int argc, char* argv[], ScrapeOptions& options)
+{
+	for(int i = 1; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+		if(strcmp(argv[i], "--scrape-auto") == 0)
+		{
+			options.headless = true;
+		}else if(strcmp(argv[i], "--scrape-systems") == 0 && hasValue)
+		{
+			options.systems = split(argv[++i], ',');
+		}else if(strcmp(argv[i], "--scrape-all") == 0)
+		{
+			options.allGames = true;
+		}else if(strcmp(argv[i], "--scrape-accept") == 0 && hasValue)
+		{
+			const std::string policy = argv[++i];
+			if(policy == "first")
+				options.accept = ACCEPT_FIRST;
+			else if(policy == "single")
+				options.accept = ACCEPT_SINGLE;
+			else if(policy == "exact")
+				options.accept = ACCEPT_EXACT;
+			else
+			{
+				std::cerr << "Unknown scrape acceptance policy \"" << policy << "\"\n";
+				return false;
+			}
+		}else if(strcmp(argv[i], "--scrape-jobs") == 0 && hasValue)
+		{
+			options.jobs = atoi(argv[++i]);
+		}else if(strcmp(argv[i], "--scrape-checkpoint") == 0 && hasValue)
+		{
+			options.checkpoint = argv[++i];
+		}else if(strcmp(argv[i], "--scrape-restart") == 0)
+		{
+			options.restart = true;
+		}else if(strcmp(argv[i], "--scrape-server") == 0 && hasValue)
+		{
+			Settings::getInstance()->setString("ScreenscraperServer", argv[++i]);
+		}
+	}
+
+	return true;
+}
+
+static int run_scraper_headless(ScrapeOptions& options)
+{
+	std::vector<SystemData*> systems;
+	for(auto i = SystemData::sSystemVector.begin(); i != SystemData::sSystemVector.end(); i++)
+	{
+		if(options.systems.empty() || std::find(options.systems.begin(), options.systems.end(), (*i)->getName()) != options.systems.end())
+			systems.push_back(*i);
+	}
+
+	for(auto it = options.systems.begin(); it != options.systems.end(); it++)
+	{
+		if(SystemData::getSystem(*it) == NULL)
+		{
+			std::cerr << "System \"" << *it << "\" not found.\n";
+			return 1;
+		}
+	}
+
+	return scrape(systems, options);
+}
+
+int run_scraper_cmdline(int argc, char* argv[])
+{
+	signal(SIGINT, handle_interrupt_signal);
+
+	ScrapeOptions options;
+	if(!parseOptions(argc, argv, options))
+		return 1;
+	if(options.headless)
+		return run_scraper_headless(options);
+
 	out << "EmulationStation scraper\n";
 	out << "========================\n";
 	out << "\n";
 
-	signal(SIGINT, handle_interrupt_signal);
-
 	//==================================================================================
 	//filter
 	//==================================================================================
@@ -46,6 +514,8 @@ int run_scraper_cmdline()
 		std::cin.ignore(1, '\n'); //skip the unconsumed newline
 	} while(filter_choice < FILTER_MISSING_IMAGES || filter_choice > FILTER_ALL);
 
+	options.allGames = filter_choice == FILTER_ALL;
+
 	out << "\n";
 
 	//==================================================================================
@@ -59,7 +529,7 @@ int run_scraper_cmdline()
 
 	std::string system_choice;
 	std::getline(std::cin, system_choice);
-	
+
 	if(system_choice == "y" || system_choice == "Y")
 	{
 		out << "Will scrape all platforms.\n";
@@ -87,7 +557,7 @@ int run_scraper_cmdline()
 			}
 
 			std::getline(std::cin, sys_name);
-			
+
 			if(sys_name.empty())
 				break;
 
@@ -121,11 +591,11 @@ int run_scraper_cmdline()
 	std::string manual_mode_str;
 	std::getline(std::cin, manual_mode_str);
 
-	bool manual_mode = false;
-
 	if(manual_mode_str == "y" || manual_mode_str == "Y")
 	{
-		manual_mode = true;
+		// one system at a time, the questions come in order
+		options.accept = ACCEPT_MANUAL;
+		options.jobs = 1;
 		out << "Scraping in manual mode!\n";
 	}else{
 		out << "Scraping in automatic mode!\n";
@@ -138,148 +608,12 @@ int run_scraper_cmdline()
 	out << "Alright, let's do this thing!\n";
 	out << "=============================\n";
 
-	/*
-	std::shared_ptr<Scraper> scraper = Settings::getInstance()->getScraper();
-	for(auto sysIt = systems.begin(); sysIt != systems.end(); sysIt++)
-	{
-		std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
-
-		ScraperSearchParams params;
-		params.system = (*sysIt);
-
-		for(auto gameIt = files.begin(); gameIt != files.end(); gameIt++)
-		{
-			params.nameOverride = "";
-			params.game = *gameIt;
-
-			//print original search term
-			out << getCleanFileName(params.game->getPath()) << "...\n";
-
-			//need to take into account filter_choice
-			if(filter_choice == FILTER_MISSING_IMAGES)
-			{
-				if(!params.game->metadata.get("image").empty()) //maybe should also check if the image file exists/is a URL
-				{
-					out << "   Skipping, metadata \"image\" entry is not empty.\n";
-					continue;
-				}
-			}
-
-			//actually get some results
-			do {
-				std::vector<MetaDataList> mdls = scraper->getResults(params);
-
-				//no results
-				if(mdls.size() == 0)
-				{
-					if(manual_mode)
-					{
-						//in manual mode let the user enter a custom search
-						out << "   NO RESULTS FOUND! Enter a new name to search for, or nothing to skip.\n";
-
-						std::getline(std::cin, params.nameOverride);
-
-						if(params.nameOverride.empty())
-						{
-							out << "   Skipping...\n";
-							break;
-						}
-
-						continue;
-
-					}else{
-						out << "   NO RESULTS FOUND! Skipping...\n";
-						break;
-					}
-				}
-
-				//some results
-				if(manual_mode)
-				{
-					//print list of choices
-					for(unsigned int i = 0; i < mdls.size(); i++)
-					{
-						out << "   " << i << " - " << mdls.at(i).get("name") << "\n";
-					}
-
-					int choice = -1;
-					std::string choice_str;
-					
-					out << "Your choice: ";
-
-					std::getline(std::cin, choice_str);
-					std::stringstream choice_buff(choice_str); //convert to int
-					choice_buff >> choice;
-
-					if(choice >= 0 && choice < (int)mdls.size())
-					{
-						params.game->metadata = mdls.at(choice);
-						break;
-					}else{
-						out << "Invalid choice.\n";
-						continue;
-					}
-
-				}else{
-					//automatic mode
-					//always choose the first choice
-					out << "   name -> " << mdls.at(0).get("name") << "\n";
-					params.game->metadata = mdls.at(0);
-					break;
-				}
-
-			} while(true);
-
-			out << "===================\n";
-		}
-	}
-
-	out << "\n\n";
-	out << "Downloading boxart...\n";
-
-	for(auto sysIt = systems.begin(); sysIt != systems.end(); sysIt++)
-	{
-		std::vector<FileData*> files = (*sysIt)->getRootFolder()->getFilesRecursive(GAME);
-
-		for(auto gameIt = files.begin(); gameIt != files.end(); gameIt++)
-		{
-			FileData* game = *gameIt;
-			const std::vector<MetaDataDecl>& mdd = game->metadata.getMDD();
-			for(auto i = mdd.begin(); i != mdd.end(); i++)
-			{
-				std::string key = i->key;
-				std::string url = game->metadata.get(key);
-
-				if(i->type == MD_IMAGE_PATH && HttpReq::isUrl(url))
-				{
-					std::string urlShort = url.substr(0, url.length() > 35 ? 35 : url.length());
-					if(url.length() != urlShort.length()) urlShort += "...";
-
-					out << "   " << game->metadata.get("name") << " [from: " << urlShort << "]...\n";
-
-					ScraperSearchParams p;
-					p.game = game;
-					p.system = *sysIt;
-					game->metadata.set(key, downloadImage(url, getSaveAsPath(p, key, url)));
-					if(game->metadata.get(key).empty())
-					{
-						out << "     FAILED! Skipping.\n";
-						game->metadata.set(key, url); //result URL to what it was if download failed, retry some other time
-					}
-				}
-			}
-		}
-	}
-
+	int result = scrape(systems, options);
 
 	out << "\n\n";
 	out << "==============================\n";
-	out << "SCRAPE COMPLETE!\n";
+	out << (result == 0 ? "SCRAPE COMPLETE!\n" : "SCRAPE INTERRUPTED, RUN IT AGAIN TO RESUME\n");
 	out << "==============================\n";
-	*/
 
-	out << "\n\n";
-	out << "ACTUALLY THIS IS STILL TODO\n";
-
-	return 0;
+	return result;
 }
@@ -1,3 +1,4 @@
 #pragma once
 
-int run_scraper_cmdline();
+// Interactive, or headless with --scrape-auto, then options are read from the arguments
+int run_scraper_cmdline(int argc, char* argv[]);
@@ -5,6 +5,8 @@
 #include "Log.h"
 #include "Settings.h"
 #include "Util.h"
+#include "GameSearchIndex.h"
+#include "resources/ResourceManager.h"
 #include <boost/thread.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/asio/io_service.hpp>
@@ -51,6 +53,14 @@ SystemData::SystemData(const std::string &name, const std::string &fullName, con
 
   mIsFavorite = false;
   loadTheme();
+
+  // Systems are created by the loading thread pool, so orderings are computed in the background
+  std::vector<FileData *> files = mRootFolder->getFilesRecursive(GAME | FOLDER);
+  mSortIndex.build(files);
+
+  for (auto file : files)
+    if (file->getType() == GAME && file->metadata.get("favorite") == "true")
+      mFavorites.insert(file);
 }
 
 SystemData::SystemData(const std::string &name, const std::string &fullName, const std::string &command,
@@ -67,15 +77,17 @@ SystemData::SystemData(const std::string &name, const std::string &fullName, con
   mRootFolder->metadata.set("name", mFullName);
 
   for (auto system : *systems)
-  {
-    std::vector<FileData *> favorites = system->getFavorites();
-    for (auto favorite : favorites)
+    for (auto favorite : system->mFavorites)
+    {
       mRootFolder->addAlreadyExistingChild(favorite);
-  }
+      mFavorites.insert(favorite);
+    }
 
   mIsFavorite = true;
   mPlatformIds.push_back(PlatformIds::PLATFORM_IGNORE);
   loadTheme();
+
+  mSortIndex.build(mRootFolder->getFilesRecursive(GAME | FOLDER));
 }
 
 SystemData::~SystemData()
@@ -216,6 +228,9 @@ void SystemData::launchGame(Window* window, FileData* game, std::string netplay,
 	}
 
 
+	// the emulator is configured from recalbox.conf
+	RecalboxConf::getInstance()->sync();
+
 	LOG(LogInfo) << "	" << command;
 	std::cout << "==============================================\n";
 	int exitCode = runSystemCommand(command);
@@ -488,6 +503,8 @@ bool SystemData::loadConfig()
     }
   }
 
+  GameSearchIndex::getInstance()->build();
+
   return true;
 }
 
@@ -545,6 +562,8 @@ bool deleteSystem(SystemData *system)
 
 void SystemData::deleteSystems()
 {
+  GameSearchIndex::getInstance()->clear();
+
   if (!sSystemVector.empty())
   {
     // THE DELETION OF EACH SYSTEM
@@ -624,10 +643,10 @@ std::string SystemData::getThemePath() const
   if (fs::exists(localThemePath))
     return localThemePath.generic_string();
 
-  // not in game folder, try system theme in theme sets
+  // not in game folder, try system theme in theme sets (they may be packed)
   localThemePath = ThemeData::getThemeFromCurrentSet(mThemeFolder);
 
-  if (fs::exists(localThemePath))
+  if (ResourceManager::getInstance()->fileExists(localThemePath.generic_string()))
     return localThemePath.generic_string();
 
   // not system theme, try default system theme in theme set
@@ -641,11 +660,6 @@ unsigned int SystemData::getGameCount() const
   return (unsigned int) mRootFolder->getFilesRecursive(GAME).size();
 }
 
-unsigned int SystemData::getFavoritesCount() const
-{
-  return (unsigned int) mRootFolder->getFavoritesRecursive(GAME).size();
-}
-
 unsigned int SystemData::getHiddenCount() const
 {
   return (unsigned int) mRootFolder->getHiddenRecursive(GAME).size();
@@ -657,7 +671,7 @@ void SystemData::loadTheme()
 
   std::string path = getThemePath();
 
-  if (!fs::exists(path)) // no theme available for this platform
+  if (!ResourceManager::getInstance()->fileExists(path)) // no theme available for this platform
     return;
 
   try
@@ -673,6 +687,34 @@ void SystemData::loadTheme()
   }
 }
 
+bool loadSystemTheme(SystemData *system)
+{
+  system->loadTheme();
+  return true;
+}
+
+void SystemData::loadThemes(const std::vector<SystemData *> &systems)
+{
+  boost::asio::io_service ioService;
+  boost::thread_group threadpool;
+  boost::asio::io_service::work work(ioService);
+  for (int i = 0; i < 4; i++)
+    threadpool.create_thread(boost::bind(&boost::asio::io_service::run, &ioService));
+
+  std::vector<boost::unique_future<bool>> pending_data;
+  for (SystemData *system : systems)
+  {
+    typedef boost::packaged_task<bool> task_t;
+    boost::shared_ptr<task_t> task = boost::make_shared<task_t>(boost::bind(&loadSystemTheme, system));
+    pending_data.push_back(task->get_future());
+    ioService.post(boost::bind(&task_t::operator(), task));
+  }
+  boost::wait_for_all(pending_data.begin(), pending_data.end());
+
+  ioService.stop();
+  threadpool.join_all();
+}
+
 std::map<std::string, std::vector<std::string> *> *SystemData::getEmulators()
 {
   return mEmulators;
@@ -719,4 +761,68 @@ int SystemData::getSystemIndex(const std::string &name)
     if (sSystemVector[i]->mName == name)
       return i;
   return -1;
-}
\ No newline at end of file
+}
+
+bool SystemData::updateIndexes(FileData *file)
+{
+  SystemData *system = file->getSystem();
+  if (system == nullptr || file == system->getRootFolder())
+    return false;
+
+  bool favorite = file->getType() == GAME && file->metadata.get("favorite") == "true";
+  bool changed;
+  {
+    std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+    system->mSortIndex.update(file);
+    changed = favorite ? system->mFavorites.insert(file).second : system->mFavorites.erase(file) != 0;
+  }
+
+  GameSearchIndex::getInstance()->update(file);
+
+  SystemData *favoriteSystem = getFavoriteSystem();
+  if (favoriteSystem != nullptr && favoriteSystem != system)
+  {
+    std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+    if (favorite)
+    {
+      if (favoriteSystem->mFavorites.insert(file).second)
+        favoriteSystem->mRootFolder->addAlreadyExistingChild(file);
+      favoriteSystem->mSortIndex.update(file);
+    }
+    else if (favoriteSystem->mFavorites.erase(file) != 0)
+    {
+      favoriteSystem->mRootFolder->removeAlreadyExistingChild(file);
+      favoriteSystem->mSortIndex.remove(file);
+    }
+  }
+
+  return changed;
+}
+
+bool SystemData::removeFromIndexes(FileData *file)
+{
+  bool favorite = false;
+
+  SystemData *system = file->getSystem();
+  if (system != nullptr)
+  {
+    std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+    system->mSortIndex.remove(file);
+    favorite = system->mFavorites.erase(file) != 0;
+  }
+
+  GameSearchIndex::getInstance()->remove(file);
+
+  SystemData *favoriteSystem = getFavoriteSystem();
+  if (favoriteSystem != nullptr && favoriteSystem != system)
+  {
+    std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+    if (favoriteSystem->mFavorites.erase(file) != 0)
+    {
+      favoriteSystem->mRootFolder->removeAlreadyExistingChild(file);
+      favoriteSystem->mSortIndex.remove(file);
+    }
+  }
+
+  return favorite;
+}
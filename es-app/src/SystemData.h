@@ -2,12 +2,14 @@
 
 #include <vector>
 #include <string>
+#include <unordered_set>
 #include "FileData.h"
 #include "Window.h"
 #include "MetaData.h"
 #include "PlatformId.h"
 #include "ThemeData.h"
 #include "FileSorts.h"
+#include "FileSortIndex.h"
 
 #include <boost/property_tree/ptree.hpp>
 
@@ -30,10 +32,12 @@ public:
 	inline const std::string& getThemeFolder() const { return mThemeFolder; }
 	inline bool getHasFavorites() const { return mHasFavorites; }
 	inline bool isFavorite() const { return mIsFavorite; }
-	inline std::vector<FileData*> getFavorites() const { return mRootFolder->getFavoritesRecursive(GAME); }
+	inline std::vector<FileData*> getFavorites() const { return std::vector<FileData*>(mFavorites.begin(), mFavorites.end()); }
+	inline bool hasFavorite(FileData* game) const { return mFavorites.find(game) != mFavorites.end(); }
 	inline unsigned int getSortId() const { return mSortId; };
 	inline FileData::SortType getSortType() const { return FileSorts::SortTypes.at(mSortId); };
 	inline void setSortId(const unsigned int sortId = 0) { mSortId = sortId; };
+	inline FileSortIndex& getSortIndex() { return mSortIndex; }
 
 	inline const std::vector<PlatformIds::PlatformId>& getPlatformIds() const { return mPlatformIds; }
 	inline bool hasPlatformId(PlatformIds::PlatformId id) { return std::find(mPlatformIds.begin(), mPlatformIds.end(), id) != mPlatformIds.end(); }
@@ -45,7 +49,7 @@ public:
 	std::string getThemePath() const;
 	
 	unsigned int getGameCount() const;
-	unsigned int getFavoritesCount() const;
+	inline unsigned int getFavoritesCount() const { return (unsigned int) mFavorites.size(); }
 	unsigned int getHiddenCount() const;
 
 	void launchGame(Window* window, FileData* game, std::string netplay = "", std::string core = "", std::string ip = "", std::string port = "");
@@ -68,6 +72,22 @@ public:
 	static SystemData* getSystem(std::string& name);
 	static int getSystemIndex(const std::string& name);
 
+	/*!
+	 * Re-position a file in the sort index of its system, and add it to or remove it from
+	 * the favorites of its system and of the favorites system according to its favorite flag.
+	 * Must be called once the file metadata changed (name, rating, favorite, playcount, ...)
+	 * @param file Modified file
+	 * @return True if the file entered or left the favorites
+	 */
+	static bool updateIndexes(FileData* file);
+	/*!
+	 * Remove a file from every sort index and favorites collection it belongs to.
+	 * Must be called before the file is deleted.
+	 * @param file File about to be deleted
+	 * @return True if the file was a favorite
+	 */
+	static bool removeFromIndexes(FileData* file);
+
 	inline std::vector<SystemData*>::const_iterator getIterator() const { return std::find(sSystemVector.begin(), sSystemVector.end(), this); };
 	inline std::vector<SystemData*>::const_reverse_iterator getRevIterator() const { return std::find(sSystemVector.rbegin(), sSystemVector.rend(), this); };
 	
@@ -89,6 +109,9 @@ public:
 
 	// Load or re-load theme.
 	void loadTheme();
+	// Re-load the themes of several systems at once, on worker threads.
+	// Files included by every system are only parsed once, see ThemeData.
+	static void loadThemes(const std::vector<SystemData*>& systems);
 
 	std::map<std::string, std::vector<std::string> *> * getEmulators();
 	std::vector<std::string> getCores(const std::string& emulatorName);
@@ -115,6 +138,9 @@ private:
 	bool mHasFavorites;
 	bool mIsFavorite;
 	unsigned int mSortId;
+	FileSortIndex mSortIndex;
+	//! Favorite games of this system, or of every system for the favorites one
+	std::unordered_set<FileData*> mFavorites;
 
 	void populateFolder(FileData* folder);
 
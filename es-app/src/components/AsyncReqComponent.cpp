@@ -5,7 +5,8 @@ AsyncReqComponent::AsyncReqComponent(Window* window, std::shared_ptr<HttpReq> re
 	: GuiComponent(window), 
 	mSuccessFunc(onSuccess), mCancelFunc(onCancel), mTime(0), mRequest(req)
 {
-	
+	// the request is polled every frame
+	setUpdating(true);
 }
 
 bool AsyncReqComponent::input(InputConfig* config, Input input)
@@ -10,7 +10,7 @@
 	Displays a simple animation on the UI to show the application hasn't frozen.  Can be canceled by the user pressing B.
 
 	Usage example:
-		std::shared_ptr<HttpReq> httpreq = std::make_shared<HttpReq>("cdn.garcya.us", "/wp-content/uploads/2010/04/TD250.jpg");
+		std::shared_ptr<HttpReq> httpreq = std::make_shared<HttpReq>("http://cdn.garcya.us/wp-content/uploads/2010/04/TD250.jpg");
 		AsyncReqComponent* req = new AsyncReqComponent(mWindow, httpreq,
 			[] (std::shared_ptr<HttpReq> r)
 		{
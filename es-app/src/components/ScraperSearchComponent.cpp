@@ -22,6 +22,8 @@ ScraperSearchComponent::ScraperSearchComponent(Window* window, SearchType type)
 	mSearchType(type)
 {
 	addChild(&mGrid);
+	// requests are polled every frame
+	setUpdating(true);
 	
 	auto menuTheme = MenuThemeData::getInstance()->getCurrentTheme();
 
@@ -221,6 +223,23 @@ void ScraperSearchComponent::search(const ScraperSearchParams& params)
 	mSearchHandle = startScraperSearch(params);
 }
 
+void ScraperSearchComponent::showResult(const ScraperSearchResult& result)
+{
+	stop();
+	mScraperResults.clear();
+	mScraperResults.push_back(result);
+	updateInfoPane();
+
+	// no need to download a thumbnail
+	mThumbnailReq.reset();
+	const std::string image = result.mdl.get("image");
+	if(!image.empty())
+	{
+		mResultThumbnail->setImage(image);
+		mGrid.onSizeChanged();
+	}
+}
+
 void ScraperSearchComponent::stop()
 {
 	mThumbnailReq.reset();
@@ -311,10 +330,13 @@ void ScraperSearchComponent::updateInfoPane()
 
 		mResultThumbnail->setImage("");
 		const std::string& thumb = res.thumbnailUrl.empty() ? res.imageUrl : res.thumbnailUrl;
-		if(!thumb.empty())
+		if(!thumb.empty() && HttpReq::isUrl(thumb))
 		{
 			mThumbnailReq = std::unique_ptr<HttpReq>(new HttpReq(thumb));
 		}else{
+			// a local file, from the offline scraper
+			if(!thumb.empty())
+				mResultThumbnail->setImage(thumb);
 			mThumbnailReq.reset();
 		}
 
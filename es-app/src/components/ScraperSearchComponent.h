@@ -28,6 +28,8 @@ public:
 	ScraperSearchComponent(Window* window, SearchType searchType = NEVER_AUTO_ACCEPT);
 
 	void search(const ScraperSearchParams& params);
+	// Show a result scraped elsewhere, with its media already downloaded
+	void showResult(const ScraperSearchResult& result);
 	void openInputScreen(ScraperSearchParams& from);
 	void stop();
 	inline SearchType getSearchType() const { return mSearchType; }
@@ -31,6 +31,7 @@ protected:
 	using IList<TextListData, T>::getTransform;
 	using IList<TextListData, T>::mSize;
 	using IList<TextListData, T>::mCursor;
+	using IList<TextListData, T>::setUpdating;
     using typename IList<TextListData, T>::Entry;
 
 public:
@@ -45,7 +46,11 @@ public:
 	void render(const Eigen::Affine3f& parentTrans) override;
 	void applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties) override;
 
-	void add(const std::string& name, const T& obj, unsigned int colorId, bool toTheBeginning = false);
+	void add(const std::string& name, const T& obj, unsigned int colorId, bool toTheBeginning = false, char letter = 0);
+	void insert(const std::string& name, const T& obj, unsigned int colorId, int index, char letter = 0);
+
+	// page up/down go to the previous/next initial instead of scrolling, for lists sorted by name
+	inline void setLetterPaging(bool letterPaging) { mLetterPaging = letterPaging; }
 	
 	enum Alignment
 	{
@@ -97,6 +102,7 @@ private:
 	float mHorizontalMargin;
 
 	std::function<void(CursorState state)> mCursorChangedCallback;
+	bool mLetterPaging;
 
 	std::shared_ptr<Font> mFont;
 	bool mUppercase;
@@ -121,6 +127,7 @@ TextListComponent<T>::TextListComponent(Window* window) :
 
 	mHorizontalMargin = 0;
 	mAlignment = ALIGN_CENTER;
+	mLetterPaging = false;
 
 	mFont = Font::get(FONT_SIZE_MEDIUM);
 	mUppercase = false;
@@ -131,6 +138,9 @@ TextListComponent<T>::TextListComponent(Window* window) :
 	mSelectedColor = 0;
 	mColors[0] = 0x0000FFFF;
 	mColors[1] = 0x00FF00FF;
+
+	// until the first update tells if the selected name needs a marquee
+	setUpdating(true);
 }
 
 template <typename T>
@@ -257,13 +267,19 @@ bool TextListComponent<T>::input(InputConfig* config, Input input)
 			}
 			if(config->isMappedTo("pagedown", input))
 			{
-				listInput(10);
+				if(mLetterPaging)
+					IList<TextListData, T>::pageByLetter(1);
+				else
+					listInput(10);
 				return true;
 			}
 
 			if(config->isMappedTo("pageup", input))
 			{
-				listInput(-10);
+				if(mLetterPaging)
+					IList<TextListData, T>::pageByLetter(-1);
+				else
+					listInput(-10);
 				return true;
 			}
 		}else{
@@ -282,23 +298,31 @@ template <typename T>
 void TextListComponent<T>::update(int deltaTime)
 {
 	listUpdate(deltaTime);
-	if(!isScrolling() && size() > 0)
+	if(!isScrolling())
 	{
-		//if we're not scrolling and this object's text goes outside our size, marquee it!
-		const std::string& text = mEntries.at((unsigned int)mCursor).name;
+		bool marquee = false;
+		if(size() > 0)
+		{
+			//if we're not scrolling and this object's text goes outside our size, marquee it!
+			const std::string& text = mEntries.at((unsigned int)mCursor).name;
 
-		Eigen::Vector2f textSize = mFont->sizeText(text);
+			Eigen::Vector2f textSize = mFont->sizeText(text);
 
-		//it's long enough to marquee
-		if(textSize.x() - mMarqueeOffset > mSize.x() - 12 - mHorizontalMargin * 2)
-		{
-			mMarqueeTime += deltaTime;
-			while(mMarqueeTime > MARQUEE_SPEED)
+			//it's long enough to marquee
+			marquee = textSize.x() - mMarqueeOffset > mSize.x() - 12 - mHorizontalMargin * 2;
+			if(marquee)
 			{
-				mMarqueeOffset += MARQUEE_RATE;
-				mMarqueeTime -= MARQUEE_SPEED;
+				mMarqueeTime += deltaTime;
+				while(mMarqueeTime > MARQUEE_SPEED)
+				{
+					mMarqueeOffset += MARQUEE_RATE;
+					mMarqueeTime -= MARQUEE_SPEED;
+				}
 			}
 		}
+
+		// no more updates until the cursor, the entries or the theme change
+		setUpdating(marquee);
 	}
 
 	GuiComponent::update(deltaTime);
@@ -306,7 +330,7 @@ void TextListComponent<T>::update(int deltaTime)
 
 //list management stuff
 template <typename T>
-void TextListComponent<T>::add(const std::string& name, const T& obj, unsigned int color, bool toTheBeginning)
+void TextListComponent<T>::add(const std::string& name, const T& obj, unsigned int color, bool toTheBeginning, char letter)
 {
 	assert(color < COLOR_ID_COUNT);
 
@@ -314,6 +338,8 @@ void TextListComponent<T>::add(const std::string& name, const T& obj, unsigned i
 	entry.name = name;
 	entry.object = obj;
 	entry.data.colorId = color;
+	entry.letter = letter;
+	setUpdating(true);
 	if (toTheBeginning) {
 		static_cast<IList< TextListData, T >*>(this)->unshift(entry);
 	} else {
@@ -321,11 +347,26 @@ void TextListComponent<T>::add(const std::string& name, const T& obj, unsigned i
 	}
 }
 
+template <typename T>
+void TextListComponent<T>::insert(const std::string& name, const T& obj, unsigned int color, int index, char letter)
+{
+	assert(color < COLOR_ID_COUNT);
+
+	typename IList<TextListData, T>::Entry entry;
+	entry.name = name;
+	entry.object = obj;
+	entry.data.colorId = color;
+	entry.letter = letter;
+	setUpdating(true);
+	static_cast<IList< TextListData, T >*>(this)->insert(entry, index);
+}
+
 template <typename T>
 void TextListComponent<T>::onCursorChanged(const CursorState& state)
 {
 	mMarqueeOffset = 0;
 	mMarqueeTime = -MARQUEE_DELAY;
+	setUpdating(true);
 
 	if(mCursorChangedCallback)
 		mCursorChangedCallback(state);
@@ -335,6 +376,7 @@ template <typename T>
 void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties)
 {
 	GuiComponent::applyTheme(theme, view, element, properties);
+	setUpdating(true);
 
 	const ThemeData::ThemeElement* elem = theme->getElement(view, element, "textlist");
 	if(!elem)
@@ -343,26 +385,26 @@ void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, c
 	using namespace ThemeFlags;
 	if(properties & COLOR)
 	{
-		if(elem->has("selectorColor"))
-			setSelectorColor(elem->get<unsigned int>("selectorColor"));
-		if(elem->has("selectedColor"))
-			setSelectedColor(elem->get<unsigned int>("selectedColor"));
-		if(elem->has("primaryColor"))
-			setColor(0, elem->get<unsigned int>("primaryColor"));
-		if(elem->has("secondaryColor"))
-			setColor(1, elem->get<unsigned int>("secondaryColor"));
+		if(elem->has(ThemeProperty::SELECTOR_COLOR))
+			setSelectorColor(elem->get<unsigned int>(ThemeProperty::SELECTOR_COLOR));
+		if(elem->has(ThemeProperty::SELECTED_COLOR))
+			setSelectedColor(elem->get<unsigned int>(ThemeProperty::SELECTED_COLOR));
+		if(elem->has(ThemeProperty::PRIMARY_COLOR))
+			setColor(0, elem->get<unsigned int>(ThemeProperty::PRIMARY_COLOR));
+		if(elem->has(ThemeProperty::SECONDARY_COLOR))
+			setColor(1, elem->get<unsigned int>(ThemeProperty::SECONDARY_COLOR));
 	}
 
 	setFont(Font::getFromTheme(elem, properties, mFont));
 	
-	if(properties & SOUND && elem->has("scrollSound"))
-		setSound(Sound::get(elem->get<std::string>("scrollSound")));
+	if(properties & SOUND && elem->has(ThemeProperty::SCROLL_SOUND))
+		setSound(Sound::get(elem->get<std::string>(ThemeProperty::SCROLL_SOUND)));
 
 	if(properties & ALIGNMENT)
 	{
-		if(elem->has("alignment"))
+		if(elem->has(ThemeProperty::ALIGNMENT))
 		{
-			const std::string& str = elem->get<std::string>("alignment");
+			const std::string& str = elem->get<std::string>(ThemeProperty::ALIGNMENT);
 			if(str == "left")
 				setAlignment(ALIGN_LEFT);
 			else if(str == "center")
@@ -372,38 +414,38 @@ void TextListComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, c
 			else
 				LOG(LogError) << "Unknown TextListComponent alignment \"" << str << "\"!";
 		}
-		if(elem->has("horizontalMargin"))
+		if(elem->has(ThemeProperty::HORIZONTAL_MARGIN))
 		{
-			mHorizontalMargin = elem->get<float>("horizontalMargin") * (this->mParent ? this->mParent->getSize().x() : (float)Renderer::getScreenWidth());
+			mHorizontalMargin = elem->get<float>(ThemeProperty::HORIZONTAL_MARGIN) * (this->mParent ? this->mParent->getSize().x() : (float)Renderer::getScreenWidth());
 		}
 	}
 
-	if(properties & FORCE_UPPERCASE && elem->has("forceUppercase"))
-		setUppercase(elem->get<bool>("forceUppercase"));
+	if(properties & FORCE_UPPERCASE && elem->has(ThemeProperty::FORCE_UPPERCASE))
+		setUppercase(elem->get<bool>(ThemeProperty::FORCE_UPPERCASE));
 
 	if(properties & LINE_SPACING)
 	{
-		if(elem->has("lineSpacing"))
-			setLineSpacing(elem->get<float>("lineSpacing"));
-		if(elem->has("selectorHeight"))
+		if(elem->has(ThemeProperty::LINE_SPACING))
+			setLineSpacing(elem->get<float>(ThemeProperty::LINE_SPACING));
+		if(elem->has(ThemeProperty::SELECTOR_HEIGHT))
 		{
-			setSelectorHeight(elem->get<float>("selectorHeight") * Renderer::getScreenHeight());
+			setSelectorHeight(elem->get<float>(ThemeProperty::SELECTOR_HEIGHT) * Renderer::getScreenHeight());
 		} else {
 			setSelectorHeight(mFont->getSize() * 1.5);
 		}
-		if(elem->has("selectorOffsetY"))
+		if(elem->has(ThemeProperty::SELECTOR_OFFSET_Y))
 		{
 			float scale = this->mParent ? this->mParent->getSize().y() : (float)Renderer::getScreenHeight();
-			setSelectorOffsetY(elem->get<float>("selectorOffsetY") * scale);
+			setSelectorOffsetY(elem->get<float>(ThemeProperty::SELECTOR_OFFSET_Y) * scale);
 		} else {
 			setSelectorOffsetY(0.0);
 		}
 	}
 
-	if (elem->has("selectorImagePath"))
+	if (elem->has(ThemeProperty::SELECTOR_IMAGE_PATH))
 	{
-		std::string path = elem->get<std::string>("selectorImagePath");
-		bool tile = elem->has("selectorImageTile") && elem->get<bool>("selectorImageTile");
+		std::string path = elem->get<std::string>(ThemeProperty::SELECTOR_IMAGE_PATH);
+		bool tile = elem->has(ThemeProperty::SELECTOR_IMAGE_TILE) && elem->get<bool>(ThemeProperty::SELECTOR_IMAGE_TILE);
 		mSelectorImage.setImage(path, tile);
 		mSelectorImage.setSize(mSize.x(), mSelectorHeight);
 		mSelectorImage.setColorShift(mSelectorColor);
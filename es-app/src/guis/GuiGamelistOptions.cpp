@@ -6,6 +6,7 @@
 #include "views/ViewController.h"
 #include "components/SwitchComponent.h"
 #include "guis/GuiSettings.h"
+#include "guis/GuiSearch.h"
 #include "Locale.h"
 #include "MenuMessages.h"
 #include "guis/GuiMsgBox.h"
@@ -18,7 +19,8 @@ GuiGamelistOptions::GuiGamelistOptions(Window* window, SystemData* system) :
 	addChild(&mMenu);
 
 	// jump to letter
-	auto curChar = (char) toupper(getGamelist()->getCursor()->getName()[0]);
+	// letters are taken from the collation key, which the list is sorted on
+	auto curChar = getGamelist()->getCursor()->getSortKey()[0];
 
 	mJumpToLetterList = std::make_shared<LetterList>(mWindow, _("JUMP TO LETTER"), false);
 
@@ -49,6 +51,13 @@ GuiGamelistOptions::GuiGamelistOptions(Window* window, SystemData* system) :
 		mMenu.addRowWithHelp(row, _("JUMP TO LETTER"), _(MenuMessages::GAMELISTOPTION_JUMP_LETTER_MSG));
 	}
 
+	// search games of every system
+	row.elements.clear();
+	row.addElement(std::make_shared<TextComponent>(mWindow, _("SEARCH GAMES"), menuTheme->menuText.font, menuTheme->menuText.color), true);
+	row.addElement(makeArrow(mWindow), false);
+	row.makeAcceptInputHandler([this] { mWindow->pushGui(new GuiSearch(mWindow)); });
+	mMenu.addRowWithHelp(row, _("SEARCH GAMES"), _(MenuMessages::GAMELISTOPTION_SEARCH_GAMES_MSG));
+
 	// sort list by
 	unsigned int currentSortId = mSystem->getSortId();
 	if (currentSortId > FileSorts::SortTypes.size()) {
@@ -189,17 +198,14 @@ void GuiGamelistOptions::openMetaDataEd() {
 }
 
 std::vector<std::string> GuiGamelistOptions::getAvailableLetters() {
+	// the view maintains its initials along with the list, already in order
 	std::vector<std::string> letters;
-	std::vector<FileData*>files = getGamelist()->getFileDataList();
-	for (auto file : files) {
-		std::string letter = std::string(1, toupper(file->getName()[0]));
-		if ( ( (letter[0] >= '0' && letter[0] <= '9') || (letter[0] >= 'A' && letter[0] <= 'Z') ) ) {
-			if (std::find(letters.begin(), letters.end(), letter) == letters.end()) {
-				letters.push_back(letter);
-			}
+	std::vector<char> initials = getGamelist()->getAvailableLetters();
+	for (auto letter : initials) {
+		if ( (letter >= '0' && letter <= '9') || (letter >= 'A' && letter <= 'Z') ) {
+			letters.push_back(std::string(1, letter));
 		}
 	}
-	std::sort(letters.begin(), letters.end());
 	return letters;
 }
 
@@ -222,37 +228,7 @@ void GuiGamelistOptions::jumpToLetter() {
 		gamelist->onFileChanged(mSystem->getRootFolder(), FILE_SORTED);
 	}
 
-	std::vector<FileData*>files = gamelist->getFileDataList();
-
-	long min = 0;
-	long max = files.size() - 1;
-	long mid = 0;
-
-	if (sortId == 1) {
-		// sort Alpha DESC
-		std::reverse(files.begin(), files.end());
-	}
-
-	while(max >= min) {
-		mid = ((max - min) / 2) + min;
-
-		// game somehow has no first character to check
-		if (files.at(mid)->getName().empty()) {
-			continue;
-		}
-
-		char checkLetter = (char) toupper(files.at(mid)->getName()[0]);
-
-		if (checkLetter < letter) {
-			min = mid + 1;
-		} else if (checkLetter > letter || (mid > 0 && (letter == toupper(files.at(mid - 1)->getName()[0])))) {
-			max = mid - 1;
-		} else {
-			break; //exact match found
-		}
-	}
-
-	gamelist->setCursor(files.at(mid));
+	gamelist->jumpToLetter(letter);
 	delete this;
 }
 
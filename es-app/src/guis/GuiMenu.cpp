@@ -826,20 +826,13 @@ void GuiMenu::menuUISettings(){
 	s->addWithLabel(theme_set, _("THEME SET"), _(MenuMessages::UI_THEME_HELP_MSG));
 
 	std::function<void()> ReloadAll = [this, window] () {
-		ViewController::get()->goToStart();
 		window->renderShutdownScreen();
-		delete ViewController::get();
-		for (auto systems = SystemData::sSystemVector.begin(); systems != SystemData::sSystemVector.end(); systems++)
-			(*systems)->loadTheme();
+		ViewController::get()->reloadThemes();
+		// menus are still drawn with the previous menu theme
 		GuiComponent *gui;
-		while ((gui = window->peekGui()) != NULL) {
+		while ((gui = window->peekGui()) != NULL && gui != ViewController::get()) {
 			window->removeGui(gui);
 		}
-		delete gui;
-		ViewController::init(window);
-		ViewController::get()->reloadAll();
-		window->pushGui(ViewController::get());
-		ViewController::get()->goToStart();
 		MenuThemeData::getInstance();
 		auto transi = ThemeData::getCurrent()->getTransition();
 		if (transi != "")
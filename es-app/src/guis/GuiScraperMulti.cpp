@@ -12,6 +12,8 @@
 #include "Locale.h"
 #include "MenuThemeData.h"
 
+#define GAMELIST_SAVE_INTERVAL	25
+
 using namespace boost::locale;
 using namespace Eigen;
 
@@ -36,6 +38,7 @@ GuiScraperMulti::GuiScraperMulti(Window* window, const std::queue<ScraperSearchP
 	mCurrentGame = 0;
 	mTotalSuccessful = 0;
 	mTotalSkipped = 0;
+	mUnsavedGames = 0;
 
 	// set up grid
 	mTitle = std::make_shared<TextComponent>(mWindow, _("SCRAPING IN PROGRESS"), menuTheme->menuTitle.font, menuTheme->menuTitle.color, ALIGN_CENTER);
@@ -77,11 +80,24 @@ GuiScraperMulti::GuiScraperMulti(Window* window, const std::queue<ScraperSearchP
 	setSize(Renderer::getScreenWidth() * 0.95f, Renderer::getScreenHeight() * 0.849f);
 	setPosition((Renderer::getScreenWidth() - mSize.x()) / 2, (Renderer::getScreenHeight() - mSize.y()) / 2);
 
-	doNextSearch();
+	if(approveResults)
+	{
+		doNextSearch();
+		return;
+	}
+
+	// nothing to approve: several games are scraped at once, the search component only shows the last result
+	mScheduler.reset(new ScraperScheduler(mSearchQueue, getScraperLimits()));
+	mScheduler->setResultCallback(std::bind(&GuiScraperMulti::onScraped, this, std::placeholders::_1, std::placeholders::_2));
+	mScheduler->setSkipCallback(std::bind(&GuiScraperMulti::onSkipped, this, std::placeholders::_1));
+	updateProgress(mSearchQueue.front());
+	setUpdating(true);
 }
 
 GuiScraperMulti::~GuiScraperMulti()
 {
+	saveGamelists();
+
 	// view type probably changed (basic -> detailed)
 	for(auto it = SystemData::sSystemVector.begin(); it != SystemData::sSystemVector.end(); it++)
 		ViewController::get()->reloadGameListView(*it, false);
@@ -98,6 +114,65 @@ void GuiScraperMulti::onSizeChanged()
 	mGrid.setSize(mSize);
 }
 
+void GuiScraperMulti::update(int deltaTime)
+{
+	GuiComponent::update(deltaTime);
+
+	if(!mScheduler || !mIsProcessing)
+		return;
+
+	mScheduler->update();
+	if(mIsProcessing && mScheduler->isDone())
+		finish();
+}
+
+void GuiScraperMulti::onScraped(const ScraperSearchParams& search, const ScraperSearchResult& result)
+{
+	applyResult(search, result);
+	mSearchComp->showResult(result);
+
+	mCurrentGame++;
+	mTotalSuccessful++;
+	updateProgress(search);
+}
+
+void GuiScraperMulti::onSkipped(const ScraperSearchParams& search)
+{
+	mCurrentGame++;
+	mTotalSkipped++;
+	updateProgress(search);
+}
+
+void GuiScraperMulti::updateProgress(const ScraperSearchParams& search)
+{
+	mSystem->setText(strToUpper(search.system->getFullName()));
+
+	char strbuf[256];
+	snprintf(strbuf, 256, _("GAME %i OF %i").c_str(), std::min(mCurrentGame + 1, mTotalGames), mTotalGames);
+
+	std::stringstream ss;
+	ss << strbuf << " - " << strToUpper(search.game->getPath().filename().string());
+	mSubtitle->setText(ss.str());
+}
+
+void GuiScraperMulti::applyResult(const ScraperSearchParams& search, const ScraperSearchResult& result)
+{
+	search.game->metadata.merge(result.mdl);
+	SystemData::updateIndexes(search.game);
+
+	mUnsavedSystems.insert(search.system);
+	if(++mUnsavedGames >= GAMELIST_SAVE_INTERVAL)
+		saveGamelists();
+}
+
+void GuiScraperMulti::saveGamelists()
+{
+	for(auto it = mUnsavedSystems.begin(); it != mUnsavedSystems.end(); it++)
+		updateGamelist(*it);
+	mUnsavedSystems.clear();
+	mUnsavedGames = 0;
+}
+
 void GuiScraperMulti::doNextSearch()
 {
 	if(mSearchQueue.empty())
@@ -123,10 +198,7 @@ void GuiScraperMulti::doNextSearch()
 
 void GuiScraperMulti::acceptResult(const ScraperSearchResult& result)
 {
-	ScraperSearchParams& search = mSearchQueue.front();
-
-	search.game->metadata.merge(result.mdl);
-	updateGamelist(search.system);
+	applyResult(mSearchQueue.front(), result);
 
 	mSearchQueue.pop();
 	mCurrentGame++;
@@ -144,6 +216,13 @@ void GuiScraperMulti::skip()
 
 void GuiScraperMulti::finish()
 {
+	if(mScheduler)
+	{
+		mScheduler->stop();
+		setUpdating(false);
+	}
+	saveGamelists();
+
 	std::stringstream ss;
 	if(mTotalSuccessful == 0)
 	{
@@ -4,9 +4,11 @@
 #include "components/NinePatchComponent.h"
 #include "components/ComponentGrid.h"
 #include "scrapers/Scraper.h"
+#include "scrapers/ScraperScheduler.h"
 #include "components/TextComponent.h"
 
 #include <queue>
+#include <set>
 
 class ScraperSearchComponent;
 class TextComponent;
@@ -18,13 +20,23 @@ public:
 	virtual ~GuiScraperMulti();
 
 	void onSizeChanged() override;
+	void update(int deltaTime) override;
 	std::vector<HelpPrompt> getHelpPrompts() override;
 
 private:
 	void acceptResult(const ScraperSearchResult& result);
 	void skip();
 	void doNextSearch();
-	
+
+	// results of the scheduler, when results don't need approval
+	void onScraped(const ScraperSearchParams& search, const ScraperSearchResult& result);
+	void onSkipped(const ScraperSearchParams& search);
+	void updateProgress(const ScraperSearchParams& search);
+
+	void applyResult(const ScraperSearchParams& search, const ScraperSearchResult& result);
+	// gamelists are written every few games rather than after each one
+	void saveGamelists();
+
 	void finish();
 
 	unsigned int mTotalGames;
@@ -32,6 +44,9 @@ private:
 	unsigned int mTotalSuccessful;
 	unsigned int mTotalSkipped;
 	std::queue<ScraperSearchParams> mSearchQueue;
+	std::unique_ptr<ScraperScheduler> mScheduler;
+	std::set<SystemData*> mUnsavedSystems;
+	unsigned int mUnsavedGames;
 
 	NinePatchComponent mBackground;
 	ComponentGrid mGrid;
@@ -0,0 +1,121 @@
+#include "guis/GuiSearch.h"
+#include "guis/GuiTextEditPopupKeyboard.h"
+#include "views/ViewController.h"
+#include "GameSearchIndex.h"
+#include "SystemData.h"
+#include "Settings.h"
+#include "Window.h"
+#include "Locale.h"
+
+#define MAX_RESULTS	100
+
+GuiSearch::GuiSearch(Window* window) : GuiComponent(window), mMenu(window, _("SEARCH").c_str())
+{
+	addChild(&mMenu);
+
+	mMenu.addButton(_("CLOSE"), _("CLOSE"), [this] { delete this; });
+
+	populate("");
+
+	setSize((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
+	mMenu.setPosition((mSize.x() - mMenu.getSize().x()) / 2, Renderer::getScreenHeight() * 0.15f);
+
+	openKeyboard();
+}
+
+std::string GuiSearch::getCountTitle(const std::string& query)
+{
+	GameSearchIndex* index = GameSearchIndex::getInstance();
+	if (!index->isReady())
+		return _("INDEXING GAMES...");
+	if (query.empty())
+		return _("SEARCH");
+
+	// one more than displayed, to tell when some are left out
+	int count = (int) index->search(query, MAX_RESULTS + 1, Settings::getInstance()->getBool("ShowHidden")).size();
+	char strbuf[256];
+	if (count > MAX_RESULTS)
+		snprintf(strbuf, 256, _("MORE THAN %i GAMES FOUND").c_str(), MAX_RESULTS);
+	else
+		snprintf(strbuf, 256, ngettext("%i GAME FOUND", "%i GAMES FOUND", count).c_str(), count);
+	return strbuf;
+}
+
+void GuiSearch::openKeyboard()
+{
+	auto keyboard = new GuiTextEditPopupKeyboard(mWindow, getCountTitle(mQuery), mQuery,
+												 [this](const std::string& query) { populate(query); }, false, _("SEARCH"));
+	// the callback belongs to the keyboard, so it can't outlive it
+	keyboard->setTextChangedCallback([keyboard](const std::string& query) { keyboard->setTitle(getCountTitle(query)); });
+	mWindow->pushGui(keyboard);
+}
+
+void GuiSearch::populate(const std::string& query)
+{
+	mQuery = query;
+	mMenu.clear();
+
+	auto menuTheme = MenuThemeData::getInstance()->getCurrentTheme();
+
+	ComponentListRow row;
+	row.addElement(std::make_shared<TextComponent>(mWindow, _("SEARCH FOR"), menuTheme->menuText.font, menuTheme->menuText.color), true);
+	row.addElement(std::make_shared<TextComponent>(mWindow, mQuery, menuTheme->menuTextSmall.font, menuTheme->menuTextSmall.color, ALIGN_RIGHT), false);
+	row.addElement(makeArrow(mWindow), false);
+	row.makeAcceptInputHandler([this] { openKeyboard(); });
+	mMenu.addRow(row);
+
+	if (mQuery.empty())
+		return;
+
+	std::vector<FileData*> games = GameSearchIndex::getInstance()->search(mQuery, MAX_RESULTS, Settings::getInstance()->getBool("ShowHidden"));
+	for (auto game : games)
+	{
+		row.elements.clear();
+		row.addElement(std::make_shared<TextComponent>(mWindow, game->getName(), menuTheme->menuText.font, menuTheme->menuText.color), true);
+		row.addElement(std::make_shared<TextComponent>(mWindow, game->getSystem()->getFullName(), menuTheme->menuTextSmall.font, menuTheme->menuTextSmall.color, ALIGN_RIGHT), false);
+		row.makeAcceptInputHandler([this, game] { goToGame(game); });
+		mMenu.addRow(row);
+	}
+}
+
+void GuiSearch::goToGame(FileData* game)
+{
+	// close everything first, menus may save options and refresh their own gamelist
+	Window* window = mWindow;
+	while (window->peekGui() && window->peekGui() != ViewController::get())
+		delete window->peekGui();
+
+	SystemData* system = game->getSystem();
+	ViewController::get()->goToGameList(system);
+	ViewController::get()->getGameListView(system)->setCursor(game);
+}
+
+bool GuiSearch::input(InputConfig* config, Input input)
+{
+	if (config->isMappedTo("a", input) && input.value != 0)
+	{
+		delete this;
+		return true;
+	}
+
+	if (config->isMappedTo("start", input) && input.value != 0)
+	{
+		// close everything
+		Window* window = mWindow;
+		while (window->peekGui() && window->peekGui() != ViewController::get())
+			delete window->peekGui();
+		return true;
+	}
+
+	return GuiComponent::input(config, input);
+}
+
+std::vector<HelpPrompt> GuiSearch::getHelpPrompts()
+{
+	std::vector<HelpPrompt> prompts = mMenu.getHelpPrompts();
+
+	prompts.push_back(HelpPrompt("a", _("BACK")));
+	prompts.push_back(HelpPrompt("start", _("CLOSE")));
+
+	return prompts;
+}
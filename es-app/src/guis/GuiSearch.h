@@ -0,0 +1,27 @@
+#pragma once
+
+#include "GuiComponent.h"
+#include "components/MenuComponent.h"
+
+class FileData;
+
+// Type-ahead search over the games of every system, backed by GameSearchIndex.
+// The keyboard title shows the match count while typing, the results are listed once validated.
+class GuiSearch : public GuiComponent
+{
+public:
+	GuiSearch(Window* window);
+
+	bool input(InputConfig* config, Input input) override;
+	std::vector<HelpPrompt> getHelpPrompts() override;
+
+private:
+	void openKeyboard();
+	void populate(const std::string& query);
+	void goToGame(FileData* game);
+
+	static std::string getCountTitle(const std::string& query);
+
+	MenuComponent mMenu;
+	std::string mQuery;
+};
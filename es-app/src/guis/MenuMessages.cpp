@@ -106,6 +106,7 @@ const char* MenuMessages::ADVANCED_EMU_EMU_HELP_MSG = "Select which emulator to
 const char* MenuMessages::ADVANCED_EMU_CORE_HELP_MSG = "Select which core to use for the selected emulator. For example, the LIBRETRO emulator has many cores to run Super Nintendo games. The default core you choose here can also be overridden in game specific settings.";
 
 const char* MenuMessages::GAMELISTOPTION_JUMP_LETTER_MSG = "Select a letter and the listing will go directly on the first game starting with this letter.";
+const char* MenuMessages::GAMELISTOPTION_SEARCH_GAMES_MSG = "Search a game in every system by name, developer or genre.";
 const char* MenuMessages::GAMELISTOPTION_SORT_GAMES_MSG = "Select the way the game list is sortered (alphabetically, by notation...).";
 const char* MenuMessages::GAMELISTOPTION_FAVORITES_ONLY_MSG = "Switch between seing or not only the favorites games. To add a game in the favorite list, select the game and toggle its state using 'Y'.";
 const char* MenuMessages::GAMELISTOPTION_SHOW_HIDDEN_MSG = "Switch between seing or not the hidden games. To hide a game, edit its data and select 'Hide'.";
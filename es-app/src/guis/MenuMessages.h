@@ -114,6 +114,7 @@ public:
 	static const char* ADVANCED_EMU_CORE_HELP_MSG;
 
 	static const char* GAMELISTOPTION_JUMP_LETTER_MSG;
+	static const char* GAMELISTOPTION_SEARCH_GAMES_MSG;
 	static const char* GAMELISTOPTION_SORT_GAMES_MSG;
 	static const char* GAMELISTOPTION_FAVORITES_ONLY_MSG;
 	static const char* GAMELISTOPTION_SHOW_HIDDEN_MSG;
@@ -81,8 +81,9 @@ bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height
 			bool vsync = (strcmp(argv[i + 1], "on") == 0 || strcmp(argv[i + 1], "1") == 0) ? true : false;
 			Settings::getInstance()->setBool("VSync", vsync);
 			i++; // skip vsync value
-		}else if(strcmp(argv[i], "--scrape") == 0)
+		}else if(strcmp(argv[i], "--scrape") == 0 || strcmp(argv[i], "--scrape-auto") == 0)
 		{
+			// the other --scrape-* options are read by the scraper
 			scrape_cmdline = true;
 		}else if(strcmp(argv[i], "--max-vram") == 0)
 		{
@@ -111,6 +112,14 @@ bool parseArgs(int argc, char* argv[], unsigned int* width, unsigned int* height
 				"--hide-systemview		show only gamelist view, no system view\n"
 				"--debug				more logging, show console on Windows\n"
 				"--scrape			scrape using command line interface\n"
+				"--scrape-auto			scrape without questions, progress is written as tab separated records\n"
+				"  --scrape-systems [a,b]	only these systems (default is all)\n"
+				"  --scrape-all			all games, not only the ones missing an image\n"
+				"  --scrape-accept [policy]	first (default), single (the only result) or exact (named like the file)\n"
+				"  --scrape-jobs [count]		systems scraped at once (default is 2)\n"
+				"  --scrape-checkpoint [file]	where an interrupted scrape is resumed from\n"
+				"  --scrape-restart		ignore the checkpoint\n"
+				"  --scrape-server [url]		screenscraper server, a local stand-in to measure throughput\n"
 				"--windowed			not fullscreen, should be used with --resolution\n"
 				"--vsync [1/on or 0/off]		turn vsync on or off (default is on)\n"
 				"--max-vram [size]		Max VRAM to use in Mb before swapping. 0 for unlimited\n"
@@ -377,7 +386,7 @@ int main(int argc, char* argv[])
 	//run the command line scraper then quit
 	if(scrape_cmdline)
 	{
-		return run_scraper_cmdline();
+		return run_scraper_cmdline(argc, argv);
 	}
 
 	//dont generate joystick events while we're loading (hopefully fixes "automatically started emulator" bug)
@@ -472,6 +481,9 @@ int main(int argc, char* argv[])
 			}
 		}
 
+		// the saves of this frame, in one write
+		RecalboxConf::getInstance()->update();
+
 		if(window.isSleeping())
 		{
 			lastTime = SDL_GetTicks();
@@ -494,6 +506,8 @@ int main(int argc, char* argv[])
 		Log::flush();
 	}
 
+	RecalboxConf::getInstance()->sync();
+
 	// Clean ready flag
 	if(fs::exists(ready_path)) fs::remove(ready_path);
 
@@ -501,6 +515,7 @@ int main(int argc, char* argv[])
 		delete window.peekGui();
 
 	window.renderShutdownScreen();
+	ViewController::get()->cancelPrebuiltGameLists();
 	SystemData::deleteSystems();
 	window.deinit();
 	LOG(LogInfo) << "EmulationStation cleanly shutting down.";
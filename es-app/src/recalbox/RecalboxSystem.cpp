@@ -232,6 +232,7 @@ bool RecalboxSystem::launchKodi(Window *window) {
 
     std::string commandline = InputManager::getInstance()->configureEmulators();
     std::string command = "configgen -system kodi -rom '' " + commandline;
+    RecalboxConf::getInstance()->sync();
 
     window->deinit();
 
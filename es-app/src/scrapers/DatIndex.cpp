@@ -0,0 +1,258 @@
+#include "scrapers/DatIndex.h"
+#include "resources/MappedFile.h"
+#include "pugixml/pugixml.hpp"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <stdlib.h>
+#include <string.h>
+
+namespace fs = boost::filesystem;
+
+#define INDEX_MAGIC		"ESDATIX1"
+
+DatIndex::DatIndex() : mData(NULL), mSize(0), mGames(NULL), mGameCount(0), mCrcs(NULL), mRomCount(0),
+	mNames(NULL), mNameCount(0), mStrings(NULL)
+{
+}
+
+DatIndex::~DatIndex()
+{
+}
+
+std::string DatIndex::normalizeName(const std::string& fileName)
+{
+	std::string name = fileName;
+	size_t slash = name.find_last_of("/\\");
+	if(slash != std::string::npos)
+		name = name.substr(slash + 1);
+	size_t dot = name.find_last_of('.');
+	if(dot != std::string::npos && dot > 0)
+		name = name.substr(0, dot);
+
+	for(auto it = name.begin(); it != name.end(); it++)
+		*it = (char)tolower((unsigned char)*it);
+	return name;
+}
+
+std::shared_ptr<DatIndex> DatIndex::open(const std::string& path)
+{
+	std::shared_ptr<DatIndex> index(new DatIndex());
+
+	index->mFile = MappedFile::open(path, sizeof(Header));
+	if(!index->mFile)
+		return nullptr;
+	index->mData = index->mFile->getData();
+	index->mSize = index->mFile->getSize();
+
+	// everything is checked once here, lookups then trust the index
+	const Header* header = (const Header*)index->mData;
+	if(memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0)
+		return nullptr;
+
+	const uint64_t crcsOffset = sizeof(Header) + (uint64_t)header->gameCount * sizeof(GameEntry);
+	const uint64_t namesOffset = crcsOffset + (uint64_t)header->romCount * sizeof(CrcEntry);
+	const uint64_t stringsOffset = namesOffset + (uint64_t)header->nameCount * sizeof(NameEntry);
+	if(stringsOffset + header->stringsSize != index->mSize || header->stringsSize == 0)
+		return nullptr;
+
+	index->mGameCount = header->gameCount;
+	index->mGames = (const GameEntry*)(index->mData + sizeof(Header));
+	index->mRomCount = header->romCount;
+	index->mCrcs = (const CrcEntry*)(index->mData + crcsOffset);
+	index->mNameCount = header->nameCount;
+	index->mNames = (const NameEntry*)(index->mData + namesOffset);
+	index->mStrings = (const char*)index->mData + stringsOffset;
+
+	const uint32_t stringsSize = header->stringsSize;
+	if(index->mStrings[stringsSize - 1] != '\0')
+		return nullptr;
+
+	for(uint32_t i = 0; i < index->mGameCount; i++)
+	{
+		const GameEntry& game = index->mGames[i];
+		if(game.name >= stringsSize || game.description >= stringsSize || game.year >= stringsSize ||
+			game.manufacturer >= stringsSize || game.players >= stringsSize)
+			return nullptr;
+	}
+	for(uint32_t i = 0; i < index->mRomCount; i++)
+	{
+		if(index->mCrcs[i].game >= index->mGameCount)
+			return nullptr;
+	}
+	for(uint32_t i = 0; i < index->mNameCount; i++)
+	{
+		if(index->mNames[i].game >= index->mGameCount || index->mNames[i].name >= stringsSize)
+			return nullptr;
+		// findByName searches them by dichotomy
+		if(i > 0 && strcmp(index->getString(index->mNames[i - 1].name), index->getString(index->mNames[i].name)) > 0)
+			return nullptr;
+	}
+
+	return index;
+}
+
+void DatIndex::getGame(uint32_t index, Game& game) const
+{
+	const GameEntry& entry = mGames[index];
+	game.name = getString(entry.name);
+	game.description = getString(entry.description);
+	game.year = getString(entry.year);
+	game.manufacturer = getString(entry.manufacturer);
+	game.players = getString(entry.players);
+}
+
+bool DatIndex::findByCrc(uint32_t crc, uint32_t size, Game& game) const
+{
+	const CrcEntry* end = mCrcs + mRomCount;
+	const CrcEntry* it = std::lower_bound(mCrcs, end, std::make_pair(crc, size), [](const CrcEntry& entry, const std::pair<uint32_t, uint32_t>& key)
+	{
+		return entry.crc < key.first || (entry.crc == key.first && entry.size < key.second);
+	});
+	if(it == end || it->crc != crc || it->size != size)
+		return false;
+
+	getGame(it->game, game);
+	return true;
+}
+
+bool DatIndex::findByName(const std::string& name, Game& game) const
+{
+	const std::string key = normalizeName(name);
+	const NameEntry* end = mNames + mNameCount;
+	const NameEntry* it = std::lower_bound(mNames, end, key, [this](const NameEntry& entry, const std::string& key)
+	{
+		return strcmp(getString(entry.name), key.c_str()) < 0;
+	});
+	if(it == end || key != getString(it->name))
+		return false;
+
+	getGame(it->game, game);
+	return true;
+}
+
+// The file of a multi-track disc that is scraped
+static bool isDiscDescriptor(const std::string& name)
+{
+	std::string extension = fs::path(name).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension == ".cue" || extension == ".gdi" || extension == ".ccd" || extension == ".m3u" || extension == ".chd";
+}
+
+bool DatIndex::write(const std::vector<std::string>& datFiles, const std::string& path, std::string& error)
+{
+	std::vector<GameEntry> games;
+	std::vector<CrcEntry> crcs;
+	std::vector<NameEntry> names;
+
+	// offset 0 is the empty string
+	std::string strings(1, '\0');
+	auto addString = [&strings](const std::string& value) -> uint32_t
+	{
+		if(value.empty())
+			return 0;
+		uint32_t offset = (uint32_t)strings.size();
+		strings += value;
+		strings += '\0';
+		return offset;
+	};
+
+	for(auto dat = datFiles.begin(); dat != datFiles.end(); dat++)
+	{
+		pugi::xml_document doc;
+		pugi::xml_parse_result result = doc.load_file(dat->c_str());
+		if(!result)
+		{
+			error = "can't read " + *dat + ": " + result.description();
+			return false;
+		}
+
+		for(pugi::xml_node node = doc.document_element().first_child(); node; node = node.next_sibling())
+		{
+			if(strcmp(node.name(), "game") != 0 && strcmp(node.name(), "machine") != 0)
+				continue;
+
+			const uint32_t gameIndex = (uint32_t)games.size();
+			const std::string name = node.attribute("name").value();
+			GameEntry game;
+			game.name = addString(name);
+			game.description = addString(node.child_value("description"));
+			game.year = addString(node.child_value("year"));
+			game.manufacturer = addString(node.child_value("manufacturer"));
+			game.players = addString(node.child("input").attribute("players").value());
+			games.push_back(game);
+
+			std::set<std::string> gameNames;
+			gameNames.insert(normalizeName(name));
+
+			const bool single = node.child("rom") && !node.child("rom").next_sibling("rom");
+			for(pugi::xml_node rom = node.child("rom"); rom; rom = rom.next_sibling("rom"))
+			{
+				const std::string romName = rom.attribute("name").value();
+				if(!single && !isDiscDescriptor(romName))
+					continue;
+
+				gameNames.insert(normalizeName(romName));
+				if(rom.attribute("crc"))
+				{
+					CrcEntry entry = { (uint32_t)strtoul(rom.attribute("crc").value(), NULL, 16), rom.attribute("size").as_uint(), gameIndex };
+					crcs.push_back(entry);
+				}
+			}
+
+			for(auto it = gameNames.begin(); it != gameNames.end(); it++)
+			{
+				if(it->empty())
+					continue;
+				NameEntry entry = { addString(*it), gameIndex };
+				names.push_back(entry);
+			}
+		}
+	}
+
+	std::stable_sort(crcs.begin(), crcs.end(), [](const CrcEntry& a, const CrcEntry& b)
+	{
+		return a.crc < b.crc || (a.crc == b.crc && a.size < b.size);
+	});
+	std::stable_sort(names.begin(), names.end(), [&strings](const NameEntry& a, const NameEntry& b)
+	{
+		return strcmp(strings.c_str() + a.name, strings.c_str() + b.name) < 0;
+	});
+
+	Header header;
+	memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+	header.gameCount = (uint32_t)games.size();
+	header.romCount = (uint32_t)crcs.size();
+	header.nameCount = (uint32_t)names.size();
+	header.stringsSize = (uint32_t)strings.size();
+
+	const std::string temporary = path + ".tmp";
+	std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+	stream.write((const char*)&header, sizeof(header));
+	if(!games.empty())
+		stream.write((const char*)&games[0], games.size() * sizeof(GameEntry));
+	if(!crcs.empty())
+		stream.write((const char*)&crcs[0], crcs.size() * sizeof(CrcEntry));
+	if(!names.empty())
+		stream.write((const char*)&names[0], names.size() * sizeof(NameEntry));
+	stream.write(strings.data(), strings.size());
+	stream.close();
+
+	boost::system::error_code ec;
+	if(stream.fail())
+	{
+		error = "can't write " + temporary;
+		fs::remove(temporary, ec);
+		return false;
+	}
+
+	fs::rename(temporary, path, ec);
+	if(ec)
+	{
+		error = "can't write " + path + ": " + ec.message();
+		fs::remove(temporary, ec);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+//
+// Game catalogues (No-Intro, Redump, MAME... XML DAT files) merged in a single file, mapped in memory once
+// and searched in place, so that the offline scraper identifies a whole library at disk speed.
+//
+// Layout, integers in little endian:
+//   header   "ESDATIX1", uint32 game count, uint32 rom count, uint32 name count, uint32 strings size
+//   games    game count x { uint32 name, description, year, manufacturer, players }, offsets in strings
+//   by crc   rom count x { uint32 crc, uint32 size, uint32 game }, sorted by crc then size
+//   by name  name count x { uint32 name, uint32 game }, sorted by name
+//   strings  nul-terminated
+//
+// Only the roms that identify a game are indexed: the rom of a single rom game, or the disc descriptor
+// (cue, gdi...) of a multi-track one. The parts of a MAME set, shared by many, are found by set name.
+// Names are lower case file names without extension.
+//
+// Indexes are built by the es-datindex tool.
+//
+class DatIndex
+{
+public:
+	struct Game
+	{
+		const char* name;			// set name, or No-Intro full name
+		const char* description;	// title, with region and flags
+		const char* year;
+		const char* manufacturer;
+		const char* players;
+	};
+
+	// nullptr if the file can't be mapped or is not a valid index
+	static std::shared_ptr<DatIndex> open(const std::string& path);
+
+	// Index the games of XML DAT files (datafile/game and mame/machine), written aside then renamed
+	static bool write(const std::vector<std::string>& datFiles, const std::string& path, std::string& error);
+
+	~DatIndex();
+
+	inline size_t getGameCount() const { return mGameCount; }
+
+	// A rom by its CRC-32 and size
+	bool findByCrc(uint32_t crc, uint32_t size, Game& game) const;
+	// A rom or set by its file name, extension and case ignored
+	bool findByName(const std::string& name, Game& game) const;
+
+	static std::string normalizeName(const std::string& fileName);
+
+private:
+	struct Header
+	{
+		char magic[8];
+		uint32_t gameCount;
+		uint32_t romCount;
+		uint32_t nameCount;
+		uint32_t stringsSize;
+	};
+
+	struct GameEntry
+	{
+		uint32_t name;
+		uint32_t description;
+		uint32_t year;
+		uint32_t manufacturer;
+		uint32_t players;
+	};
+
+	struct CrcEntry
+	{
+		uint32_t crc;
+		uint32_t size;
+		uint32_t game;
+	};
+
+	struct NameEntry
+	{
+		uint32_t name;
+		uint32_t game;
+	};
+
+	DatIndex();
+
+	void getGame(uint32_t index, Game& game) const;
+	inline const char* getString(uint32_t offset) const { return mStrings + offset; }
+
+	std::unique_ptr<MappedFile> mFile;
+	const unsigned char* mData;
+	size_t mSize;
+
+	const GameEntry* mGames;
+	uint32_t mGameCount;
+	const CrcEntry* mCrcs;
+	uint32_t mRomCount;
+	const NameEntry* mNames;
+	uint32_t mNameCount;
+	const char* mStrings;
+};
@@ -113,12 +113,11 @@ void thegamesdb_generate_scraper_requests(const ScraperSearchParams& params, std
 	}
 }
 
-void TheGamesDBRequest::process(const std::unique_ptr<HttpReq>& req, std::vector<ScraperSearchResult>& results)
+void TheGamesDBRequest::process(const std::string& content, std::vector<ScraperSearchResult>& results)
 {
-	assert(req->status() == HttpReq::REQ_SUCCESS);
 
 	pugi::xml_document doc;
-	pugi::xml_parse_result parseResult = doc.load(req->getContent().c_str());
+	pugi::xml_parse_result parseResult = doc.load(content.c_str());
 	if(!parseResult)
 	{
 		std::stringstream ss;
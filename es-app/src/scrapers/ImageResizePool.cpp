@@ -0,0 +1,160 @@
+#include "scrapers/ImageResizePool.h"
+#include "resources/ThumbnailCache.h"
+#include "Log.h"
+#include "Util.h"
+#include <FreeImage.h>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+
+namespace fs = boost::filesystem;
+
+ImageResizePool* ImageResizePool::sInstance = NULL;
+
+ImageResizePool* ImageResizePool::getInstance()
+{
+	if(sInstance == NULL)
+		sInstance = new ImageResizePool();
+
+	return sInstance;
+}
+
+ImageResizePool::ImageResizePool() : mWork(mIOService)
+{
+	// a core left to the main thread
+	unsigned int count = boost::thread::hardware_concurrency();
+	count = count > 2 ? count - 1 : 1;
+	for(unsigned int i = 0; i < count; i++)
+		mThreads.create_thread(boost::bind(&boost::asio::io_service::run, &mIOService));
+}
+
+std::shared_ptr<ImageResizeJob> ImageResizePool::resize(const std::shared_ptr<HttpReq>& request, const std::string& path, int maxWidth, int maxHeight)
+{
+	std::shared_ptr<ImageResizeJob> job(new ImageResizeJob());
+	mIOService.post([request, path, maxWidth, maxHeight, job]
+	{
+		process(request, path, maxWidth, maxHeight, *job);
+		job->done = true;
+	});
+	return job;
+}
+
+// Write aside then rename, a file is never seen half written
+static bool saveFile(const std::string& path, const void* data, size_t size, ImageResizeJob& job)
+{
+	// unique, workers may save the same media at once
+	boost::system::error_code ec;
+	const std::string temporary = fs::unique_path(path + ".%%%%-%%%%.tmp", ec).string();
+	std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+	stream.write((const char*)data, size);
+	stream.close();
+
+	if(ec || stream.fail())
+	{
+		fs::remove(temporary, ec);
+		job.error = "Failed to save image. Disk full?";
+		return false;
+	}
+
+	fs::rename(temporary, path, ec);
+	if(ec)
+	{
+		fs::remove(temporary, ec);
+		job.error = "Failed to save image: " + ec.message();
+		return false;
+	}
+
+	job.crc = crc32(0, data, size);
+	job.size = size;
+	return true;
+}
+
+static void saveThumbnails(FIBITMAP* image, const std::string& path)
+{
+	std::vector<unsigned int> resolutions = ThumbnailCache::getDisplayedResolutions();
+	for(auto resolution : resolutions)
+		ThumbnailCache::store(path, image, resolution);
+}
+
+void ImageResizePool::process(const std::shared_ptr<HttpReq>& request, const std::string& path, int maxWidth, int maxHeight, ImageResizeJob& job)
+{
+	const std::string& content = request->getContent();
+
+	// nothing to do
+	if(maxWidth == 0 && maxHeight == 0)
+	{
+		job.success = saveFile(path, content.data(), content.size(), job);
+		return;
+	}
+
+	FIMEMORY* memory = FreeImage_OpenMemory((BYTE*)content.data(), (DWORD)content.size());
+	FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(memory, 0);
+	if(format == FIF_UNKNOWN)
+		format = FreeImage_GetFIFFromFilename(path.c_str());
+	if(format == FIF_UNKNOWN || !FreeImage_FIFSupportsReading(format))
+	{
+		FreeImage_CloseMemory(memory);
+		LOG(LogError) << "Error - could not read image downloaded for \"" << path << "\"!";
+		job.error = "Unsupported image format";
+		return;
+	}
+
+	FIBITMAP* image = FreeImage_LoadFromMemory(format, memory);
+	FreeImage_CloseMemory(memory);
+	if(image == NULL)
+	{
+		job.error = "Invalid image";
+		return;
+	}
+
+	float width = (float)FreeImage_GetWidth(image);
+	float height = (float)FreeImage_GetHeight(image);
+
+	if(maxWidth == 0)
+	{
+		maxWidth = (int)((maxHeight / height) * width);
+	}else if(maxHeight == 0)
+	{
+		maxHeight = (int)((maxWidth / width) * height);
+	}
+
+	// small enough, saved as downloaded rather than scaled up and encoded again
+	if(width <= maxWidth && height <= maxHeight)
+	{
+		job.success = saveFile(path, content.data(), content.size(), job);
+		if(job.success)
+			saveThumbnails(image, path);
+		FreeImage_Unload(image);
+		return;
+	}
+
+	FIBITMAP* imageRescaled = FreeImage_Rescale(image, maxWidth, maxHeight, FILTER_BILINEAR);
+	FreeImage_Unload(image);
+
+	if(imageRescaled == NULL)
+	{
+		LOG(LogError) << "Could not resize image! (not enough memory? invalid bitdepth?)";
+		job.error = "Error resizing image. Out of memory?";
+		return;
+	}
+
+	if(!FreeImage_FIFSupportsWriting(format))
+		format = FIF_PNG;
+
+	// encoded in memory, so that it is hashed as it is written
+	FIMEMORY* encoded = FreeImage_OpenMemory();
+	BYTE* data = NULL;
+	DWORD size = 0;
+	if(FreeImage_SaveToMemory(format, imageRescaled, encoded) && FreeImage_AcquireMemory(encoded, &data, &size))
+		job.success = saveFile(path, data, size, job);
+	else
+		job.error = "Error encoding resized image";
+
+	// after the image, a thumbnail older than its image is rebuilt
+	if(job.success)
+		saveThumbnails(imageRescaled, path);
+
+	FreeImage_CloseMemory(encoded);
+	FreeImage_Unload(imageRescaled);
+}
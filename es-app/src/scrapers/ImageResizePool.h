@@ -0,0 +1,48 @@
+#pragma once
+
+#include "HttpReq.h"
+#include <boost/asio/io_service.hpp>
+#include <boost/thread.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+
+// Result of an image handed to the pool, to be polled by its owner
+struct ImageResizeJob
+{
+	ImageResizeJob() : done(false), success(false), crc(0), size(0) {}
+
+	// the other fields are set once done
+	std::atomic<bool> done;
+	bool success;
+	std::string error;
+	// of the file saved
+	unsigned int crc;
+	size_t size;
+};
+
+//
+// Resizes scraped images on worker threads, so that a batch scrape doesn't stall the main thread.
+// The downloaded buffer is decoded once from memory, scaled down to the size asked and to the
+// thumbnails the grids display (stored straight in the ThumbnailCache), encoded once, and written
+// to disk once. An image small enough already is written as downloaded.
+//
+class ImageResizePool
+{
+public:
+	static ImageResizePool* getInstance();
+
+	// Save the content of a successful request to path, scaled down to fit maxWidth x maxHeight
+	// (0 for either keeps the aspect ratio, 0 for both keeps the image as is).
+	std::shared_ptr<ImageResizeJob> resize(const std::shared_ptr<HttpReq>& request, const std::string& path, int maxWidth, int maxHeight);
+
+private:
+	ImageResizePool();
+	static ImageResizePool* sInstance;
+
+	static void process(const std::shared_ptr<HttpReq>& request, const std::string& path, int maxWidth, int maxHeight, ImageResizeJob& job);
+
+	boost::asio::io_service mIOService;
+	boost::asio::io_service::work mWork;
+	boost::thread_group mThreads;
+};
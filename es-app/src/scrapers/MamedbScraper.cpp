@@ -28,14 +28,13 @@ boost::regex infolineregex("^.*?<h1>Game Details</h1>(.*?)</table>.*$");
         boost::regex playersregex("^.*?<b>Players:&nbsp;</b>(?<players>.*?)<br/>.*$");
         boost::regex snapregex("^.*?<img src='/snap/(?<img>.*?)\\.png'.*$");
         
-void MamedbRequest::process(const std::unique_ptr<HttpReq>& req, std::vector<ScraperSearchResult>& results)
+void MamedbRequest::process(const std::string& content, std::vector<ScraperSearchResult>& results)
 {
-	assert(req->status() == HttpReq::REQ_SUCCESS);
   
         
 
         boost::smatch infolinematches;
-        if (boost::regex_match(req->getContent(), infolinematches, infolineregex)){
+        if (boost::regex_match(content, infolinematches, infolineregex)){
             
             boost::smatch linematches;
             std::string line(infolinematches[1]);
@@ -63,7 +62,7 @@ void MamedbRequest::process(const std::unique_ptr<HttpReq>& req, std::vector<Scr
                 
                 //RATING
                 boost::smatch scorematches;
-                if (boost::regex_match(req->getContent(), scorematches, scoreregex)){
+                if (boost::regex_match(content, scorematches, scoreregex)){
                     float score = 0;
                     std::stringstream ( std::string(scorematches["rating"]) ) >> score;
                     score = score / 10.0f;
@@ -79,7 +78,7 @@ void MamedbRequest::process(const std::unique_ptr<HttpReq>& req, std::vector<Scr
                 // IMAGES
                 boost::smatch snapmatches;
                 std::stringstream ss;
-                if(boost::regex_match(req->getContent(), snapmatches, snapregex)){
+                if(boost::regex_match(content, snapmatches, snapregex)){
                     ss << "mamedb.blu-ferret.co.uk/snap/"<<std::string(snapmatches["img"]) <<".png";
                     result.imageUrl = ss.str();
                     result.thumbnailUrl = ss.str();
@@ -88,7 +87,7 @@ void MamedbRequest::process(const std::unique_ptr<HttpReq>& req, std::vector<Scr
                 results.push_back(result);
             }
         }else {
-            LOG(LogInfo) << req->getContent().c_str();
+            LOG(LogInfo) << content.c_str();
             LOG(LogInfo) << titleregex.str() << "\nNot found";
             
         }
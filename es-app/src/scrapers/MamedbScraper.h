@@ -12,5 +12,5 @@ class MamedbRequest : public ScraperHttpRequest
 public:
 	MamedbRequest(std::vector<ScraperSearchResult>& resultsWrite, const std::string& url) : ScraperHttpRequest(resultsWrite, url) {}
 protected:
-	void process(const std::unique_ptr<HttpReq>& req, std::vector<ScraperSearchResult>& results) override;
+	void process(const std::string& content, std::vector<ScraperSearchResult>& results) override;
 };
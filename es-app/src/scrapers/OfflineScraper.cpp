@@ -0,0 +1,278 @@
+#include "scrapers/OfflineScraper.h"
+#include "scrapers/DatIndex.h"
+#include "Log.h"
+#include "Util.h"
+#include "platform.h"
+#include <boost/filesystem.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include <ctype.h>
+#include <string.h>
+
+namespace fs = boost::filesystem;
+
+// larger roms (disc images) are found by name, reading them all would take longer than it's worth
+#define MAX_HASHED_FILE_SIZE	(32 * 1024 * 1024)
+// the requests of a batch share a single check of the index file
+#define INDEX_CHECK_INTERVAL	std::chrono::seconds(5)
+
+struct RomHash
+{
+	RomHash() : done(false), valid(false), crc(0), size(0) {}
+
+	std::atomic<bool> done;
+	bool valid;
+	uint32_t crc;
+	uint32_t size;
+};
+
+static std::string getOfflineDirectory()
+{
+	return getHomePath() + "/.emulationstation/offline";
+}
+
+// The index, opened again when es-datindex rebuilt it
+static std::shared_ptr<DatIndex> getIndex()
+{
+	static std::mutex mutex;
+	static std::shared_ptr<DatIndex> index;
+	static std::time_t indexTime = 0;
+	static std::chrono::steady_clock::time_point checkTime;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if(index && now - checkTime < INDEX_CHECK_INTERVAL)
+		return index;
+	checkTime = now;
+
+	const std::string path = getOfflineDirectory() + "/dats.idx";
+	boost::system::error_code ec;
+	std::time_t time = fs::last_write_time(path, ec);
+	if(ec)
+	{
+		index.reset();
+		return nullptr;
+	}
+
+	if(!index || time != indexTime)
+	{
+		index = DatIndex::open(path);
+		indexTime = time;
+		if(index)
+			LOG(LogInfo) << "Offline scraper: " << index->getGameCount() << " games in " << path;
+		else
+			LOG(LogError) << "Offline scraper: invalid index " << path;
+	}
+	return index;
+}
+
+static inline uint32_t readLE(const unsigned char* data, int bytes)
+{
+	uint32_t value = 0;
+	for(int i = bytes - 1; i >= 0; i--)
+		value = (value << 8) | data[i];
+	return value;
+}
+
+// The CRC of the file in a single file zip, read from its central directory
+static bool getZipCrc(const std::string& path, uint32_t& crc, uint32_t& size)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if(!stream)
+		return false;
+	stream.seekg(0, stream.end);
+	const std::streamoff fileSize = stream.tellg();
+	if(fileSize <= 0)
+		return false;
+
+	// the end of central directory record is followed by a comment of up to 64KB
+	const std::streamoff tailSize = std::min(fileSize, (std::streamoff)(22 + 0xFFFF));
+	std::vector<unsigned char> tail((size_t)tailSize);
+	stream.seekg(fileSize - tailSize);
+	if(tail.empty() || !stream.read((char*)&tail[0], tailSize))
+		return false;
+
+	for(std::streamoff i = tailSize - 22; i >= 0; i--)
+	{
+		const unsigned char* record = &tail[(size_t)i];
+		if(readLE(record, 4) != 0x06054b50)
+			continue;
+
+		if(readLE(record + 10, 2) != 1)
+			return false;
+		const uint32_t directoryOffset = readLE(record + 16, 4);
+
+		unsigned char entry[46];
+		stream.seekg(directoryOffset);
+		if(!stream.read((char*)entry, sizeof(entry)) || readLE(entry, 4) != 0x02014b50)
+			return false;
+
+		crc = readLE(entry + 16, 4);
+		size = readLE(entry + 24, 4);
+		return true;
+	}
+	return false;
+}
+
+static bool getRomCrc(const std::string& path, uint32_t& crc, uint32_t& size)
+{
+	std::string extension = fs::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	if(extension == ".zip")
+		return getZipCrc(path, crc, size);
+
+	boost::system::error_code ec;
+	const uintmax_t fileSize = fs::file_size(path, ec);
+	if(ec || fileSize > MAX_HASHED_FILE_SIZE)
+		return false;
+
+	std::ifstream stream(path, std::ios::binary);
+	if(!stream)
+		return false;
+
+	crc = 0;
+	char buffer[64 * 1024];
+	while(stream)
+	{
+		stream.read(buffer, sizeof(buffer));
+		crc = crc32(crc, buffer, (size_t)stream.gcount());
+	}
+	size = (uint32_t)fileSize;
+	return true;
+}
+
+// A single thread: hashing is bound by the disk, never destroyed as requests may outlive the scrape
+static boost::asio::io_service& getHashService()
+{
+	static boost::asio::io_service* service = []()
+	{
+		boost::asio::io_service* service = new boost::asio::io_service();
+		new boost::asio::io_service::work(*service);
+		boost::thread(boost::bind(&boost::asio::io_service::run, service)).detach();
+		return service;
+	}();
+	return *service;
+}
+
+// "Super Mario Bros. (World) [b]" -> "Super Mario Bros."
+static std::string getTitle(const std::string& description)
+{
+	size_t end = description.find_first_of("([");
+	if(end == std::string::npos)
+		end = description.size();
+	while(end > 0 && description[end - 1] == ' ')
+		end--;
+	return end > 0 ? description.substr(0, end) : description;
+}
+
+static std::string findMedia(const std::string& system, const DatIndex::Game& game)
+{
+	const std::string directory = getOfflineDirectory() + "/media/" + system;
+	const char* names[] = { game.description, game.name };
+	const char* extensions[] = { ".png", ".jpg" };
+	const char* subdirectories[] = { "/", "/Named_Boxarts/" };
+
+	boost::system::error_code ec;
+	for(int n = 0; n < 2; n++)
+	{
+		// the characters libretro thumbnails replace in file names
+		std::string name = names[n];
+		for(auto it = name.begin(); it != name.end(); it++)
+			if(strchr("&*/:`<>?\\|\"", *it) != NULL)
+				*it = '_';
+		if(name.empty())
+			continue;
+
+		for(int s = 0; s < 2; s++)
+			for(int e = 0; e < 2; e++)
+			{
+				const std::string path = directory + subdirectories[s] + name + extensions[e];
+				if(fs::exists(path, ec))
+					return path;
+			}
+	}
+	return "";
+}
+
+void offline_generate_scraper_requests(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests,
+	std::vector<ScraperSearchResult>& results)
+{
+	requests.push(std::unique_ptr<ScraperRequest>(new OfflineScraperRequest(results, params)));
+}
+
+OfflineScraperRequest::OfflineScraperRequest(std::vector<ScraperSearchResult>& resultsWrite, const ScraperSearchParams& params)
+	: ScraperRequest(resultsWrite), mParams(params)
+{
+	setStatus(ASYNC_IN_PROGRESS);
+}
+
+void OfflineScraperRequest::update()
+{
+	if(mStatus != ASYNC_IN_PROGRESS)
+		return;
+
+	if(!mIndex)
+	{
+		mIndex = getIndex();
+		if(!mIndex)
+		{
+			setError("No offline index, build " + getOfflineDirectory() + "/dats.idx with es-datindex");
+			return;
+		}
+		if(mParams.nameOverride.empty())
+			startHash();
+	}
+
+	if(mHash && !mHash->done)
+		return;
+
+	finish(*mIndex);
+}
+
+void OfflineScraperRequest::startHash()
+{
+	std::shared_ptr<RomHash> hash = std::make_shared<RomHash>();
+	const std::string path = mParams.game->getPath().generic_string();
+	getHashService().post([hash, path]()
+	{
+		hash->valid = getRomCrc(path, hash->crc, hash->size);
+		hash->done = true;
+	});
+	mHash = hash;
+}
+
+void OfflineScraperRequest::finish(const DatIndex& index)
+{
+	DatIndex::Game game;
+	bool found = false;
+	if(mParams.nameOverride.empty())
+	{
+		found = mHash->valid && index.findByCrc(mHash->crc, mHash->size, game);
+		if(!found)
+			found = index.findByName(mParams.game->getPath().generic_string(), game);
+	}else{
+		found = index.findByName(mParams.nameOverride, game);
+	}
+
+	setStatus(ASYNC_DONE);
+	if(!found)
+		return;
+
+	ScraperSearchResult result;
+	result.mdl.set("name", getTitle(game.description[0] != '\0' ? game.description : game.name));
+	if(strlen(game.year) == 4 && isdigit((unsigned char)game.year[0]))
+		result.mdl.setTime("releasedate", string_to_ptime(std::string(game.year) + "0101T000000"));
+	if(game.manufacturer[0] != '\0')
+		result.mdl.set("developer", game.manufacturer);
+	if(game.players[0] != '\0')
+		result.mdl.set("players", game.players);
+	result.imageUrl = findMedia(mParams.system->getName(), game);
+
+	mResults.push_back(result);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "scrapers/Scraper.h"
+
+// Identifies games from local catalogues, without any network: see DatIndex and the es-datindex tool.
+// Images are taken from media packs, ~/.emulationstation/offline/media/<system>/<game name>.png (or .jpg,
+// or in a Named_Boxarts subdirectory, as libretro thumbnails are laid out).
+void offline_generate_scraper_requests(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests,
+	std::vector<ScraperSearchResult>& results);
+
+class DatIndex;
+struct RomHash;
+
+class OfflineScraperRequest : public ScraperRequest
+{
+public:
+	OfflineScraperRequest(std::vector<ScraperSearchResult>& resultsWrite, const ScraperSearchParams& params);
+	void update() override;
+
+private:
+	// roms are hashed on a worker thread, update() only polls
+	void startHash();
+	void finish(const DatIndex& index);
+
+	ScraperSearchParams mParams;
+	std::shared_ptr<DatIndex> mIndex;
+	std::shared_ptr<RomHash> mHash;
+};
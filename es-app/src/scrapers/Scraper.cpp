@@ -1,18 +1,27 @@
 #include "scrapers/Scraper.h"
+#include "scrapers/ScraperCache.h"
+#include "scrapers/ImageResizePool.h"
 #include "Log.h"
 #include "Settings.h"
-#include <FreeImage.h>
 #include <boost/filesystem.hpp>
 #include <boost/assign.hpp>
 
 #include "GamesDBScraper.h"
 #include "MamedbScraper.h"
 #include "ScreenscraperScraper.h"
+#include "OfflineScraper.h"
 
 const std::map<std::string, generate_scraper_requests_func> scraper_request_funcs = boost::assign::map_list_of
 	("TheGamesDB", &thegamesdb_generate_scraper_requests)
 	("Mamedb", &mamedb_generate_scraper_requests)
-	("Screenscraper", &screenscraper_generate_scraper_requests);
+	("Screenscraper", &screenscraper_generate_scraper_requests)
+	("Offline", &offline_generate_scraper_requests);
+
+const std::map<std::string, ScraperLimits> scraper_limits = boost::assign::map_list_of
+	("TheGamesDB", ScraperLimits { 2, 1.0f, 2 })
+	("Mamedb", ScraperLimits { 2, 1.0f, 2 })
+	("Screenscraper", ScraperLimits { 4, 4.0f, 8 })
+	("Offline", ScraperLimits { 8, 1000.0f, 1000 });
 
 std::unique_ptr<ScraperSearchHandle> startScraperSearch(const ScraperSearchParams& params)
 {
@@ -20,6 +29,16 @@ std::unique_ptr<ScraperSearchHandle> startScraperSearch(const ScraperSearchParam
 
 	std::unique_ptr<ScraperSearchHandle> handle(new ScraperSearchHandle());
 	scraper_request_funcs.at(name)(params, handle->mRequestQueue, handle->mResults);
+
+	// the queue can only be walked around
+	for(size_t i = 0; i < handle->mRequestQueue.size(); i++)
+	{
+		std::unique_ptr<ScraperRequest> request = std::move(handle->mRequestQueue.front());
+		handle->mRequestQueue.pop();
+		if(request->isNetworkRequest())
+			handle->mNetworkRequestCount++;
+		handle->mRequestQueue.push(std::move(request));
+	}
 	return handle;
 }
 
@@ -34,8 +53,18 @@ std::vector<std::string> getScraperList()
 	return list;
 }
 
+ScraperLimits getScraperLimits()
+{
+	ScraperLimits limits = scraper_limits.at(Settings::getInstance()->getString("Scraper"));
+
+	int threads = Settings::getInstance()->getInt("ScraperThreads");
+	if(threads > 0)
+		limits.maxGames = threads;
+	return limits;
+}
+
 // ScraperSearchHandle
-ScraperSearchHandle::ScraperSearchHandle()
+ScraperSearchHandle::ScraperSearchHandle() : mNetworkRequestCount(0)
 {
 	setStatus(ASYNC_IN_PROGRESS);
 }
@@ -70,6 +99,7 @@ void ScraperSearchHandle::update()
 		}
 
 		// status == ASYNC_IN_PROGRESS
+		break;
 	}
 
 	// we finished without any errors!
@@ -90,19 +120,36 @@ ScraperRequest::ScraperRequest(std::vector<ScraperSearchResult>& resultsWrite) :
 
 // ScraperHttpRequest
 ScraperHttpRequest::ScraperHttpRequest(std::vector<ScraperSearchResult>& resultsWrite, const std::string& url) 
-	: ScraperRequest(resultsWrite)
+	: ScraperRequest(resultsWrite), mUrl(url)
 {
 	setStatus(ASYNC_IN_PROGRESS);
-	mReq = std::unique_ptr<HttpReq>(new HttpReq(url));
+	// a cached response is processed on the first update, process() can't be called from here
+	if(!ScraperCache::getInstance()->get(url, mCachedContent))
+		mReq = std::unique_ptr<HttpReq>(new HttpReq(url));
 }
 
 void ScraperHttpRequest::update()
 {
+	// processed once
+	if(mStatus != ASYNC_IN_PROGRESS)
+		return;
+
+	if(!mReq)
+	{
+		setStatus(ASYNC_DONE);
+		process(mCachedContent, mResults);
+		return;
+	}
+
 	HttpReq::Status status = mReq->status();
 	if(status == HttpReq::REQ_SUCCESS)
 	{
 		setStatus(ASYNC_DONE); // if process() has an error, status will be changed to ASYNC_ERROR
-		process(mReq, mResults);
+		process(mReq->getContent(), mResults);
+
+		// only a response that could be processed, not an error page
+		if(mStatus == ASYNC_DONE)
+			ScraperCache::getInstance()->put(mUrl, mReq->getContent());
 		return;
 	}
 
@@ -125,9 +172,26 @@ std::unique_ptr<MDResolveHandle> resolveMetaDataAssets(const ScraperSearchResult
 
 MDResolveHandle::MDResolveHandle(const ScraperSearchResult& result, const ScraperSearchParams& search) : mResult(result)
 {
+	// offline media packs are used in place
+	if(!result.imageUrl.empty() && !HttpReq::isUrl(result.imageUrl))
+	{
+		mResult.mdl.set("image", result.imageUrl);
+		mResult.imageUrl = "";
+		return;
+	}
+
 	if(!result.imageUrl.empty())
 	{
 		std::string imgPath = getSaveAsPath(search, "image", result.imageUrl);
+
+		// downloaded there before, and left as it was
+		if(ScraperCache::getInstance()->hasMedia(result.imageUrl, imgPath))
+		{
+			mResult.mdl.set("image", imgPath);
+			mResult.imageUrl = "";
+			return;
+		}
+
 		mFuncs.push_back(ResolvePair(downloadImageAsync(result.imageUrl, imgPath), [this, imgPath]
 		{
 			mResult.mdl.set("image", imgPath);
@@ -167,108 +231,57 @@ std::unique_ptr<ImageDownloadHandle> downloadImageAsync(const std::string& url,
 		Settings::getInstance()->getInt("ScraperResizeWidth"), Settings::getInstance()->getInt("ScraperResizeHeight")));
 }
 
+// Kept in memory when it is to be resized, the file is then written once by the pool.
+// Saved as is otherwise: streamed to the file, and resumed next time if interrupted.
 ImageDownloadHandle::ImageDownloadHandle(const std::string& url, const std::string& path, int maxWidth, int maxHeight) : 
-	mSavePath(path), mMaxWidth(maxWidth), mMaxHeight(maxHeight), mReq(new HttpReq(url))
+	mReq(maxWidth == 0 && maxHeight == 0 ? new HttpReq(url, path) : new HttpReq(url)), mUrl(url), mSavePath(path), mMaxWidth(maxWidth), mMaxHeight(maxHeight)
 {
 }
 
 void ImageDownloadHandle::update()
 {
-	if(mReq->status() == HttpReq::REQ_IN_PROGRESS)
+	if(mStatus != ASYNC_IN_PROGRESS)
 		return;
 
-	if(mReq->status() != HttpReq::REQ_SUCCESS)
+	// being resized and saved by the pool
+	if(mJob)
 	{
-		std::stringstream ss;
-		ss << "Network error: " << mReq->getErrorMsg();
-		setError(ss.str());
-		return;
-	}
+		if(!mJob->done)
+			return;
 
-	// download is done, save it to disk
-	std::ofstream stream(mSavePath, std::ios_base::out | std::ios_base::binary);
-	if(stream.bad())
-	{
-		setError("Failed to open image path to write. Permission error? Disk full?");
-		return;
-	}
+		if(!mJob->success)
+		{
+			setError(mJob->error);
+			return;
+		}
 
-	const std::string& content = mReq->getContent();
-	stream.write(content.data(), content.length());
-	stream.close();
-	if(stream.bad())
-	{
-		setError("Failed to save image. Disk full?");
+		ScraperCache::getInstance()->putMedia(mUrl, mSavePath, mJob->crc, mJob->size);
+		setStatus(ASYNC_DONE);
 		return;
 	}
 
-	// resize it
-	if(!resizeImage(mSavePath, mMaxWidth, mMaxHeight))
-	{
-		setError("Error saving resized image. Out of memory? Disk full?");
+	if(mReq->status() == HttpReq::REQ_IN_PROGRESS)
 		return;
-	}
-
-	setStatus(ASYNC_DONE);
-}
-
-//you can pass 0 for width or height to keep aspect ratio
-bool resizeImage(const std::string& path, int maxWidth, int maxHeight)
-{
-	// nothing to do
-	if(maxWidth == 0 && maxHeight == 0)
-		return true;
-
-	FREE_IMAGE_FORMAT format = FIF_UNKNOWN;
-	FIBITMAP* image = NULL;
-	
-	//detect the filetype
-	format = FreeImage_GetFileType(path.c_str(), 0);
-	if(format == FIF_UNKNOWN)
-		format = FreeImage_GetFIFFromFilename(path.c_str());
-	if(format == FIF_UNKNOWN)
-	{
-		LOG(LogError) << "Error - could not detect filetype for image \"" << path << "\"!";
-		return false;
-	}
-
-	//make sure we can read this filetype first, then load it
-	if(FreeImage_FIFSupportsReading(format))
-	{
-		image = FreeImage_Load(format, path.c_str());
-	}else{
-		LOG(LogError) << "Error - file format reading not supported for image \"" << path << "\"!";
-		return false;
-	}
 
-	float width = (float)FreeImage_GetWidth(image);
-	float height = (float)FreeImage_GetHeight(image);
-
-	if(maxWidth == 0)
-	{
-		maxWidth = (int)((maxHeight / height) * width);
-	}else if(maxHeight == 0)
+	if(mReq->status() != HttpReq::REQ_SUCCESS)
 	{
-		maxHeight = (int)((maxWidth / width) * height);
+		std::stringstream ss;
+		ss << "Network error: " << mReq->getErrorMsg();
+		setError(ss.str());
+		return;
 	}
 
-	FIBITMAP* imageRescaled = FreeImage_Rescale(image, maxWidth, maxHeight, FILTER_BILINEAR);
-	FreeImage_Unload(image);
-
-	if(imageRescaled == NULL)
+	// streamed, the CRC was computed as the file was written
+	if(mMaxWidth == 0 && mMaxHeight == 0)
 	{
-		LOG(LogError) << "Could not resize image! (not enough memory? invalid bitdepth?)";
-		return false;
+		ScraperCache::getInstance()->putMedia(mUrl, mSavePath, mReq->getCrc32(), mReq->getDownloadedSize());
+		mReq.reset();
+		setStatus(ASYNC_DONE);
+		return;
 	}
 
-	bool saved = FreeImage_Save(format, imageRescaled, path.c_str());
-	FreeImage_Unload(imageRescaled);
-
-    if(!saved) {
-		LOG(LogError) << "Failed to save resized image!";
-    }
-
-	return saved;
+	// the downloaded buffer goes to the pool as is
+	mJob = ImageResizePool::getInstance()->resize(std::shared_ptr<HttpReq>(std::move(mReq)), mSavePath, mMaxWidth, mMaxHeight);
 }
 
 std::string getSaveAsPath(const ScraperSearchParams& params, const std::string& suffix, const std::string& url)
@@ -10,6 +10,8 @@
 
 #define MAX_SCRAPER_RESULTS 7
 
+struct ImageResizeJob;
+
 struct ScraperSearchParams
 {
 	SystemData* system;
@@ -62,6 +64,8 @@ public:
 
 	// returns "true" once we're done
 	virtual void update() = 0;
+	// false if the request is answered without querying the provider
+	virtual bool isNetworkRequest() const { return false; }
 	
 protected:
 	std::vector<ScraperSearchResult>& mResults;
@@ -69,17 +73,22 @@ protected:
 
 
 // a single HTTP request that needs to be processed to get the results
+// responses are kept in the ScraperCache, a request answered before is processed without querying the provider
 class ScraperHttpRequest : public ScraperRequest
 {
 public:
 	ScraperHttpRequest(std::vector<ScraperSearchResult>& resultsWrite, const std::string& url);
 	virtual void update() override;
+	virtual bool isNetworkRequest() const override { return mReq != nullptr; }
 
 protected:
-	virtual void process(const std::unique_ptr<HttpReq>& req, std::vector<ScraperSearchResult>& results) = 0;
+	virtual void process(const std::string& content, std::vector<ScraperSearchResult>& results) = 0;
 
 private:
+	std::string mUrl;
+	// null when the response is cached
 	std::unique_ptr<HttpReq> mReq;
+	std::string mCachedContent;
 };
 
 // a request to get a list of results
@@ -90,12 +99,15 @@ public:
 
 	void update();
 	inline const std::vector<ScraperSearchResult>& getResults() const { assert(mStatus != ASYNC_IN_PROGRESS); return mResults; }
+	// requests sent to the provider when the search was started, not answered by the ScraperCache
+	inline size_t getNetworkRequestCount() const { return mNetworkRequestCount; }
 
 protected:
 	friend std::unique_ptr<ScraperSearchHandle> startScraperSearch(const ScraperSearchParams& params);
 
 	std::queue< std::unique_ptr<ScraperRequest> > mRequestQueue;
 	std::vector<ScraperSearchResult> mResults;
+	size_t mNetworkRequestCount;
 };
 
 // will use the current scraper settings to pick the result source
@@ -104,6 +116,17 @@ std::unique_ptr<ScraperSearchHandle> startScraperSearch(const ScraperSearchParam
 // returns a list of valid scraper names
 std::vector<std::string> getScraperList();
 
+// What a scraper provider accepts from one client
+struct ScraperLimits
+{
+	int maxGames;				// games scraped at once (screenscraper gives each account a number of threads)
+	float requestsPerSecond;	// sustained request rate
+	int burst;					// requests allowed at once after a pause
+};
+
+// limits of the current scraper, the "ScraperThreads" setting overrides its number of games at once
+ScraperLimits getScraperLimits();
+
 typedef void (*generate_scraper_requests_func)(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests, std::vector<ScraperSearchResult>& results);
 
 // -------------------------------------------------------------------------
@@ -118,6 +141,8 @@ public:
 
 	void update() override;
 	inline const ScraperSearchResult& getResult() const { assert(mStatus == ASYNC_DONE); return mResult; }
+	// media still downloading, those found in the ScraperCache are not
+	inline size_t getDownloadCount() const { return mFuncs.size(); }
 
 private:
 	ScraperSearchResult mResult;
@@ -135,6 +160,9 @@ public:
 
 private:
 	std::unique_ptr<HttpReq> mReq;
+	// once downloaded
+	std::shared_ptr<ImageResizeJob> mJob;
+	std::string mUrl;
 	std::string mSavePath;
 	int mMaxWidth;
 	int mMaxHeight;
@@ -149,8 +177,3 @@ std::unique_ptr<ImageDownloadHandle> downloadImageAsync(const std::string& url,
 
 // Resolves all metadata assets that need to be downloaded.
 std::unique_ptr<MDResolveHandle> resolveMetaDataAssets(const ScraperSearchResult& result, const ScraperSearchParams& search);
-
-//You can pass 0 for maxWidth or maxHeight to automatically keep the aspect ratio.
-//Will overwrite the image at [path] with the new resized one.
-//Returns true if successful, false otherwise.
-bool resizeImage(const std::string& path, int maxWidth, int maxHeight);
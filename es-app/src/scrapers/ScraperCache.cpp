@@ -0,0 +1,202 @@
+#include "scrapers/ScraperCache.h"
+#include "Log.h"
+#include "Settings.h"
+#include "Util.h"
+#include "platform.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+#define MEDIA_KEY_PREFIX	"media "
+
+ScraperCache* ScraperCache::sInstance = NULL;
+
+ScraperCache* ScraperCache::getInstance()
+{
+	if(sInstance == NULL)
+		sInstance = new ScraperCache();
+
+	return sInstance;
+}
+
+ScraperCache::ScraperCache() : mLoaded(false), mTotalSize(0)
+{
+	mDirectory = getHomePath() + "/.emulationstation/scraper_cache";
+}
+
+std::string ScraperCache::getFileName(const std::string& key)
+{
+	// FNV-1a, the key itself is stored in the entry to rule out collisions
+	unsigned long long hash = 14695981039346656037ULL;
+	for(size_t i = 0; i < key.size(); i++)
+	{
+		hash ^= (unsigned char)key[i];
+		hash *= 1099511628211ULL;
+	}
+
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", hash);
+	return name;
+}
+
+void ScraperCache::load()
+{
+	if(mLoaded)
+		return;
+	mLoaded = true;
+
+	boost::system::error_code ec;
+	fs::create_directories(mDirectory, ec);
+	for(fs::directory_iterator it(mDirectory, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if(!fs::is_regular_file(it->status()))
+			continue;
+
+		// left by an interrupted write
+		if(it->path().extension() == ".tmp")
+		{
+			fs::remove(it->path(), ec);
+			continue;
+		}
+
+		Entry entry = { (size_t)fs::file_size(it->path(), ec), fs::last_write_time(it->path(), ec) };
+		mEntries[it->path().filename().string()] = entry;
+		mTotalSize += entry.size;
+	}
+
+	LOG(LogInfo) << "Scraper cache: " << mEntries.size() << " entries, " << mTotalSize / 1024 << " KB";
+}
+
+void ScraperCache::remove(std::map<std::string, Entry>::iterator entry)
+{
+	boost::system::error_code ec;
+	fs::remove(mDirectory + "/" + entry->first, ec);
+	mTotalSize -= entry->second.size;
+	mEntries.erase(entry);
+}
+
+void ScraperCache::evict()
+{
+	const size_t limit = (size_t)Settings::getInstance()->getInt("ScraperCacheSize") * 1024 * 1024;
+	if(mTotalSize <= limit)
+		return;
+
+	// oldest first, down to 90% of the limit so that the next puts don't evict again
+	std::vector< std::pair<std::time_t, std::string> > byAge;
+	for(auto it = mEntries.begin(); it != mEntries.end(); it++)
+		byAge.push_back(std::make_pair(it->second.time, it->first));
+	std::sort(byAge.begin(), byAge.end());
+
+	for(auto it = byAge.begin(); it != byAge.end() && mTotalSize > limit / 10 * 9; it++)
+		remove(mEntries.find(it->second));
+}
+
+bool ScraperCache::get(const std::string& key, std::string& content)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	load();
+
+	auto entry = mEntries.find(getFileName(key));
+	if(entry == mEntries.end())
+		return false;
+
+	const int days = Settings::getInstance()->getInt("ScraperCacheDays");
+	if(days > 0 && std::time(NULL) - entry->second.time > (std::time_t)days * 24 * 60 * 60)
+	{
+		remove(entry);
+		return false;
+	}
+
+	std::ifstream stream(mDirectory + "/" + entry->first, std::ios::binary);
+	std::string storedKey;
+	if(!std::getline(stream, storedKey) || storedKey != key)
+		return false;
+
+	std::stringstream ss;
+	ss << stream.rdbuf();
+	content = ss.str();
+	return true;
+}
+
+void ScraperCache::put(const std::string& key, const std::string& content)
+{
+	// a line of its own in the entry
+	if(key.find('\n') != std::string::npos)
+		return;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	load();
+
+	const std::string name = getFileName(key);
+	const std::string path = mDirectory + "/" + name;
+	const std::string temporary = path + ".tmp";
+
+	std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+	stream << key << '\n';
+	stream.write(content.data(), content.size());
+	stream.close();
+
+	boost::system::error_code ec;
+	if(stream.fail())
+	{
+		LOG(LogWarning) << "Scraper cache: can't write " << temporary;
+		fs::remove(temporary, ec);
+		return;
+	}
+
+	fs::rename(temporary, path, ec);
+	if(ec)
+	{
+		fs::remove(temporary, ec);
+		return;
+	}
+
+	auto previous = mEntries.find(name);
+	if(previous != mEntries.end())
+		mTotalSize -= previous->second.size;
+
+	Entry entry = { key.size() + 1 + content.size(), std::time(NULL) };
+	mEntries[name] = entry;
+	mTotalSize += entry.size;
+
+	evict();
+}
+
+bool ScraperCache::hasMedia(const std::string& url, const std::string& path)
+{
+	std::string record;
+	if(!get(MEDIA_KEY_PREFIX + url, record))
+		return false;
+
+	std::istringstream stream(record);
+	unsigned int crc;
+	size_t size;
+	std::time_t modified;
+	std::string savedPath;
+	if(!(stream >> crc >> size >> modified))
+		return false;
+	stream.ignore(1);
+	std::getline(stream, savedPath);
+
+	// called from the UI thread: the file is not read, its size and time must still match
+	boost::system::error_code ec;
+	if(savedPath != path || fs::file_size(path, ec) != size || ec)
+		return false;
+	return fs::last_write_time(path, ec) == modified && !ec;
+}
+
+void ScraperCache::putMedia(const std::string& url, const std::string& path, unsigned int crc, size_t size)
+{
+	boost::system::error_code ec;
+	const std::time_t modified = fs::last_write_time(path, ec);
+	if(ec)
+		return;
+
+	std::ostringstream record;
+	record << crc << " " << size << " " << modified << " " << path;
+	put(MEDIA_KEY_PREFIX + url, record.str());
+}
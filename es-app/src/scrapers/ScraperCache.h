@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Responses of the scraper providers, kept on disk so that scraping a game again doesn't query the provider.
+// Entries are keyed by request: the URL carries the provider, the game name and every option.
+// They expire after "ScraperCacheDays" and the oldest are evicted past "ScraperCacheSize" (MB).
+// Downloaded media are recorded too, by URL with the size and time of the file saved, so that a file
+// still matching them is not downloaded again. Their CRC-32 is recorded along.
+class ScraperCache
+{
+public:
+	static ScraperCache* getInstance();
+
+	bool get(const std::string& key, std::string& content);
+	void put(const std::string& key, const std::string& content);
+
+	// true if the media at url was saved to path, and the file there is still the one saved
+	bool hasMedia(const std::string& url, const std::string& path);
+	// crc and size of the file saved, its time is read here
+	void putMedia(const std::string& url, const std::string& path, unsigned int crc, size_t size);
+
+private:
+	ScraperCache();
+	static ScraperCache* sInstance;
+
+	struct Entry
+	{
+		size_t size;
+		std::time_t time;
+	};
+
+	// the index is built from the cache directory on first use
+	void load();
+	void remove(std::map<std::string, Entry>::iterator entry);
+	void evict();
+
+	static std::string getFileName(const std::string& key);
+
+	std::string mDirectory;
+	bool mLoaded;
+	// by file name
+	std::map<std::string, Entry> mEntries;
+	size_t mTotalSize;
+	std::mutex mMutex;
+};
@@ -0,0 +1,141 @@
+#include "scrapers/ScraperScheduler.h"
+#include "Log.h"
+
+// TokenBucket
+TokenBucket::TokenBucket(float rate, int burst) : mRate(rate), mBurst((float)burst), mTokens((float)burst),
+	mLastRefill(std::chrono::steady_clock::now())
+{
+}
+
+void TokenBucket::refill()
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	float elapsed = std::chrono::duration<float>(now - mLastRefill).count();
+	mLastRefill = now;
+
+	mTokens += elapsed * mRate;
+	if(mTokens > mBurst)
+		mTokens = mBurst;
+}
+
+bool TokenBucket::hasToken()
+{
+	refill();
+	return mTokens >= 1;
+}
+
+void TokenBucket::spend(int count)
+{
+	refill();
+	mTokens -= count;
+}
+
+// ScraperScheduler
+ScraperScheduler::ScraperScheduler(const std::queue<ScraperSearchParams>& searches, const ScraperLimits& limits)
+	: mQueue(searches), mLimits(limits), mBucket(limits.requestsPerSecond, limits.burst)
+{
+}
+
+void ScraperScheduler::update()
+{
+	// callbacks are called last, they may stop us
+	std::vector< std::pair<ScraperSearchParams, ScraperSearchResult> > results;
+	std::vector< std::pair<ScraperSearchParams, std::string> > skipped;
+
+	for(auto it = mJobs.begin(); it != mJobs.end(); )
+	{
+		Job& job = **it;
+
+		if(job.searchHandle)
+		{
+			AsyncHandleStatus status = job.searchHandle->status();
+			if(status == ASYNC_IN_PROGRESS)
+			{
+				it++;
+				continue;
+			}
+
+			if(status == ASYNC_ERROR || job.searchHandle->getResults().empty())
+			{
+				skipped.push_back(std::make_pair(job.search, status == ASYNC_ERROR ? job.searchHandle->getStatusString() : "no result"));
+				it = mJobs.erase(it);
+				continue;
+			}
+
+			const std::vector<ScraperSearchResult>& found = job.searchHandle->getResults();
+			const int choice = mChooseCallback ? mChooseCallback(job.search, found) : 0;
+			if(choice < 0 || choice >= (int)found.size())
+			{
+				skipped.push_back(std::make_pair(job.search, std::string("no result accepted")));
+				it = mJobs.erase(it);
+				continue;
+			}
+
+			job.result = found.at(choice);
+			job.searchHandle.reset();
+
+			if(job.result.imageUrl.empty())
+			{
+				results.push_back(std::make_pair(job.search, job.result));
+				it = mJobs.erase(it);
+				continue;
+			}
+		}
+
+		if(!job.resolveHandle)
+		{
+			if(!mBucket.hasToken())
+			{
+				it++;
+				continue;
+			}
+			// media found in the ScraperCache are not downloaded, they cost nothing
+			job.resolveHandle = resolveMetaDataAssets(job.result, job.search);
+			mBucket.spend((int)job.resolveHandle->getDownloadCount());
+		}
+
+		AsyncHandleStatus status = job.resolveHandle->status();
+		if(status == ASYNC_IN_PROGRESS)
+		{
+			it++;
+			continue;
+		}
+
+		if(status == ASYNC_DONE)
+			results.push_back(std::make_pair(job.search, job.resolveHandle->getResult()));
+		else
+			skipped.push_back(std::make_pair(job.search, job.resolveHandle->getStatusString()));
+		it = mJobs.erase(it);
+	}
+
+	// fill the free slots
+	while(!mQueue.empty() && (int)mJobs.size() < mLimits.maxGames && mBucket.hasToken())
+	{
+		std::unique_ptr<Job> job(new Job());
+		job->search = mQueue.front();
+		mQueue.pop();
+		job->searchHandle = startScraperSearch(job->search);
+		// one request per platform of the system, the responses found in the ScraperCache cost nothing
+		mBucket.spend((int)job->searchHandle->getNetworkRequestCount());
+		mJobs.push_back(std::move(job));
+	}
+
+	for(auto it = skipped.begin(); it != skipped.end(); it++)
+	{
+		LOG(LogInfo) << "Scraper skipped " << it->first.game->getPath().generic_string() << ": " << it->second;
+		if(mSkipCallback)
+			mSkipCallback(it->first, it->second);
+	}
+	for(auto it = results.begin(); it != results.end(); it++)
+	{
+		if(mResultCallback)
+			mResultCallback(it->first, it->second);
+	}
+}
+
+void ScraperScheduler::stop()
+{
+	mJobs.clear();
+	while(!mQueue.empty())
+		mQueue.pop();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "scrapers/Scraper.h"
+#include <chrono>
+#include <list>
+
+// Request rate limiter: tokens are earned at a constant rate, up to a burst, and each request spends one
+class TokenBucket
+{
+public:
+	TokenBucket(float rate, int burst);
+
+	// True if a token is available, requests are then allowed
+	bool hasToken();
+	// Spend tokens whatever is left, requests then wait for the debt to be paid back
+	void spend(int count);
+
+private:
+	void refill();
+
+	float mRate;
+	float mBurst;
+	float mTokens;
+	std::chrono::steady_clock::time_point mLastRefill;
+};
+
+//
+// Scrapes several games at once: the searches and media downloads of up to ScraperLimits::maxGames
+// games are in flight together, within the request rate of the scraper.
+// Transfers run on the I/O thread of HttpReq; update() only polls their status on the caller's
+// thread, where the next requests are started and results are reported.
+//
+class ScraperScheduler
+{
+public:
+	typedef std::function<void(const ScraperSearchParams& search, const ScraperSearchResult& result)> ResultCallback;
+	typedef std::function<void(const ScraperSearchParams& search, const std::string& reason)> SkipCallback;
+	// index of the result to take, -1 to skip the game
+	typedef std::function<int(const ScraperSearchParams& search, const std::vector<ScraperSearchResult>& results)> ChooseCallback;
+
+	ScraperScheduler(const std::queue<ScraperSearchParams>& searches, const ScraperLimits& limits);
+
+	// the result chosen, with its media downloaded
+	inline void setResultCallback(const ResultCallback& callback) { mResultCallback = callback; }
+	// the first result is taken if none is set; called while update() walks the games, it must not stop us
+	inline void setChooseCallback(const ChooseCallback& callback) { mChooseCallback = callback; }
+	// no result, or an error
+	inline void setSkipCallback(const SkipCallback& callback) { mSkipCallback = callback; }
+
+	// Report the games done and start the next ones the limits allow
+	void update();
+	// Drop the games in flight and the ones left
+	void stop();
+
+	inline bool isDone() const { return mQueue.empty() && mJobs.empty(); }
+	inline size_t getInFlightCount() const { return mJobs.size(); }
+
+private:
+	struct Job
+	{
+		ScraperSearchParams search;
+		std::unique_ptr<ScraperSearchHandle> searchHandle;
+		ScraperSearchResult result;
+		// null until a token is available to resolve the media
+		std::unique_ptr<MDResolveHandle> resolveHandle;
+	};
+
+	std::queue<ScraperSearchParams> mQueue;
+	std::list< std::unique_ptr<Job> > mJobs;
+
+	ScraperLimits mLimits;
+	TokenBucket mBucket;
+
+	ResultCallback mResultCallback;
+	SkipCallback mSkipCallback;
+	ChooseCallback mChooseCallback;
+};
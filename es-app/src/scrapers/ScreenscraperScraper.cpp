@@ -92,7 +92,7 @@ static const std::map<std::string, const char*> system_language_map = boost::ass
 void screenscraper_generate_scraper_requests(const ScraperSearchParams& params, std::queue< std::unique_ptr<ScraperRequest> >& requests, 
 	std::vector<ScraperSearchResult>& results)
 {
-	std::string path = "https://screenscraper.recalbox.com/api/thegamedb/GetGame.php?";
+	std::string path = Settings::getInstance()->getString("ScreenscraperServer") + "/api/thegamedb/GetGame.php?";
 	std::string languageSystem = RecalboxConf::getInstance()->get("system.language");
 	bool MixImages = Settings::getInstance()->getBool("MixImages");
 
@@ -141,12 +141,11 @@ void screenscraper_generate_scraper_requests(const ScraperSearchParams& params,
 	}
 }
 
-void ScreenscraperRequest::process(const std::unique_ptr<HttpReq>& req, std::vector<ScraperSearchResult>& results)
+void ScreenscraperRequest::process(const std::string& content, std::vector<ScraperSearchResult>& results)
 {
-	assert(req->status() == HttpReq::REQ_SUCCESS);
 
 	pugi::xml_document doc;
-	pugi::xml_parse_result parseResult = doc.load(req->getContent().c_str());
+	pugi::xml_parse_result parseResult = doc.load(content.c_str());
 	if(!parseResult)
 	{
 		std::stringstream ss;
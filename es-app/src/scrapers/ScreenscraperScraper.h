@@ -10,5 +10,5 @@ class ScreenscraperRequest : public ScraperHttpRequest
 public:
 	ScreenscraperRequest(std::vector<ScraperSearchResult>& resultsWrite, const std::string& url) : ScraperHttpRequest(resultsWrite, url) {}
 protected:
-	void process(const std::unique_ptr<HttpReq>& req, std::vector<ScraperSearchResult>& results) override;
+	void process(const std::string& content, std::vector<ScraperSearchResult>& results) override;
 };
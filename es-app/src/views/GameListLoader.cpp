@@ -0,0 +1,182 @@
+#include "views/GameListLoader.h"
+#include "SystemData.h"
+#include "RecalboxConf.h"
+
+#define MAX_QUEUED_GAMELISTS	3
+
+// Same rule as before: a detailed view as soon as a displayable item has an image.
+// Returns false when a file was removed meanwhile, found is then to be ignored.
+static bool hasThumbnail(const FileData* folder, GameDataBatchLock& lock, bool& found)
+{
+	// read by index, the vector may grow between batches
+	const std::vector<FileData*>& children = folder->getChildren();
+	for (size_t i = 0; i < children.size() && !found; i++)
+	{
+		FileData* child = children[i];
+		if (child->metadata.get("hidden") != "true" && !child->getThumbnailPath().empty())
+			found = true;
+		else if (child->getType() == FOLDER && !hasThumbnail(child, lock, found))
+			return false;
+
+		if (!lock.next())
+			return false;
+	}
+	return true;
+}
+
+PreparedGameList::PreparedGameList(SystemData* system)
+	: system(system), options(system), detailed(false)
+{
+	forceBasic = RecalboxConf::getInstance()->get("emulationstation.forcebasicgamelistview") == "1";
+	grid = !forceBasic && system->getTheme()->hasView("grid");
+}
+
+void PreparedGameList::prepare()
+{
+	if (!forceBasic && !grid)
+	{
+		bool found = false;
+		for (;;)
+		{
+			GameDataBatchLock lock;
+			if (hasThumbnail(system->getRootFolder(), lock, found))
+				break;
+			found = false;
+		}
+		detailed = found;
+	}
+
+	BasicGameListView::prepareContent(system, system->getRootFolder(), options, content);
+}
+
+GameListLoader::GameListLoader() : mLoading(nullptr), mDiscardLoading(false), mExit(false)
+{
+	mThread = new std::thread(&GameListLoader::threadProc, this);
+}
+
+GameListLoader::~GameListLoader()
+{
+	// Exit the thread
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mQueue.clear();
+		mExit = true;
+	}
+	mEvent.notify_one();
+	mThread->join();
+	delete mThread;
+}
+
+void GameListLoader::threadProc()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true)
+	{
+		mEvent.wait(lock, [this] { return mExit || !mQueue.empty(); });
+		if (mExit)
+			break;
+
+		std::unique_ptr<PreparedGameList> prepared(std::move(mQueue.front()));
+		mQueue.pop_front();
+		mLoading = prepared->system;
+		mDiscardLoading = false;
+
+		// Queue is released while preparing
+		lock.unlock();
+		prepared->prepare();
+		lock.lock();
+
+		if (!mDiscardLoading)
+			mReady[mLoading] = std::move(prepared);
+		mLoading = nullptr;
+		mLoaded.notify_all();
+	}
+}
+
+void GameListLoader::load(SystemData* system)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	if ((mLoading == system && !mDiscardLoading) || mReady.find(system) != mReady.end())
+		return;
+
+	for (auto it = mQueue.begin(); it != mQueue.end(); it++)
+	{
+		if ((*it)->system == system)
+		{
+			// Already queued, just make it the next one
+			mQueue.splice(mQueue.begin(), mQueue, it);
+			return;
+		}
+	}
+
+	mQueue.push_front(std::unique_ptr<PreparedGameList>(new PreparedGameList(system)));
+	// Requests pile up when scrolling fast through the systems, only the last ones matter
+	while (mQueue.size() > MAX_QUEUED_GAMELISTS)
+		mQueue.pop_back();
+	mEvent.notify_one();
+}
+
+std::unique_ptr<PreparedGameList> GameListLoader::take(SystemData* system)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	for (auto it = mQueue.begin(); it != mQueue.end(); it++)
+	{
+		if ((*it)->system == system)
+		{
+			mQueue.erase(it);
+			break;
+		}
+	}
+
+	std::unique_ptr<PreparedGameList> prepared;
+	auto ready = mReady.find(system);
+	if (ready != mReady.end())
+	{
+		prepared = std::move(ready->second);
+		mReady.erase(ready);
+	}
+	return prepared;
+}
+
+bool GameListLoader::isPreparing(SystemData* system)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	return mLoading == system && !mDiscardLoading;
+}
+
+std::unique_ptr<PreparedGameList> GameListLoader::takeReady()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	std::unique_ptr<PreparedGameList> prepared;
+	if (!mReady.empty())
+	{
+		prepared = std::move(mReady.begin()->second);
+		mReady.erase(mReady.begin());
+	}
+	return prepared;
+}
+
+void GameListLoader::discard(SystemData* system)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	for (auto it = mQueue.begin(); it != mQueue.end(); it++)
+	{
+		if ((*it)->system == system)
+		{
+			mQueue.erase(it);
+			break;
+		}
+	}
+	mReady.erase(system);
+	if (mLoading == system)
+		mDiscardLoading = true;
+}
+
+void GameListLoader::clear()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mQueue.clear();
+	mReady.clear();
+	mDiscardLoading = true;
+	mLoaded.wait(lock, [this] { return mLoading == nullptr; });
+}
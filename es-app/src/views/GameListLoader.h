@@ -0,0 +1,74 @@
+#pragma once
+
+#include "views/gamelist/BasicGameListView.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class SystemData;
+
+// CPU side of a gamelist view construction: view type and list content.
+// Creating the components and applying the theme (GL resources) is left to the main thread.
+struct PreparedGameList
+{
+	// Options are read here, so it must be constructed on the main thread
+	explicit PreparedGameList(SystemData* system);
+
+	void prepare();
+
+	SystemData* system;
+	BasicGameListView::ContentOptions options;
+	bool forceBasic;
+	// the theme has a grid view, no need to look for images
+	bool grid;
+
+	bool detailed;
+	BasicGameListView::Content content;
+};
+
+//
+// Prepares gamelists on a background thread, so that switching to a system
+// does not have to walk and order its whole game tree in the frame.
+// Most recent requests are prepared first, older ones are dropped when too many pile up.
+//
+class GameListLoader
+{
+public:
+	GameListLoader();
+	~GameListLoader();
+
+	// Queue a system, unless it is already queued, being prepared or ready
+	void load(SystemData* system);
+
+	// Take the prepared gamelist of a system, without waiting.
+	// Returns nullptr if it was not requested or not started yet: it's as fast to prepare it in place.
+	// Also nullptr while it is being prepared, it will then be returned by takeReady.
+	std::unique_ptr<PreparedGameList> take(SystemData* system);
+	// True while the gamelist of a system is being prepared
+	bool isPreparing(SystemData* system);
+	// Take any prepared gamelist, without waiting
+	std::unique_ptr<PreparedGameList> takeReady();
+
+	// Forget a system whose files or options changed
+	void discard(SystemData* system);
+	// Forget everything, and wait for the gamelist being prepared if any
+	void clear();
+
+private:
+	void threadProc();
+
+	std::list<std::unique_ptr<PreparedGameList> >				mQueue;
+	std::map<SystemData*, std::unique_ptr<PreparedGameList> >	mReady;
+	SystemData*					mLoading;
+	bool						mDiscardLoading;
+
+	std::thread*				mThread;
+	std::mutex					mMutex;
+	std::condition_variable		mEvent;
+	// Only waited for by clear()
+	std::condition_variable		mLoaded;
+	bool						mExit;
+};
@@ -20,13 +20,15 @@
 #include "MenuThemeData.h"
 #include "AudioManager.h"
 #include "Locale.h"
+#include <set>
 
-// buffer values for scrolling velocity (left, stopped, right)
-const int logoBuffersLeft[] = { -5, -2, -1 };
-const int logoBuffersRight[] = { 1, 2, 5 };
+// logos drawn on each side of the carousel besides the fully visible ones
+const int logoMargin = 2;
+// systems kept loaded ahead of the residency radius, in the scrolling direction
+const int residencyScrollAhead = 3;
 
 SystemView::SystemView(Window* window) : IList<SystemViewData, SystemData*>(window, LIST_SCROLL_STYLE_SLOW, LIST_ALWAYS_LOOP),
-																				mViewNeedsReload(true), launchKodi(false),
+																				mViewNeedsReload(true), mShowing(false), launchKodi(false),
                                          mSystemInfo(window, "SYSTEM INFO", Font::get(FONT_SIZE_SMALL), 0x33333300, ALIGN_CENTER)
 {
 	mCamOffset = 0;
@@ -55,7 +57,8 @@ void SystemView::addSystem(SystemData * it){
 	// make logo
 	if(theme->getElement("system", "logo", "image"))
 	{
-		ImageComponent* logo = new ImageComponent(mWindow, false, false);
+		// lazy managed texture: read in the background once near the cursor, released when far from it
+		ImageComponent* logo = new ImageComponent(mWindow, false, true, true);
 		logo->setMaxSize(mCarousel.logoSize * mCarousel.logoScale);
 		logo->applyTheme((it)->getTheme(), "system", "logo", ThemeFlags::PATH);
 		e.data.logo = std::shared_ptr<GuiComponent>(logo);
@@ -111,6 +114,8 @@ void SystemView::populate()
 	{
 		addSystem((*it));
 	}
+
+	updateResidency();
 }
 
 void SystemView::goToSystem(SystemData* system, bool animate)
@@ -306,7 +311,9 @@ void SystemView::onCursorChanged(const CursorState& state)
 	if(lastSystem != getSelected()){
 		lastSystem = getSelected();
 		AudioManager::getInstance()->themeChanged(getSelected()->getTheme());
+		ViewController::get()->prebuildGameLists(lastSystem);
 	}
+	updateResidency();
 	// update help style
 	updateHelpPrompts();
 
@@ -585,19 +592,11 @@ void SystemView::renderCarousel(const Eigen::Affine3f& trans)
 
 	int center = (int)(mCamOffset);
 	int logoCount = std::min(mCarousel.maxLogoCount, (int)mEntries.size());
-	
-	// Adding texture loading buffers depending on scrolling speed and status
-	int bufferIndex = getScrollingVelocity() + 1;
 
-	int bufferLeft = logoBuffersLeft[bufferIndex];
-	int bufferRight = logoBuffersRight[bufferIndex];
-	if (logoCount == 1)
-	{
-		bufferLeft = 0;
-		bufferRight = 0;
-	}
+	// textures are loaded ahead by updateResidency, only draw what can be seen
+	int margin = logoCount == 1 ? 0 : logoMargin;
 
-	for (int i = center - logoCount / 2 + bufferLeft; i <= center + logoCount / 2 + bufferRight; i++)
+	for (int i = center - logoCount / 2 - margin; i <= center + logoCount / 2 + margin; i++)
 	{
 		int index = i;
 		while (index < 0)
@@ -642,11 +641,9 @@ void SystemView::renderExtras(const Eigen::Affine3f& trans, float lower, float u
 	int extrasCenter = (int)mExtrasCamOffset;
 
 	Renderer::pushClipRect(Eigen::Vector2i::Zero(), mSize.cast<int>());
-	
-	// Adding texture loading buffers depending on scrolling speed and status
-	int bufferIndex = getScrollingVelocity() + 1;
-	
-	for (int i = extrasCenter + logoBuffersLeft[bufferIndex]; i <= extrasCenter + logoBuffersRight[bufferIndex]; i++)
+
+	// at most two systems are on screen while sliding, textures are loaded ahead by updateResidency
+	for (int i = extrasCenter - 1; i <= extrasCenter + 1; i++)
 	{
 		int index = i;
 		while (index < 0)
@@ -724,44 +721,44 @@ void  SystemView::getDefaultElements(void)
 
 void SystemView::getCarouselFromTheme(const ThemeData::ThemeElement* elem)
 {
-	if (elem->has("type"))
+	if (elem->has(ThemeProperty::TYPE))
 	{
-		if (!(elem->get<std::string>("type").compare("vertical")))
+		if (!(elem->get<std::string>(ThemeProperty::TYPE).compare("vertical")))
 			mCarousel.type = VERTICAL;
-		else if (!(elem->get<std::string>("type").compare("vertical_wheel")))
+		else if (!(elem->get<std::string>(ThemeProperty::TYPE).compare("vertical_wheel")))
 			mCarousel.type = VERTICAL_WHEEL;
 		else
 			mCarousel.type = HORIZONTAL;
 	}
-	if (elem->has("size"))
-		mCarousel.size = elem->get<Eigen::Vector2f>("size").cwiseProduct(mSize);
-	if (elem->has("pos"))
-		mCarousel.pos = elem->get<Eigen::Vector2f>("pos").cwiseProduct(mSize);
-	if (elem->has("origin"))
-		mCarousel.origin = elem->get<Eigen::Vector2f>("origin");
-	if (elem->has("color"))
-		mCarousel.color = elem->get<unsigned int>("color");
-	if (elem->has("logoScale"))
-		mCarousel.logoScale = elem->get<float>("logoScale");
-	if (elem->has("logoSize"))
-		mCarousel.logoSize = elem->get<Eigen::Vector2f>("logoSize").cwiseProduct(mSize);
-	if (elem->has("maxLogoCount"))
-		mCarousel.maxLogoCount = std::round(elem->get<float>("maxLogoCount"));
-	if (elem->has("zIndex"))
-		mCarousel.zIndex = elem->get<float>("zIndex");
-	if (elem->has("logoRotation"))
-		mCarousel.logoRotation = elem->get<float>("logoRotation");
-	if (elem->has("logoRotationOrigin"))
-		mCarousel.logoRotationOrigin = elem->get<Eigen::Vector2f>("logoRotationOrigin");
-	if (elem->has("logoAlignment"))
+	if (elem->has(ThemeProperty::SIZE))
+		mCarousel.size = elem->get<Eigen::Vector2f>(ThemeProperty::SIZE).cwiseProduct(mSize);
+	if (elem->has(ThemeProperty::POS))
+		mCarousel.pos = elem->get<Eigen::Vector2f>(ThemeProperty::POS).cwiseProduct(mSize);
+	if (elem->has(ThemeProperty::ORIGIN))
+		mCarousel.origin = elem->get<Eigen::Vector2f>(ThemeProperty::ORIGIN);
+	if (elem->has(ThemeProperty::COLOR))
+		mCarousel.color = elem->get<unsigned int>(ThemeProperty::COLOR);
+	if (elem->has(ThemeProperty::LOGO_SCALE))
+		mCarousel.logoScale = elem->get<float>(ThemeProperty::LOGO_SCALE);
+	if (elem->has(ThemeProperty::LOGO_SIZE))
+		mCarousel.logoSize = elem->get<Eigen::Vector2f>(ThemeProperty::LOGO_SIZE).cwiseProduct(mSize);
+	if (elem->has(ThemeProperty::MAX_LOGO_COUNT))
+		mCarousel.maxLogoCount = std::round(elem->get<float>(ThemeProperty::MAX_LOGO_COUNT));
+	if (elem->has(ThemeProperty::Z_INDEX))
+		mCarousel.zIndex = elem->get<float>(ThemeProperty::Z_INDEX);
+	if (elem->has(ThemeProperty::LOGO_ROTATION))
+		mCarousel.logoRotation = elem->get<float>(ThemeProperty::LOGO_ROTATION);
+	if (elem->has(ThemeProperty::LOGO_ROTATION_ORIGIN))
+		mCarousel.logoRotationOrigin = elem->get<Eigen::Vector2f>(ThemeProperty::LOGO_ROTATION_ORIGIN);
+	if (elem->has(ThemeProperty::LOGO_ALIGNMENT))
 	{
-		if (!(elem->get<std::string>("logoAlignment").compare("left")))
+		if (!(elem->get<std::string>(ThemeProperty::LOGO_ALIGNMENT).compare("left")))
 			mCarousel.logoAlignment = ALIGN_LEFT;
-		else if (!(elem->get<std::string>("logoAlignment").compare("right")))
+		else if (!(elem->get<std::string>(ThemeProperty::LOGO_ALIGNMENT).compare("right")))
 			mCarousel.logoAlignment = ALIGN_RIGHT;
-		else if (!(elem->get<std::string>("logoAlignment").compare("top")))
+		else if (!(elem->get<std::string>(ThemeProperty::LOGO_ALIGNMENT).compare("top")))
 			mCarousel.logoAlignment = ALIGN_TOP;
-		else if (!(elem->get<std::string>("logoAlignment").compare("bottom")))
+		else if (!(elem->get<std::string>(ThemeProperty::LOGO_ALIGNMENT).compare("bottom")))
 			mCarousel.logoAlignment = ALIGN_BOTTOM;
 		else
 			mCarousel.logoAlignment = ALIGN_CENTER;
@@ -771,11 +768,94 @@ void SystemView::getCarouselFromTheme(const ThemeData::ThemeElement* elem)
 void SystemView::onShow()
 {
 	mShowing = true;
+	updateResidency();
 }
 
 void SystemView::onHide()
 {
 	mShowing = false;
+	updateResidency();
+}
+
+void SystemView::updateResidency()
+{
+	const int count = (int)mEntries.size();
+	if (count == 0)
+		return;
+
+	const int logoRadius = std::min(mCarousel.maxLogoCount, count) / 2 + logoMargin;
+	// only the selected system is drawn behind the gamelists: leave the room to their art
+	int extrasRadius = mShowing ? std::max(1, Settings::getInstance()->getInt("SystemResidency")) : 0;
+	const int velocity = getScrollingVelocity();
+	const int aheadLeft = velocity < 0 ? residencyScrollAhead : 0;
+	const int aheadRight = velocity > 0 ? residencyScrollAhead : 0;
+	const size_t budget = (size_t)Settings::getInstance()->getInt("MaxVRAM") * 1024 * 1024 / 2;
+
+	// signed distance from the cursor, the shortest way around
+	std::vector<int> distances(count);
+	std::vector< std::vector< std::shared_ptr<TextureResource> > > logos(count);
+	std::vector< std::vector< std::shared_ptr<TextureResource> > > extras(count);
+	for (int i = 0; i < count; i++)
+	{
+		int distance = ((i - mCursor) % count + count) % count;
+		distances[i] = distance > count / 2 ? distance - count : distance;
+		mEntries[i].data.logo->getTextures(logos[i]);
+		mEntries[i].data.backgroundExtras->getTextures(extras[i]);
+	}
+
+	auto inRange = [aheadLeft, aheadRight](int distance, int radius) {
+		return distance >= -radius - aheadLeft && distance <= radius + aheadRight;
+	};
+
+	std::vector<int> nearest(count);
+	for (int i = 0; i < count; i++)
+		nearest[i] = i;
+	std::stable_sort(nearest.begin(), nearest.end(), [&distances](int a, int b) { return std::abs(distances[a]) < std::abs(distances[b]); });
+
+	// nearest first, textures may be shared between systems
+	std::vector<TextureResource*> resident;
+	std::set<TextureResource*> residentSet;
+	size_t residentSize = 0;
+	auto addResident = [&](const std::vector< std::shared_ptr<TextureResource> >& textures) {
+		for (auto& texture : textures)
+			if (residentSet.insert(texture.get()).second)
+			{
+				resident.push_back(texture.get());
+				// lazy textures not loaded yet count for the size they will have
+				residentSize += texture->getEstimatedMemorySize();
+			}
+	};
+
+	// rich themes may not fit: shrink the extras radius, the selected system always stays
+	for (; extrasRadius >= 0; extrasRadius--)
+	{
+		resident.clear();
+		residentSet.clear();
+		residentSize = 0;
+		for (int i : nearest)
+			if (inRange(distances[i], extrasRadius))
+				addResident(extras[i]);
+		if (residentSize <= budget || extrasRadius == 0)
+			break;
+	}
+	for (int i : nearest)
+		if (inRange(distances[i], logoRadius))
+			addResident(logos[i]);
+
+	// release first to make room, then queue the farthest first: the loader takes the latest first
+	for (int i = 0; i < count; i++)
+	{
+		for (auto& texture : logos[i])
+			if (residentSet.find(texture.get()) == residentSet.end())
+				texture->release();
+		for (auto& texture : extras[i])
+			if (residentSet.find(texture.get()) == residentSet.end())
+				texture->release();
+	}
+	for (auto it = resident.rbegin(); it != resident.rend(); it++)
+		(*it)->preload();
+
+	TextureResource::setResidency("Carousel", residentSize, budget);
 }
 
 void SystemView::removeFavoriteSystem(){
@@ -802,4 +882,5 @@ void SystemView::manageFavorite(){
 			addSystem(favorite);
 		}
 	}
+	updateResidency();
 }
@@ -69,6 +69,8 @@ private:
 	void getViewElements(const std::shared_ptr<ThemeData>& theme);
 	void getDefaultElements(void);
 	void getCarouselFromTheme(const ThemeData::ThemeElement* elem);
+	// Keep the textures of the systems near the cursor loaded, release the others
+	void updateResidency();
   
 	void renderCarousel(const Eigen::Affine3f& parentTrans);
 	void renderExtras(const Eigen::Affine3f& parentTrans, float lower, float upper);
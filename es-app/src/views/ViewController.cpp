@@ -145,8 +145,25 @@ void ViewController::goToGameList(SystemData* system)
 	mState.viewing = GAME_LIST;
 	mState.system = system;
 
-	mCurrentView = getGameListView(system);
+	mCurrentView = getGameListViewOrPlaceholder(system);
 	playViewTransition();
+
+	// quick system select goes to the neighbours
+	prebuildGameLists(system);
+}
+
+void ViewController::onFavoriteChanged(FileData* game, bool favorite)
+{
+	SystemData* favoriteSystem = SystemData::getFavoriteSystem();
+	if (favoriteSystem == nullptr)
+		return;
+
+	// a view not built yet will be populated from the up to date favorites anyway
+	auto view = mGameListViews.find(favoriteSystem);
+	if (view != mGameListViews.end())
+		view->second->onFavoriteChanged(game, favorite);
+
+	getSystemListView()->manageFavorite();
 }
 
 void ViewController::updateFavorite(SystemData* system, FileData* file)
@@ -251,8 +268,10 @@ void ViewController::playViewTransition()
 
 void ViewController::onFileChanged(FileData* file, FileChangeType change)
 {
+	mGameListLoader.discard(file->getSystem());
 	auto it = mGameListViews.find(file->getSystem());
-	if (it != mGameListViews.end()) {
+	// a placeholder will be replaced by an up to date gamelist
+	if (it != mGameListViews.end() && !isPlaceholder(file->getSystem())) {
 		it->second->onFileChanged(file, change);
 	}
 	if (file->metadata.get("favorite") == "true") {
@@ -315,33 +334,70 @@ void ViewController::launch(FileData* game, Eigen::Vector3f center, std::string
 
 std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* system)
 {
-	//if we already made one, return that one
+	//if we already made one, return that one, unless it is a placeholder: the caller wants the games
 	auto exists = mGameListViews.find(system);
-	if(exists != mGameListViews.end())
+	bool placeholder = isPlaceholder(system);
+	if(exists != mGameListViews.end() && !placeholder)
 		return exists->second;
 
-	//if we didn't, make it, remember it, and return it
-	std::shared_ptr<IGameListView> view;
+	//if we didn't, make it (or take the one prepared in the background), remember it, and return it
+	std::unique_ptr<PreparedGameList> prepared = mGameListLoader.take(system);
+	if(!prepared)
+	{
+		prepared.reset(new PreparedGameList(system));
+		prepared->prepare();
+	}
 
-	//decide type
-	bool detailed = false;
-	std::vector<FileData*> files = system->getRootFolder()->getDisplayableRecursive(GAME | FOLDER);
-	for(auto it = files.begin(); it != files.end(); it++)
+	return placeholder ? replaceGameListView(*prepared) : createGameListView(*prepared);
+}
+
+std::shared_ptr<IGameListView> ViewController::getGameListViewOrPlaceholder(SystemData* system)
+{
+	if(mGameListViews.find(system) != mGameListViews.end() || !mGameListLoader.isPreparing(system))
+		return getGameListView(system);
+
+	PreparedGameList prepared(system);
+	prepared.content.listingOffset = 0;
+	std::shared_ptr<IGameListView> view = createGameListView(prepared);
+	mPlaceholderGameLists[system] = view;
+	return view;
+}
+
+bool ViewController::isPlaceholder(SystemData* system) const
+{
+	auto placeholder = mPlaceholderGameLists.find(system);
+	if(placeholder == mPlaceholderGameLists.end())
+		return false;
+	auto view = mGameListViews.find(system);
+	return view != mGameListViews.end() && view->second == placeholder->second.lock();
+}
+
+std::shared_ptr<IGameListView> ViewController::replaceGameListView(const PreparedGameList& prepared)
+{
+	std::shared_ptr<IGameListView> previous = mGameListViews[prepared.system];
+	mPlaceholderGameLists.erase(prepared.system);
+
+	std::shared_ptr<IGameListView> view = createGameListView(prepared);
+	if(mCurrentView == previous)
 	{
-		if(!(*it)->getThumbnailPath().empty())
-		{
-			detailed = true;
-			break;
-		}
+		mCurrentView = view;
+		updateHelpPrompts();
 	}
+	return view;
+}
 
-	if(detailed && ! (RecalboxConf::getInstance()->get("emulationstation.forcebasicgamelistview") == "1"))
-		view = std::shared_ptr<IGameListView>(new DetailedGameListView(mWindow, system->getRootFolder(), system));
-	else
-		view = std::shared_ptr<IGameListView>(new BasicGameListView(mWindow, system->getRootFolder()));
+std::shared_ptr<IGameListView> ViewController::createGameListView(const PreparedGameList& prepared)
+{
+	SystemData* system = prepared.system;
+	std::shared_ptr<IGameListView> view;
 
-	// uncomment for experimental "image grid" view
-	//view = std::shared_ptr<IGameListView>(new GridGameListView(mWindow, system->getRootFolder()));
+	//decide type
+	if(prepared.grid)
+		view = std::shared_ptr<IGameListView>(new GridGameListView(mWindow, system->getRootFolder(), &prepared.content));
+	else if(prepared.detailed)
+		view = std::shared_ptr<IGameListView>(new DetailedGameListView(mWindow, system->getRootFolder(), system, &prepared.content));
+	else
+		view = std::shared_ptr<IGameListView>(new BasicGameListView(mWindow, system->getRootFolder(), &prepared.content));
 
 	view->setTheme(system->getTheme());
 
@@ -356,6 +412,30 @@ std::shared_ptr<IGameListView> ViewController::getGameListView(SystemData* syste
 	return view;
 }
 
+void ViewController::prebuildGameLists(SystemData* system)
+{
+	SystemData* prev = system->getPrev();
+	while(prev != system && prev->getRootFolder()->getChildren().size() == 0)
+		prev = prev->getPrev();
+	SystemData* next = system->getNext();
+	while(next != system && next->getRootFolder()->getChildren().size() == 0)
+		next = next->getNext();
+
+	// the loader prepares the most recent request first
+	SystemData* systems[] = { prev, next, system };
+	for(auto it : systems)
+	{
+		// favorites mirror games of every system, they are cheap enough to be built in place
+		if(!it->isFavorite() && mGameListViews.find(it) == mGameListViews.end())
+			mGameListLoader.load(it);
+	}
+}
+
+void ViewController::cancelPrebuiltGameLists()
+{
+	mGameListLoader.clear();
+}
+
 std::shared_ptr<SystemView> ViewController::getSystemListView()
 {
 	//if we already made one, return that one
@@ -390,6 +470,10 @@ bool ViewController::input(InputConfig* config, Input input)
 		return true;
 	}
 
+	// nothing to act upon until the games are there
+	if(mState.viewing == GAME_LIST && isPlaceholder(mState.getSystem()))
+		return true;
+
 	if(mCurrentView)
 		return mCurrentView->input(config, input);
 
@@ -403,6 +487,25 @@ void ViewController::update(int deltaTime)
 		mCurrentView->update(deltaTime);
 	}
 
+	// finish at most one gamelist prepared in the background per frame
+	std::unique_ptr<PreparedGameList> prepared = mGameListLoader.takeReady();
+	if(prepared && mGameListViews.find(prepared->system) == mGameListViews.end())
+		createGameListView(*prepared);
+	else if(prepared && isPlaceholder(prepared->system))
+		replaceGameListView(*prepared);
+
+	// the loader drops what it was preparing when files change, ask again for the placeholders
+	for(auto it = mPlaceholderGameLists.begin(); it != mPlaceholderGameLists.end(); )
+	{
+		if(isPlaceholder(it->first))
+		{
+			mGameListLoader.load(it->first);
+			it++;
+		}
+		else
+			it = mPlaceholderGameLists.erase(it);
+	}
+
 	updateSelf(deltaTime);
 }
 
@@ -495,18 +598,20 @@ void ViewController::reloadGameListView(IGameListView* view, bool reloadTheme)
 
 void ViewController::reloadAll()
 {
+	mGameListLoader.clear();
+
 	std::map<SystemData*, FileData*> cursorMap;
+	std::vector<SystemData*> systems;
 	for(auto it = mGameListViews.begin(); it != mGameListViews.end(); it++)
 	{
 		cursorMap[it->first] = it->second->getCursor();
+		systems.push_back(it->first);
 	}
 	mGameListViews.clear();
 
+	SystemData::loadThemes(systems);
 	for(auto it = cursorMap.begin(); it != cursorMap.end(); it++)
-	{
-		it->first->loadTheme();
 		getGameListView(it->first)->setCursor(it->second);
-	}
 
 	mSystemListView.reset();
 	getSystemListView();
@@ -530,8 +635,69 @@ void ViewController::reloadAll()
 	updateHelpPrompts();
 }
 
+void ViewController::reloadThemes()
+{
+	// prepared from the previous themes
+	mGameListLoader.clear();
+
+	std::map<SystemData*, std::shared_ptr<ThemeData> > previousThemes;
+	for(auto it = SystemData::sSystemVector.begin(); it != SystemData::sSystemVector.end(); it++)
+		previousThemes[*it] = (*it)->getTheme();
+
+	SystemData::loadThemes(SystemData::sSystemVector);
+
+	// Views replaced below are only released at the end: the textures and fonts
+	// they share with the new ones are then not loaded again
+	std::vector<std::shared_ptr<GuiComponent> > previousViews;
+
+	std::vector<SystemData*> rebuild;
+	for(auto it = mGameListViews.begin(); it != mGameListViews.end(); it++)
+	{
+		// the view type depends on the theme having a grid view
+		bool grid = PreparedGameList(it->first).grid;
+		if(grid != (std::string(it->second->getName()) == "grid"))
+			rebuild.push_back(it->first);
+		else
+			it->second->setTheme(it->first->getTheme());
+	}
+	for(auto it = rebuild.begin(); it != rebuild.end(); it++)
+	{
+		std::shared_ptr<IGameListView> view = mGameListViews[*it];
+		FileData* cursor = view->getCursor();
+		previousViews.push_back(view);
+		mGameListViews.erase(*it);
+		getGameListView(*it)->setCursor(cursor);
+	}
+
+	bool systemViewChanged = false;
+	for(auto it = previousThemes.begin(); it != previousThemes.end() && !systemViewChanged; it++)
+		systemViewChanged = !it->first->getTheme()->getChangedElements(*it->second, "system").empty();
+
+	if(systemViewChanged && mSystemListView)
+	{
+		previousViews.push_back(mSystemListView);
+		mSystemListView.reset();
+		getSystemListView();
+	}
+
+	// update mCurrentView since the pointers may have changed
+	if(mState.viewing == GAME_LIST)
+	{
+		mCurrentView = getGameListView(mState.getSystem());
+	}else if(mState.viewing == SYSTEM_SELECT && systemViewChanged)
+	{
+		SystemData* system = mState.getSystem();
+		goToSystemView(SystemData::sSystemVector.front());
+		mSystemListView->goToSystem(system, false);
+		mCurrentView = mSystemListView;
+	}
+
+	updateHelpPrompts();
+}
+
 void ViewController::reloadGamesLists()
 {
+	mGameListLoader.clear();
 	mGameListViews.clear();
 
 	if(mState.viewing == GAME_LIST)
@@ -548,6 +714,7 @@ void ViewController::reloadGamesLists()
 
 void ViewController::setInvalidGamesList(SystemData* system)
 {
+	mGameListLoader.discard(system);
 	for (auto it = mGameListViews.begin(); it != mGameListViews.end(); it++)
 	{
 		if (system == (it->first))
@@ -560,6 +727,7 @@ void ViewController::setInvalidGamesList(SystemData* system)
 
 void ViewController::setAllInvalidGamesList(SystemData* systemExclude)
 {
+	mGameListLoader.clear();
 	for (auto it = mGameListViews.begin(); it != mGameListViews.end(); it++)
 	{
 		if (systemExclude != (it->first))
@@ -575,7 +743,8 @@ std::vector<HelpPrompt> ViewController::getHelpPrompts()
 	if(!mCurrentView)
 		return prompts;
 
-	prompts = mCurrentView->getHelpPrompts();
+	if(mState.viewing != GAME_LIST || !isPlaceholder(mState.getSystem()))
+		prompts = mCurrentView->getHelpPrompts();
 	if(RecalboxConf::getInstance()->get("emulationstation.menu") != "none"){
 		prompts.push_back(HelpPrompt("select", _("QUIT")));
 		prompts.push_back(HelpPrompt("start", _("MENU")));
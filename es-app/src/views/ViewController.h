@@ -2,6 +2,7 @@
 
 #include "views/gamelist/IGameListView.h"
 #include "views/SystemView.h"
+#include "views/GameListLoader.h"
 
 class SystemData;
 
@@ -24,10 +25,18 @@ public:
 	void reloadGameListView(IGameListView* gamelist, bool reloadTheme = false);
 	inline void reloadGameListView(SystemData* system, bool reloadTheme = false) { reloadGameListView(getGameListView(system).get(), reloadTheme); }
 	void reloadAll(); // Reload everything with a theme.  Used when the "ThemeSet" setting changes.
+	// Reload the themes of all systems and apply them to the existing views, re-applying only the views
+	// whose elements changed. Used when the theme set or one of its options changes.
+	void reloadThemes();
 	void reloadGamesLists();
 	void setInvalidGamesList(SystemData* system);
 	void setAllInvalidGamesList(SystemData* systemExclude);
 
+	// Speculatively prepare the gamelists of a system and its neighbours in the background
+	void prebuildGameLists(SystemData* system);
+	// Drop gamelists prepared in the background, waiting for the one in progress (systems are going away)
+	void cancelPrebuiltGameLists();
+
 	// Navigation.
 	void goToNextGameList();
 	void goToPrevGameList();
@@ -39,6 +48,8 @@ public:
 	void onFileChanged(FileData* file, FileChangeType change);
 
 	void updateFavorite(SystemData* system, FileData* file);
+	// Add or remove a game in the favorites gamelist, if already built, and in the system carousel
+	void onFavoriteChanged(FileData* game, bool favorite);
 
 	// Plays a nice launch effect and launches the game at the end of it.
 	// Once the game terminates, plays a return effect.
@@ -83,12 +94,22 @@ private:
 
 	void playViewTransition();
 	int getSystemId(SystemData* system);
+	// Main thread part of a gamelist view construction
+	std::shared_ptr<IGameListView> createGameListView(const PreparedGameList& prepared);
+	// Replace the view of a system by a newly prepared one, keeping it current
+	std::shared_ptr<IGameListView> replaceGameListView(const PreparedGameList& prepared);
+	// Shows an empty gamelist while it is prepared in the background, rather than waiting for it in the frame
+	std::shared_ptr<IGameListView> getGameListViewOrPlaceholder(SystemData* system);
+	bool isPlaceholder(SystemData* system) const;
 	
 	std::shared_ptr<GuiComponent> mCurrentView;
 	std::map< SystemData*, std::shared_ptr<IGameListView> > mGameListViews;
 	std::shared_ptr<SystemView> mSystemListView;
 
 	std::map<SystemData*, bool> mInvalidGameList;
+	// Views shown empty until the loader is done with them
+	std::map< SystemData*, std::weak_ptr<IGameListView> > mPlaceholderGameLists;
+	GameListLoader mGameListLoader;
 	
 	Eigen::Affine3f mCamera;
 	float mFadeOpacity;
@@ -72,14 +72,18 @@ static const std::map<std::string, const char*> favorites_icons_map = boost::ass
         ("wii", "\uF263 ")
         ("imageviewer", "\uF27b ");
 
-BasicGameListView::BasicGameListView(Window* window, FileData* root)
+BasicGameListView::BasicGameListView(Window* window, FileData* root, const Content* content)
 	: ISimpleGameListView(window, root), mList(window), listingOffset(0) {
 	mList.setSize(mSize.x(), mSize.y() * 0.8f);
 	mList.setPosition(0, mSize.y() * 0.2f);
 	mList.setDefaultZIndex(20);
 	addChild(&mList);
 
-	populateList(root);
+	if (content != nullptr) {
+		setContent(root, *content);
+	} else {
+		populateList(root);
+	}
 }
 
 void BasicGameListView::onThemeChanged(const std::shared_ptr<ThemeData>& theme) {
@@ -99,85 +103,199 @@ void BasicGameListView::onFileChanged(FileData* file, FileChangeType change) {
 	}
 }
 
-void BasicGameListView::populateList(const FileData* folder) {
-    mPopulatedFolder = folder;
-    auto files = folder->getChildren();
+BasicGameListView::ContentOptions::ContentOptions(SystemData* system) {
+	showHidden = Settings::getInstance()->getBool("ShowHidden");
+	favoritesOnly = Settings::getInstance()->getBool("FavoritesOnly");
+	flatFolders = RecalboxConf::getInstance()->getBool(system->getName() + ".flatfolder");
+}
 
-	mList.clear();
-	mHeaderText.setText(mSystem->getFullName());
+void BasicGameListView::prepareContent(SystemData* system, const FileData* folder, const ContentOptions& options, Content& content) {
+	// may run on a worker thread: read again from the start when a file was removed meanwhile
+	while (!tryPrepareContent(system, folder, options, content)) {
+	}
+}
+
+bool BasicGameListView::tryPrepareContent(SystemData* system, const FileData* folder, const ContentOptions& options, Content& content) {
+	// the game data lock keeps the tree, favorites and sort index consistent, it is let go between batches of files
+	GameDataBatchLock lock;
+
+	// read by index, the vector may grow between batches
+	const std::vector<FileData*>& files = folder->getChildren();
+	content.items.clear();
 
 	bool favoritesOnly = false;
 
 	// find at least one favorite, else, show all items
-	if (Settings::getInstance()->getBool("FavoritesOnly") && !mSystem->isFavorite()) {
-		for (auto it = files.begin(); it != files.end(); it++) {
-			if ((*it)->getType() == GAME) {
-				if ((*it)->metadata.get("favorite") == "true") {
+	if (options.favoritesOnly && !system->isFavorite()) {
+		for (size_t i = 0; i < files.size(); i++) {
+			if (files[i]->getType() == GAME) {
+				if (files[i]->metadata.get("favorite") == "true") {
 					favoritesOnly = true;
 					break;
 				}
 			}
+			if (!lock.next()) {
+				return false;
+			}
 		}
 	}
 
-    bool showHidden = Settings::getInstance()->getBool("ShowHidden");
-    const FileData::SortType& sortType = mSystem->getSortType();
+    const FileData::SortType& sortType = system->getSortType();
+    FileSortIndex& sortIndex = system->getSortIndex();
+
+    std::vector<FileData*> favorites;
+    if (!getFavorites(folder, options, favorites, lock)) {
+        return false;
+    }
+
+    favorites = sortIndex.order(favorites, sortType);
+    for (auto it = favorites.begin(); it != favorites.end(); it++) {
+        addItem(content, *it, system->isFavorite());
+        if (!lock.next()) {
+            return false;
+        }
+    }
+    content.listingOffset = favorites.size();
 
 	// Do not show double names in favorite system.
-	if (!mSystem->isFavorite() && !favoritesOnly) {
-		for (auto it = files.begin(); it != files.end(); it++) {
-            bool isHidden = (*it)->metadata.get("hidden") == "true";
-			if (showHidden || !isHidden) {
-				addItem(*it);
+	if (!system->isFavorite() && !favoritesOnly) {
+		std::vector<FileData*> items;
+		for (size_t i = 0; i < files.size(); i++) {
+            bool isHidden = files[i]->metadata.get("hidden") == "true";
+			if (options.showHidden || !isHidden) {
+				if (!getItems(files[i], options, items, lock)) {
+					return false;
+				}
 			}
 		}
 
-		mList.sortByObject(*sortType.comparisonFunction, sortType.ascending);
+		// ordering is maintained by the system sort index, no need to sort here
+		items = sortIndex.order(items, sortType);
+		for (auto it = items.begin(); it != items.end(); it++) {
+			addItem(content, *it, true);
+			if (!lock.next()) {
+				return false;
+			}
+		}
 	}
 
-    addFavorites(files, sortType);
-
-    if (mSystem->isFavorite() || favoritesOnly) {
-        listingOffset = 0;
+    if (system->isFavorite() || favoritesOnly) {
+        content.listingOffset = 0;
     }
+    return true;
+}
+
+void BasicGameListView::populateList(const FileData* folder) {
+	Content content;
+	prepareContent(mSystem, folder, ContentOptions(mSystem), content);
+	setContent(folder, content);
+}
+
+void BasicGameListView::setContent(const FileData* folder, const Content& content) {
+	mPopulatedFolder = folder;
+
+	mList.clear();
+	mHeaderText.setText(mSystem->getFullName());
+
+	for (auto it = content.items.begin(); it != content.items.end(); it++) {
+		mList.add(it->name, it->file, it->colorId, false, it->letter);
+	}
+	listingOffset = content.listingOffset;
+
+	// shoulder buttons page through initials when they follow each other
+	mList.setLetterPaging(mSystem->getSortType().comparisonFunction == &FileSorts::compareFileName);
 }
 
 void BasicGameListView::refreshList() {
     populateList(mPopulatedFolder);
 }
 
-void BasicGameListView::addFavorites(const std::vector<FileData*>& files, const FileData::SortType& sortType) {
-    std::vector<FileData*> favorites;
-    getFavorites(files, favorites);
+void BasicGameListView::onFavoriteChanged(FileData* game, bool favorite) {
+	// the favorites only filter depends on the presence of any favorite, let a full populate decide
+	if (!mSystem->isFavorite() && Settings::getInstance()->getBool("FavoritesOnly")) {
+		refreshList();
+		return;
+	}
 
-    std::sort(favorites.begin(), favorites.end(), *sortType.comparisonFunction);
+	bool listed = Settings::getInstance()->getBool("ShowHidden") || game->metadata.get("hidden") != "true";
+	if (listed && !mSystem->isFavorite()) {
+		// only the favorites below the displayed folder are listed
+		listed = false;
+		for (const FileData* parent = game->getParent(); parent != nullptr && !listed; parent = parent->getParent()) {
+			listed = parent == mPopulatedFolder;
+		}
+	}
 
-    // Reverse to unshift
-    if (sortType.ascending) {
-        std::reverse(favorites.begin(), favorites.end());
-    }
+	// favorites are the whole list in the favorites system, the first listingOffset items elsewhere
+	int count = mSystem->isFavorite() ? mList.size() : (int) listingOffset;
 
-    listingOffset = favorites.size();
+	if (listed) {
+		if (favorite) {
+			insertFavorite(game, count);
+			count++;
+		} else {
+			for (int i = 0; i < count; i++) {
+				if (mList.getObjectAt(i) == game) {
+					mList.removeAt(i);
+					count--;
+					break;
+				}
+			}
+		}
+	}
 
-    for (auto it = favorites.begin(); it != favorites.end(); it++) {
-        addItem(*it, true);
-    }
+	if (mSystem->isFavorite()) {
+		return;
+	}
+	listingOffset = count;
+
+	// refresh the favorite icon of the regular entry
+	for (int i = count; i < mList.size(); i++) {
+		if (mList.getObjectAt(i) == game) {
+			mList.changeCursorName(i, getItemName(game));
+			break;
+		}
+	}
 }
 
-void BasicGameListView::getFavorites(const std::vector<FileData*>& files, std::vector<FileData*>& favorites) {
-    bool showHidden = Settings::getInstance()->getBool("ShowHidden");
+void BasicGameListView::insertFavorite(FileData* game, int count) {
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+	const FileData::SortType& sortType = mSystem->getSortType();
+	FileSortIndex& sortIndex = mSystem->getSortIndex();
+
+	// favorites are sorted: binary search of the insertion point
+	int first = 0;
+	int last = count;
+	while (first < last) {
+		int middle = (first + last) / 2;
+		if (sortIndex.isBefore(mList.getObjectAt(middle), game, sortType)) {
+			first = middle + 1;
+		} else {
+			last = middle;
+		}
+	}
 
-    for (auto it = files.begin(); it != files.end(); it++) {
-        bool isGame = (*it)->getType() == GAME;
-        bool isFavorite = isGame && ((*it)->metadata.get("favorite") == "true");
-        bool isHidden = (*it)->metadata.get("hidden") == "true";
+	mList.insert(getItemName(game), game, 0, first, mSystem->isFavorite() ? game->getSortKey()[0] : 0);
+}
 
-        if (isFavorite && (showHidden || !isHidden)) {
-            favorites.push_back(*it);
-        } else if (!isGame) {
-            getFavorites((*it)->getChildren(), favorites);
+bool BasicGameListView::getFavorites(const FileData* folder, const ContentOptions& options, std::vector<FileData*>& favorites, GameDataBatchLock& lock) {
+    const std::vector<FileData*>& files = folder->getChildren();
+    for (size_t i = 0; i < files.size(); i++) {
+        FileData* file = files[i];
+        bool isGame = file->getType() == GAME;
+        bool isFavorite = isGame && (file->metadata.get("favorite") == "true");
+        bool isHidden = file->metadata.get("hidden") == "true";
+
+        if (isFavorite && (options.showHidden || !isHidden)) {
+            favorites.push_back(file);
+        } else if (!isGame && !getFavorites(file, options, favorites, lock)) {
+            return false;
+        }
+        if (!lock.next()) {
+            return false;
         }
     }
+    return true;
 }
 
 std::vector<FileData*> BasicGameListView::getFileDataList() {
@@ -189,24 +307,39 @@ std::vector<FileData*> BasicGameListView::getFileDataList() {
     return slice;
 }
 
-void BasicGameListView::addItem(FileData* file, bool toTheBeginning) {
-	std::string name = file->getName();
-	bool isGame = file->getType() == GAME;
-	bool isFavorite = isGame && (file->metadata.get("favorite") == "true");
-	bool isHidden = file->metadata.get("hidden") == "true";
+std::vector<char> BasicGameListView::getAvailableLetters() {
+	return mList.getLetters();
+}
+
+void BasicGameListView::jumpToLetter(char letter) {
+	mList.jumpToLetter(letter);
+}
 
-	if (!isGame) {
-		std::vector<FileData *> children = file->getChildren();
-		if (RecalboxConf::getInstance()->getBool(getRoot()->getSystem()->getName() + ".flatfolder")) {
-			for (auto it = children.begin(); it != children.end(); it++) {
-				addItem(*it);
+bool BasicGameListView::getItems(FileData* file, const ContentOptions& options, std::vector<FileData*>& items, GameDataBatchLock& lock) {
+	if (file->getType() != GAME) {
+		const std::vector<FileData *>& children = file->getChildren();
+		if (options.flatFolders) {
+			for (size_t i = 0; i < children.size(); i++) {
+				if (!getItems(children[i], options, items, lock)) {
+					return false;
+				}
 			}
-			return ;
+			return true;
 		} else if (file->isSingleGameFolder()) {
-            addItem(children.at(0));
-            return ;
+            items.push_back(children.at(0));
+            return lock.next();
         }
 	}
+	items.push_back(file);
+	return lock.next();
+}
+
+std::string BasicGameListView::getItemName(FileData* file) {
+	std::string name = file->getName();
+	bool isGame = file->getType() == GAME;
+	bool isFavorite = isGame && (file->metadata.get("favorite") == "true");
+	bool isHidden = file->metadata.get("hidden") == "true";
+
 	if (isHidden) {
 		name = "\uF070 " + name;
 	}
@@ -217,7 +350,16 @@ void BasicGameListView::addItem(FileData* file, bool toTheBeginning) {
 			name = "\uF006 " + name;
 		}
 	}
-	mList.add(name, file, !isGame, toTheBeginning);
+	return name;
+}
+
+void BasicGameListView::addItem(Content& content, FileData* file, bool indexed) {
+	Content::Item item;
+	item.name = getItemName(file);
+	item.file = file;
+	item.colorId = file->getType() != GAME;
+	item.letter = indexed ? file->getSortKey()[0] : 0;
+	content.items.push_back(item);
 }
 
 FileData* BasicGameListView::getCursor() {
@@ -6,7 +6,38 @@
 class BasicGameListView : public ISimpleGameListView
 {
 public:
-	BasicGameListView(Window* window, FileData* root);
+	// Displayed items of a folder. Computing them needs no GL resource, so it can be done on a worker thread.
+	struct Content
+	{
+		struct Item
+		{
+			std::string name;
+			FileData* file;
+			unsigned int colorId;
+			// initial for letter navigation, 0 for the favorites listed on top of regular items
+			char letter;
+		};
+
+		std::vector<Item> items;
+		unsigned long listingOffset;
+	};
+
+	// Settings the content depends on, read on the main thread
+	struct ContentOptions
+	{
+		explicit ContentOptions(SystemData* system);
+
+		bool showHidden;
+		bool favoritesOnly;
+		bool flatFolders;
+	};
+
+	static void prepareContent(SystemData* system, const FileData* folder, const ContentOptions& options, Content& content);
+	// Displayed name, with the hidden and favorite marks
+	static std::string getItemName(FileData* file);
+
+	// Use the given prepared content, if any, instead of populating the root folder
+	BasicGameListView(Window* window, FileData* root, const Content* content = nullptr);
 
 	// Called when a FileData* is added, has its metadata changed, or is removed
 	virtual void onFileChanged(FileData* file, FileChangeType change);
@@ -24,10 +55,13 @@ public:
 
 	virtual void populateList(const FileData* folder) override;
     virtual void refreshList() override;
+	virtual void onFavoriteChanged(FileData* game, bool favorite) override;
 
 	virtual inline void updateInfoPanel() override {}
 
 	virtual std::vector<FileData*> getFileDataList();
+	virtual std::vector<char> getAvailableLetters() override;
+	virtual void jumpToLetter(char letter) override;
 
 protected:
 	virtual void launch(FileData* game) override;
@@ -36,7 +70,13 @@ protected:
 private:
     const FileData *mPopulatedFolder;
     unsigned long listingOffset;
-	void addFavorites(const std::vector<FileData*>& files, const FileData::SortType& sortType);
-	void getFavorites(const std::vector<FileData*>& files, std::vector<FileData*>& favorites);
-	void addItem(FileData* file, bool toTheBeginning = false);
+	void setContent(const FileData* folder, const Content& content);
+	// False when a file was removed while the lock was let go, the content must then be prepared again
+	static bool tryPrepareContent(SystemData* system, const FileData* folder, const ContentOptions& options, Content& content);
+	static bool getFavorites(const FileData* folder, const ContentOptions& options, std::vector<FileData*>& favorites, GameDataBatchLock& lock);
+	// Expand a folder into the items actually displayed (flat folder, single game folder)
+	static bool getItems(FileData* file, const ContentOptions& options, std::vector<FileData*>& items, GameDataBatchLock& lock);
+	static void addItem(Content& content, FileData* file, bool indexed);
+	// Insert a favorite at its sorted place among the first count items
+	void insertFavorite(FileData* game, int count);
 };
@@ -6,8 +6,8 @@
 #include "animations/LambdaAnimation.h"
 #include "Locale.h"
 
-DetailedGameListView::DetailedGameListView(Window* window, FileData* root, SystemData* system) :
-    BasicGameListView(window, root), 
+DetailedGameListView::DetailedGameListView(Window* window, FileData* root, SystemData* system, const Content* content) :
+    BasicGameListView(window, root, content), 
     mDescContainer(window), mDescription(window), 
     mImage(window), mSystem(system), 
 
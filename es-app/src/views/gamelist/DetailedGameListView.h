@@ -9,7 +9,7 @@
 class DetailedGameListView : public BasicGameListView
 {
 public:
-    DetailedGameListView(Window* window, FileData* root, SystemData* system);
+    DetailedGameListView(Window* window, FileData* root, SystemData* system, const Content* content = nullptr);
 
     virtual void onThemeChanged(const std::shared_ptr<ThemeData>& theme) override;
 
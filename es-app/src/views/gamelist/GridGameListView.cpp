@@ -4,16 +4,37 @@
 #include "Window.h"
 #include "views/ViewController.h"
 #include "Settings.h"
+#include "SystemData.h"
+#include "FileSorts.h"
 #include "Locale.h"
 
-GridGameListView::GridGameListView(Window* window, FileData* root) : ISimpleGameListView(window, root),
-	mGrid(window)
+GridGameListView::GridGameListView(Window* window, FileData* root, const BasicGameListView::Content* content)
+	: ISimpleGameListView(window, root), mGrid(window), mTitle(window), mPopulatedFolder(nullptr), mListingOffset(0), mTitleCursor(nullptr)
 {
 	mGrid.setPosition(0, mSize.y() * 0.2f);
-	mGrid.setSize(mSize.x(), mSize.y() * 0.8f);
+	mGrid.setSize(mSize.x(), mSize.y() * 0.75f);
+	mGrid.setDefaultZIndex(20);
 	addChild(&mGrid);
 
-	populateList(root);
+	mTitle.setPosition(0, mSize.y() * 0.95f);
+	mTitle.setSize(mSize.x(), mSize.y() * 0.05f);
+	mTitle.setHorizontalAlignment(ALIGN_CENTER);
+	mTitle.setDefaultZIndex(40);
+	addChild(&mTitle);
+
+	if (content != nullptr)
+		setContent(root, *content);
+	else
+		populateList(root);
+}
+
+void GridGameListView::onThemeChanged(const std::shared_ptr<ThemeData>& theme)
+{
+	ISimpleGameListView::onThemeChanged(theme);
+	using namespace ThemeFlags;
+	mGrid.applyTheme(theme, getName(), "gamegrid", ALL);
+	mTitle.applyTheme(theme, getName(), "md_name", ALL);
+	sortChildren();
 }
 
 FileData* GridGameListView::getCursor()
@@ -21,12 +42,33 @@ FileData* GridGameListView::getCursor()
 	return mGrid.getSelected();
 }
 
+int GridGameListView::getCursorIndex()
+{
+	return mGrid.getCursorIndex();
+}
+
+void GridGameListView::setCursorIndex(int index)
+{
+	mGrid.setCursorIndex(index);
+}
+
 void GridGameListView::setCursor(FileData* file)
 {
-	if(!mGrid.setCursor(file))
+	if(!mGrid.setCursor(file, mListingOffset))
 	{
 		populateList(file->getParent());
 		mGrid.setCursor(file);
+
+		// the cursor may now be in a folder we weren't in before
+		std::stack<FileData*> tmp;
+		for(FileData* ptr = file->getParent(); ptr && ptr != mRoot; ptr = ptr->getParent())
+			tmp.push(ptr);
+		mCursorStack = std::stack<FileData*>();
+		while(!tmp.empty())
+		{
+			mCursorStack.push(tmp.top());
+			tmp.pop();
+		}
 	}
 }
 
@@ -38,24 +80,131 @@ bool GridGameListView::input(InputConfig* config, Input input)
 	return ISimpleGameListView::input(config, input);
 }
 
+void GridGameListView::update(int deltaTime)
+{
+	ISimpleGameListView::update(deltaTime);
+
+	FileData* cursor = mGrid.size() > 0 ? getCursor() : nullptr;
+	if(cursor != mTitleCursor)
+	{
+		mTitleCursor = cursor;
+		mTitle.setText(cursor != nullptr ? cursor->getName() : "");
+	}
+}
+
 void GridGameListView::populateList(const FileData* folder)
 {
-	auto files = folder->getChildren();
+	BasicGameListView::Content content;
+	BasicGameListView::prepareContent(mSystem, folder, BasicGameListView::ContentOptions(mSystem), content);
+	setContent(folder, content);
+}
+
+void GridGameListView::setContent(const FileData* folder, const BasicGameListView::Content& content)
+{
+	mPopulatedFolder = folder;
+	mHeaderText.setText(mSystem->getFullName());
+
+	// entries only hold the thumbnail paths, nothing is loaded until shown
 	mGrid.clear();
-	for(auto it = files.begin(); it != files.end(); it++)
+	for(auto it = content.items.begin(); it != content.items.end(); it++)
+		mGrid.add(it->name, it->file->getThumbnailPath(), it->file, it->letter);
+	mListingOffset = content.listingOffset;
+	mTitleCursor = nullptr;
+}
+
+void GridGameListView::refreshList()
+{
+	populateList(mPopulatedFolder);
+}
+
+// In place, as BasicGameListView does: the cursor stays on its tile
+void GridGameListView::onFavoriteChanged(FileData* game, bool favorite)
+{
+	// the favorites only filter depends on the presence of any favorite, let a full populate decide
+	if(!mSystem->isFavorite() && Settings::getInstance()->getBool("FavoritesOnly"))
+	{
+		FileData* cursor = mGrid.size() > 0 ? getCursor() : nullptr;
+		refreshList();
+		if(cursor != nullptr)
+			mGrid.setCursor(cursor);
+		return;
+	}
+
+	bool listed = Settings::getInstance()->getBool("ShowHidden") || game->metadata.get("hidden") != "true";
+	if(listed && !mSystem->isFavorite())
+	{
+		// only the favorites below the displayed folder are listed
+		listed = false;
+		for(const FileData* parent = game->getParent(); parent != nullptr && !listed; parent = parent->getParent())
+			listed = parent == mPopulatedFolder;
+	}
+
+	// favorites are the whole grid in the favorites system, the first mListingOffset tiles elsewhere
+	int count = mSystem->isFavorite() ? mGrid.size() : (int)mListingOffset;
+
+	if(listed)
 	{
-		if (Settings::getInstance()->getBool("FavoritesOnly"))
+		if(favorite)
 		{
-			if ((*it)->metadata.get("favorite").compare("true") == 0)
+			insertFavorite(game, count);
+			count++;
+		}else{
+			for(int i = 0; i < count; i++)
 			{
-				mGrid.add((*it)->getName(), (*it)->getThumbnailPath(), *it);
+				if(mGrid.getObjectAt(i) == game)
+				{
+					mGrid.removeAt(i);
+					count--;
+					break;
+				}
 			}
 		}
+	}
+
+	if(!mSystem->isFavorite())
+		mListingOffset = count;
+
+	// the title shows the cursor's
+	mTitleCursor = nullptr;
+}
+
+void GridGameListView::insertFavorite(FileData* game, int count)
+{
+	std::lock_guard<std::recursive_mutex> lock(getGameDataMutex());
+	const FileData::SortType& sortType = mSystem->getSortType();
+	FileSortIndex& sortIndex = mSystem->getSortIndex();
+
+	// favorites are sorted: binary search of the insertion point
+	int first = 0;
+	int last = count;
+	while(first < last)
+	{
+		int middle = (first + last) / 2;
+		if(sortIndex.isBefore(mGrid.getObjectAt(middle), game, sortType))
+			first = middle + 1;
 		else
-		{
-			mGrid.add((*it)->getName(), (*it)->getThumbnailPath(), *it);
-		}
+			last = middle;
 	}
+
+	mGrid.insert(BasicGameListView::getItemName(game), game->getThumbnailPath(), game, first, mSystem->isFavorite() ? game->getSortKey()[0] : 0);
+}
+
+std::vector<FileData*> GridGameListView::getFileDataList()
+{
+	std::vector<FileData*> objects;
+	for(int i = (int)mListingOffset; i < mGrid.size(); i++)
+		objects.push_back(mGrid.getObjectAt(i));
+	return objects;
+}
+
+std::vector<char> GridGameListView::getAvailableLetters()
+{
+	return mGrid.getLetters();
+}
+
+void GridGameListView::jumpToLetter(char letter)
+{
+	mGrid.jumpToLetter(letter);
 }
 
 void GridGameListView::launch(FileData* game)
@@ -72,5 +221,8 @@ std::vector<HelpPrompt> GridGameListView::getHelpPrompts()
 	prompts.push_back(HelpPrompt("b", _("LAUNCH")));
 	if(!hideSystemView)
 	  prompts.push_back(HelpPrompt("a", _("BACK")));
+	if(getRoot()->getSystem() != SystemData::getFavoriteSystem())
+	  prompts.push_back(HelpPrompt("y", _("Favorite")));
+	prompts.push_back(HelpPrompt("select", _("OPTIONS")));
 	return prompts;
 }
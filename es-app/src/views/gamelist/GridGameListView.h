@@ -1,29 +1,51 @@
 #pragma once
 
-#include "views/gamelist/ISimpleGameListView.h"
+#include "views/gamelist/BasicGameListView.h"
 #include "components/ImageGridComponent.h"
-#include "components/ImageComponent.h"
+#include "components/TextComponent.h"
 #include <stack>
 
+// Thumbnails of the games in a virtualized grid, chosen when the theme has a "grid" view
 class GridGameListView : public ISimpleGameListView
 {
 public:
-	GridGameListView(Window* window, FileData* root);
+	// Use the given prepared content, if any, instead of populating the root folder
+	GridGameListView(Window* window, FileData* root, const BasicGameListView::Content* content = nullptr);
 
-	//virtual void onThemeChanged(const std::shared_ptr<ThemeData>& theme) override;
+	virtual void onThemeChanged(const std::shared_ptr<ThemeData>& theme) override;
 
 	virtual FileData* getCursor() override;
-	virtual void setCursor(FileData*) override;
+	virtual int getCursorIndex() override;
+	virtual void setCursor(FileData* file) override;
+	virtual void setCursorIndex(int index) override;
 
 	virtual bool input(InputConfig* config, Input input) override;
+	virtual void update(int deltaTime) override;
 
 	virtual const char* getName() const override { return "grid"; }
 
 	virtual std::vector<HelpPrompt> getHelpPrompts() override;
 
-protected:
 	virtual void populateList(const FileData* folder) override;
+	virtual void refreshList() override;
+	virtual void onFavoriteChanged(FileData* game, bool favorite) override;
+
+	virtual std::vector<FileData*> getFileDataList() override;
+	virtual std::vector<char> getAvailableLetters() override;
+	virtual void jumpToLetter(char letter) override;
+
+protected:
 	virtual void launch(FileData* game) override;
 
 	ImageGridComponent<FileData*> mGrid;
+	TextComponent mTitle;
+
+private:
+	void setContent(const FileData* folder, const BasicGameListView::Content& content);
+	// Insert a favorite at its sorted place among the first count tiles
+	void insertFavorite(FileData* game, int count);
+
+	const FileData* mPopulatedFolder;
+	unsigned long mListingOffset;
+	FileData* mTitleCursor;
 };
@@ -31,8 +31,11 @@ bool IGameListView::input(InputConfig* config, Input input)
 
 void IGameListView::setTheme(const std::shared_ptr<ThemeData>& theme)
 {
+	// a reloaded theme may not change anything in this view
+	bool changed = !mTheme || !theme->getChangedElements(*mTheme, getName()).empty();
 	mTheme = theme;
-	onThemeChanged(theme);
+	if(changed)
+		onThemeChanged(theme);
 }
 
 HelpStyle IGameListView::getHelpStyle()
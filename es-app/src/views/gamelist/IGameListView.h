@@ -24,6 +24,7 @@ public:
 	// Called whenever the theme changes.
 	virtual void onThemeChanged(const std::shared_ptr<ThemeData>& theme) = 0;
 
+	// Only applied if the view's elements differ from the current theme
 	void setTheme(const std::shared_ptr<ThemeData>& theme);
 	inline const std::shared_ptr<ThemeData>& getTheme() const { return mTheme; }
 	inline FileData* getRoot() const { return mRoot; }
@@ -42,8 +43,15 @@ public:
 	virtual void populateList(const FileData* folder) = 0;
 	virtual void refreshList() = 0;
 
+	// Called when a game entered or left the favorites, to update the list without repopulating it
+	virtual void onFavoriteChanged(FileData* game, bool favorite) = 0;
+
 	virtual std::vector<FileData*> getFileDataList() = 0;
 
+	// Initials of the listed items (from their sort key), and O(1) jump to the first item of one of them
+	virtual std::vector<char> getAvailableLetters() = 0;
+	virtual void jumpToLetter(char letter) = 0;
+
 protected:
 	FileData* mRoot;
 	SystemData* mSystem;
@@ -13,7 +13,13 @@
 #include "Locale.h"
 
 ISimpleGameListView::ISimpleGameListView(Window* window, FileData* root) : IGameListView(window, root),
-mHeaderText(window), mHeaderImage(window), mBackground(window), mThemeExtras(window), mFavoriteChange(false) {
+mHeaderText(window), mHeaderImage(window), mBackground(window), mThemeExtras(window) {
+	const std::string flatFolderKey = root->getSystem()->getName() + ".flatfolder";
+	mFlatFolders = RecalboxConf::getInstance()->getBool(flatFolderKey);
+	RecalboxConf::getInstance()->addChangeCallback(flatFolderKey, this, [this](const std::string& name) {
+		mFlatFolders = RecalboxConf::getInstance()->getBool(name);
+	});
+
 	mHeaderText.setText("Logo Text");
 	mHeaderText.setSize(mSize.x(), 0);
 	mHeaderText.setPosition(0, 0);
@@ -32,6 +38,10 @@ mHeaderText(window), mHeaderImage(window), mBackground(window), mThemeExtras(win
 	addChild(&mBackground);
 }
 
+ISimpleGameListView::~ISimpleGameListView() {
+	RecalboxConf::getInstance()->removeChangeCallbacks(this);
+}
+
 void ISimpleGameListView::onThemeChanged(const std::shared_ptr<ThemeData>& theme) {
 	using namespace ThemeFlags;
 	mBackground.applyTheme(theme, getName(), "background", ALL);
@@ -65,22 +75,28 @@ void ISimpleGameListView::onThemeChanged(const std::shared_ptr<ThemeData>& theme
 
 void ISimpleGameListView::onFileChanged(FileData* file, FileChangeType change) {
 	if (change == FileChangeType::FILE_RUN) {
+		// playcount & lastplayed changed
+		SystemData::updateIndexes(file);
 		updateInfoPanel();
 		return ;
 	}
 
+	if (change == FileChangeType::FILE_METADATA_CHANGED) {
+		if (SystemData::updateIndexes(file)) {
+			ViewController::get()->onFavoriteChanged(file, file->metadata.get("favorite") == "true");
+		}
+	}
+
     if (change == FileChangeType::FILE_REMOVED) {
-        bool favorite = file->metadata.get("favorite") == "true";
-        delete file;
-        if (favorite) {
-            ViewController::get()->setInvalidGamesList(SystemData::getFavoriteSystem());
-            ViewController::get()->getSystemListView()->manageFavorite();
+        if (SystemData::removeFromIndexes(file)) {
+            ViewController::get()->onFavoriteChanged(file, false);
         }
+        delete file;
     }
 
 	FileData* cursor = getCursor();
 
-	if (RecalboxConf::getInstance()->getBool(getRoot()->getSystem()->getName() + ".flatfolder")) {
+	if (mFlatFolders) {
 		populateList(getRoot());
 	} else {
 		refreshList();
@@ -88,34 +104,6 @@ void ISimpleGameListView::onFileChanged(FileData* file, FileChangeType change) {
 
 	setCursor(cursor);
 
-
-	/* Favorite */
-	if (file->getType() == GAME) {
-		SystemData * favoriteSystem = SystemData::getFavoriteSystem();
-		bool isFavorite = file->metadata.get("favorite") == "true";
-		bool foundInFavorite = false;
-		/* Removing favorite case : */
-		for (auto gameInFavorite = favoriteSystem->getRootFolder()->getChildren().begin();
-			gameInFavorite != favoriteSystem->getRootFolder()->getChildren().end();
-			gameInFavorite ++){
-				if ((*gameInFavorite) == file) {
-					if (!isFavorite) {
-						favoriteSystem->getRootFolder()->removeAlreadyExistingChild(file);
-						ViewController::get()->setInvalidGamesList(SystemData::getFavoriteSystem());
-						ViewController::get()->getSystemListView()->manageFavorite();
-					}
-					foundInFavorite = true;
-					break;
-				}
-		}
-		/* Adding favorite case : */
-		if (!foundInFavorite && isFavorite) {
-			favoriteSystem->getRootFolder()->addAlreadyExistingChild(file);
-			ViewController::get()->setInvalidGamesList(SystemData::getFavoriteSystem());
-			ViewController::get()->getSystemListView()->manageFavorite();
-		}
-	}
-
 	updateInfoPanel();
 }
 
@@ -154,11 +142,6 @@ bool ISimpleGameListView::input(InputConfig* config, Input input) {
 			} else if (!hideSystemView) {
 				onFocusLost();
 
-				if (mFavoriteChange) {
-					ViewController::get()->setInvalidGamesList(getRoot()->getSystem());
-					mFavoriteChange = false;
-				}
-
 				ViewController::get()->goToSystemView(getRoot()->getSystem());
 			}
 			return true;
@@ -168,34 +151,15 @@ bool ISimpleGameListView::input(InputConfig* config, Input input) {
 			FileData* cursor = getCursor();
 			if (!ViewController::get()->getState().getSystem()->isFavorite() && cursor->getSystem()->getHasFavorites()) {
 				if (cursor->getType() == GAME) {
-					mFavoriteChange = true;
 					MetaDataList* md = &cursor->metadata;
-					std::string value = md->get("favorite");
-					bool removeFavorite = false;
-					SystemData *favoriteSystem = SystemData::getFavoriteSystem();
-
-					if (value == "true") {
-                        md->set("favorite", "false");
-                        if (favoriteSystem != NULL) {
-                            favoriteSystem->getRootFolder()->removeAlreadyExistingChild(cursor);
-                        }
-                        removeFavorite = true;
-					} else {
-                        md->set("favorite", "true");
-                        if (favoriteSystem != NULL) {
-                            favoriteSystem->getRootFolder()->addAlreadyExistingChild(cursor);
-                        }
-					}
+					bool favorite = md->get("favorite") != "true";
+					md->set("favorite", favorite ? "true" : "false");
 
-					if (favoriteSystem != NULL) {
-					  ViewController::get()->setInvalidGamesList(favoriteSystem);
-					  ViewController::get()->getSystemListView()->manageFavorite();
+					// favorites collections and lists are updated in place, the cursor stays on the game
+					if (SystemData::updateIndexes(cursor)) {
+						ViewController::get()->onFavoriteChanged(cursor, favorite);
+						onFavoriteChanged(cursor, favorite);
 					}
-
-					// Reload to refresh the favorite icon
-					int cursorPlace = getCursorIndex();
-                    refreshList();
-					setCursorIndex(std::max(0, cursorPlace + (removeFavorite ? -1 : 1)));
 				}
 			}
             return true;
@@ -204,10 +168,6 @@ bool ISimpleGameListView::input(InputConfig* config, Input input) {
 		if (config->isMappedTo("right", input)) {
 			if (Settings::getInstance()->getBool("QuickSystemSelect") && !hideSystemView) {
 				onFocusLost();
-				if (mFavoriteChange) {
-					ViewController::get()->setInvalidGamesList(getCursor()->getSystem());
-					mFavoriteChange = false;
-				}
 				ViewController::get()->goToNextGameList();
 				return true;
 			}
@@ -216,10 +176,6 @@ bool ISimpleGameListView::input(InputConfig* config, Input input) {
 		if (config->isMappedTo("left", input)) {
 			if (Settings::getInstance()->getBool("QuickSystemSelect") && !hideSystemView) {
 				onFocusLost();
-				if (mFavoriteChange) {
-					ViewController::get()->setInvalidGamesList(getCursor()->getSystem());
-					mFavoriteChange = false;
-				}
 				ViewController::get()->goToPrevGameList();
 				return true;
 			}
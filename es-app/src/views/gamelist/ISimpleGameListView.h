@@ -9,7 +9,7 @@ class ISimpleGameListView : public IGameListView
 {
 public:
 	ISimpleGameListView(Window* window, FileData* root);
-	virtual ~ISimpleGameListView() {}
+	virtual ~ISimpleGameListView();
 
 	// Called when a new file is added, a file is removed, a file's metadata changes, or when file sort changed
 	virtual void onFileChanged(FileData* file, FileChangeType change);
@@ -28,6 +28,9 @@ public:
 
 	virtual inline void populateList(const FileData* folder) override {}
     virtual inline void refreshList() override {};
+	virtual inline void onFavoriteChanged(FileData* game, bool favorite) override { refreshList(); }
+	virtual inline std::vector<char> getAvailableLetters() override { return std::vector<char>(); }
+	virtual inline void jumpToLetter(char letter) override {}
 
 protected:
 	virtual void launch(FileData* game) = 0;
@@ -41,5 +44,6 @@ protected:
 	std::stack<FileData*> mCursorStack;
 
 private:
-   bool mFavoriteChange;
+   // "<system>.flatfolder", kept up to date by a change callback
+   bool mFlatFolders;
 };
@@ -0,0 +1,57 @@
+// es-datindex: merges game catalogues (XML DAT files) in the index read by the offline scraper.
+// The index is looked for in ~/.emulationstation/offline/dats.idx.
+
+#include "scrapers/DatIndex.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <iostream>
+
+namespace fs = boost::filesystem;
+
+int main(int argc, char* argv[])
+{
+	if(argc < 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <index file> <dat file or directory>...\n"
+			<< "Directories are searched for .dat and .xml files\n";
+		return 1;
+	}
+
+	std::vector<std::string> dats;
+	for(int i = 2; i < argc; i++)
+	{
+		boost::system::error_code ec;
+		if(!fs::is_directory(argv[i], ec))
+		{
+			dats.push_back(argv[i]);
+			continue;
+		}
+
+		for(fs::recursive_directory_iterator it(argv[i], ec), end; !ec && it != end; it.increment(ec))
+		{
+			std::string extension = it->path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+			if(fs::is_regular_file(it->status()) && (extension == ".dat" || extension == ".xml"))
+				dats.push_back(it->path().string());
+		}
+	}
+	std::sort(dats.begin(), dats.end());
+
+	std::string error;
+	if(!DatIndex::write(dats, argv[1], error))
+	{
+		std::cerr << "Can't index: " << error << "\n";
+		return 1;
+	}
+
+	// read it back, as it will be
+	std::shared_ptr<DatIndex> index = DatIndex::open(argv[1]);
+	if(!index)
+	{
+		std::cerr << "Invalid index written to " << argv[1] << "\n";
+		return 1;
+	}
+
+	std::cout << "Indexed " << index->getGameCount() << " games from " << dats.size() << " files in " << argv[1] << "\n";
+	return 0;
+}
@@ -0,0 +1,480 @@
+// es-scrape-bench: measures the throughput of the headless scraper (emulationstation --scrape-auto) against a
+// local stand-in of the screenscraper API, so that runs are repeatable, offline and not rate limited.
+//
+// The stand-in replays the responses and images recorded in tools/scrape-bench, after a latency and at a
+// bandwidth that model the real servers:
+//   es_systems.cfg               the systems scraped, @ROMS@ being the generated rom directory
+//   responses/<system>/<title>.xml  GetGame.php answers, @SERVER@ being the stand-in url
+//   media/<system>/...           the images they reference
+// Roms are generated as "<title> (<n>)<extension>" in a temporary home, so that nothing is cached.
+
+#include <boost/asio.hpp>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace fs = boost::filesystem;
+namespace pt = boost::property_tree;
+using boost::asio::ip::tcp;
+
+#define CHUNK_SIZE	4096
+
+struct BenchOptions
+{
+	BenchOptions() : games(100), latency(100), bandwidth(512), jobs(2), keep(false) {}
+
+	int games;				// per system
+	int latency;			// ms before each response
+	int bandwidth;			// KB/s per connection, 0 for unlimited
+	int jobs;				// systems scraped at once
+	std::string fixtures;
+	std::string emulationstation;
+	bool keep;				// the temporary home is left for inspection
+};
+
+static std::string readFile(const fs::path& path)
+{
+	std::ifstream stream(path.string(), std::ios::binary);
+	std::stringstream content;
+	content << stream.rdbuf();
+	return content.str();
+}
+
+static void replaceAll(std::string& value, const std::string& from, const std::string& to)
+{
+	for(size_t pos = value.find(from); pos != std::string::npos; pos = value.find(from, pos + to.size()))
+		value.replace(pos, from.size(), to);
+}
+
+static std::string urlDecode(const std::string& value)
+{
+	std::string decoded;
+	for(size_t i = 0; i < value.size(); i++)
+	{
+		if(value[i] == '%' && i + 2 < value.size())
+		{
+			decoded += (char)strtol(value.substr(i + 1, 2).c_str(), NULL, 16);
+			i += 2;
+		}else
+			decoded += value[i] == '+' ? ' ' : value[i];
+	}
+	return decoded;
+}
+
+// "Metroid (12).nes" -> "Metroid", the title the response was recorded for
+static std::string getTitle(const std::string& romName)
+{
+	size_t end = romName.find(" (");
+	if(end == std::string::npos)
+		end = romName.find_last_of('.');
+	return romName.substr(0, end);
+}
+
+//
+// A minimal HTTP/1.1 server, a thread per connection as curl keeps them alive
+//
+class StandInServer
+{
+public:
+	StandInServer(const BenchOptions& options) : mOptions(options), mAcceptor(mIOService), mStopping(false), mRequests(0), mBytes(0) {}
+	~StandInServer() { stop(); }
+
+	bool start(std::string& error);
+	void stop();
+
+	inline const std::string& getUrl() const { return mUrl; }
+	inline size_t getRequestCount() const { return mRequests; }
+	inline size_t getBytesSent() const { return mBytes; }
+
+private:
+	void load();
+	void accept();
+	void serve(std::shared_ptr<tcp::socket> socket);
+	bool respond(tcp::socket& socket, const std::string& target, size_t rangeStart);
+	bool send(tcp::socket& socket, const std::string& status, const std::string& type, const std::string& body, const std::string& extraHeaders);
+
+	const BenchOptions& mOptions;
+	std::string mUrl;
+
+	std::map<std::string, std::string> mResponses;	// by title
+	std::map<std::string, std::string> mMedia;		// by path under media/, read once so that the disk is not measured
+
+	boost::asio::io_service mIOService;
+	tcp::acceptor mAcceptor;
+	boost::thread mAcceptThread;
+	boost::thread_group mConnections;
+	std::mutex mConnectionsMutex;
+	std::atomic<bool> mStopping;
+
+	std::atomic<size_t> mRequests;
+	std::atomic<size_t> mBytes;
+};
+
+void StandInServer::load()
+{
+	boost::system::error_code ec;
+	const fs::path responses = fs::path(mOptions.fixtures) / "responses";
+	for(fs::recursive_directory_iterator it(responses, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if(!fs::is_regular_file(it->status()) || it->path().extension() != ".xml")
+			continue;
+		std::string response = readFile(it->path());
+		replaceAll(response, "@SERVER@", mUrl);
+		mResponses[it->path().stem().string()] = response;
+	}
+
+	const fs::path media = fs::path(mOptions.fixtures) / "media";
+	for(fs::recursive_directory_iterator it(media, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if(fs::is_regular_file(it->status()))
+			mMedia[it->path().generic_string().substr(media.generic_string().size() + 1)] = readFile(it->path());
+	}
+}
+
+bool StandInServer::start(std::string& error)
+{
+	boost::system::error_code ec;
+	mAcceptor.open(tcp::v4(), ec);
+	if(!ec)
+		mAcceptor.bind(tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0), ec);
+	if(!ec)
+		mAcceptor.listen(boost::asio::socket_base::max_connections, ec);
+	if(ec)
+	{
+		error = "can't listen: " + ec.message();
+		return false;
+	}
+
+	mUrl = "http://127.0.0.1:" + std::to_string(mAcceptor.local_endpoint().port());
+	load();
+	if(mResponses.empty())
+	{
+		error = "no recorded response in " + mOptions.fixtures;
+		return false;
+	}
+
+	mAcceptThread = boost::thread(&StandInServer::accept, this);
+	return true;
+}
+
+void StandInServer::stop()
+{
+	if(!mAcceptor.is_open())
+		return;
+
+	// a last connection unblocks accept(), the others end as the scraper closes them on exit
+	mStopping = true;
+	boost::system::error_code ec;
+	tcp::socket wakeUp(mIOService);
+	wakeUp.connect(mAcceptor.local_endpoint(), ec);
+	mAcceptThread.join();
+	wakeUp.close(ec);
+	mAcceptor.close(ec);
+	mConnections.join_all();
+}
+
+void StandInServer::accept()
+{
+	while(true)
+	{
+		std::shared_ptr<tcp::socket> socket = std::make_shared<tcp::socket>(mIOService);
+		boost::system::error_code ec;
+		mAcceptor.accept(*socket, ec);
+		if(ec || mStopping)
+			return;
+
+		std::lock_guard<std::mutex> lock(mConnectionsMutex);
+		mConnections.create_thread(boost::bind(&StandInServer::serve, this, socket));
+	}
+}
+
+void StandInServer::serve(std::shared_ptr<tcp::socket> socket)
+{
+	boost::asio::streambuf buffer;
+	while(true)
+	{
+		boost::system::error_code ec;
+		boost::asio::read_until(*socket, buffer, "\r\n\r\n", ec);
+		if(ec)
+			return;
+
+		std::istream stream(&buffer);
+		std::string method, target, version;
+		stream >> method >> target >> version;
+
+		// only the headers that change the answer
+		size_t rangeStart = 0;
+		bool keepAlive = version == "HTTP/1.1";
+		std::string line;
+		std::getline(stream, line);
+		while(std::getline(stream, line) && line != "\r")
+		{
+			std::string name = line.substr(0, line.find(':'));
+			std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+			if(name == "range" && line.find("bytes=") != std::string::npos)
+				rangeStart = (size_t)strtoull(line.c_str() + line.find("bytes=") + 6, NULL, 10);
+			else if(name == "connection" && line.find("close") != std::string::npos)
+				keepAlive = false;
+		}
+
+		mRequests++;
+		if(method != "GET" || !respond(*socket, target, rangeStart) || !keepAlive)
+			return;
+	}
+}
+
+bool StandInServer::respond(tcp::socket& socket, const std::string& target, size_t rangeStart)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(mOptions.latency));
+
+	const size_t queryStart = target.find('?');
+	const std::string path = target.substr(0, queryStart);
+
+	if(path == "/api/thegamedb/GetGame.php")
+	{
+		std::string name;
+		std::stringstream query(queryStart == std::string::npos ? "" : target.substr(queryStart + 1));
+		std::string parameter;
+		while(std::getline(query, parameter, '&'))
+		{
+			if(parameter.compare(0, 5, "name=") == 0)
+				name = urlDecode(parameter.substr(5));
+		}
+
+		// not found is answered with an empty list, as the real server does
+		auto it = mResponses.find(getTitle(name));
+		return send(socket, "200 OK", "text/xml", it != mResponses.end() ? it->second : "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<Data>\n</Data>\n", "");
+	}
+
+	auto it = path.compare(0, 7, "/media/") == 0 ? mMedia.find(urlDecode(path.substr(7))) : mMedia.end();
+	if(it == mMedia.end())
+		return send(socket, "404 Not Found", "text/plain", "not found\n", "");
+
+	// resumed downloads
+	const std::string& image = it->second;
+	if(rangeStart == 0)
+		return send(socket, "200 OK", "image/png", image, "");
+	if(rangeStart >= image.size())
+		return send(socket, "416 Range Not Satisfiable", "text/plain", "", "Content-Range: bytes */" + std::to_string(image.size()) + "\r\n");
+	return send(socket, "206 Partial Content", "image/png", image.substr(rangeStart),
+		"Content-Range: bytes " + std::to_string(rangeStart) + "-" + std::to_string(image.size() - 1) + "/" + std::to_string(image.size()) + "\r\n");
+}
+
+bool StandInServer::send(tcp::socket& socket, const std::string& status, const std::string& type, const std::string& body, const std::string& extraHeaders)
+{
+	const std::string headers = "HTTP/1.1 " + status + "\r\n"
+		"Content-Type: " + type + "\r\n"
+		"Content-Length: " + std::to_string(body.size()) + "\r\n" +
+		extraHeaders + "\r\n";
+
+	boost::system::error_code ec;
+	boost::asio::write(socket, boost::asio::buffer(headers), ec);
+	if(ec)
+		return false;
+
+	// paced by chunks, each sent when the bandwidth allows it
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(size_t sent = 0; sent < body.size();)
+	{
+		const size_t chunk = std::min((size_t)CHUNK_SIZE, body.size() - sent);
+		boost::asio::write(socket, boost::asio::buffer(body.data() + sent, chunk), ec);
+		if(ec)
+			return false;
+		sent += chunk;
+		mBytes += chunk;
+
+		if(mOptions.bandwidth > 0)
+			std::this_thread::sleep_until(start + std::chrono::microseconds((long long)sent * 1000000 / (mOptions.bandwidth * 1024LL)));
+	}
+	return true;
+}
+
+// The systems of the fixtures, with roms for each recorded title, in a new home
+static bool prepareHome(const BenchOptions& options, const fs::path& home, int& gameCount, std::string& error)
+{
+	const fs::path roms = home / "roms";
+	fs::create_directories(home / ".emulationstation");
+
+	std::string systems = readFile(fs::path(options.fixtures) / "es_systems.cfg");
+	replaceAll(systems, "@ROMS@", roms.generic_string());
+	std::ofstream(home.string() + "/.emulationstation/es_systems.cfg") << systems;
+
+	pt::ptree document;
+	try
+	{
+		std::stringstream stream(systems);
+		pt::read_xml(stream, document);
+	}
+	catch(std::exception& e)
+	{
+		error = std::string("invalid es_systems.cfg: ") + e.what();
+		return false;
+	}
+
+	gameCount = 0;
+	for(auto& node : document.get_child("systemList"))
+	{
+		const std::string name = node.second.get("name", "");
+		std::string extension = node.second.get("extension", "");
+		extension = extension.substr(0, extension.find(' '));
+
+		std::vector<std::string> titles;
+		boost::system::error_code ec;
+		for(fs::directory_iterator it(fs::path(options.fixtures) / "responses" / name, ec), end; !ec && it != end; it.increment(ec))
+		{
+			if(it->path().extension() == ".xml")
+				titles.push_back(it->path().stem().string());
+		}
+		if(titles.empty())
+			continue;
+		std::sort(titles.begin(), titles.end());
+
+		const fs::path directory = node.second.get("path", "");
+		fs::create_directories(directory);
+		for(int i = 0; i < options.games; i++)
+		{
+			const std::string title = titles[i % titles.size()];
+			const std::string rom = title + " (" + std::to_string(i / titles.size() + 1) + ")" + extension;
+			std::ofstream((directory / rom).string(), std::ios::binary) << rom;
+		}
+		gameCount += options.games;
+	}
+	return true;
+}
+
+static std::string quote(const std::string& value)
+{
+	std::string quoted = value;
+	replaceAll(quoted, "'", "'\\''");
+	return "'" + quoted + "'";
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& options)
+{
+	// the fixtures are installed next to the source, the scraper next to us
+	options.fixtures = SCRAPE_BENCH_FIXTURES;
+	options.emulationstation = (fs::absolute(argv[0]).parent_path() / "emulationstation").string();
+
+	for(int i = 1; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+		if(strcmp(argv[i], "--games") == 0 && hasValue)
+			options.games = std::max(1, atoi(argv[++i]));
+		else if(strcmp(argv[i], "--latency") == 0 && hasValue)
+			options.latency = std::max(0, atoi(argv[++i]));
+		else if(strcmp(argv[i], "--bandwidth") == 0 && hasValue)
+			options.bandwidth = std::max(0, atoi(argv[++i]));
+		else if(strcmp(argv[i], "--jobs") == 0 && hasValue)
+			options.jobs = std::max(1, atoi(argv[++i]));
+		else if(strcmp(argv[i], "--fixtures") == 0 && hasValue)
+			options.fixtures = argv[++i];
+		else if(strcmp(argv[i], "--emulationstation") == 0 && hasValue)
+			options.emulationstation = argv[++i];
+		else if(strcmp(argv[i], "--keep") == 0)
+			options.keep = true;
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [options]\n"
+				<< "  --games [count]		roms per system (default is 100)\n"
+				<< "  --latency [ms]		before each response (default is 100)\n"
+				<< "  --bandwidth [KB/s]	per connection, 0 for unlimited (default is 512)\n"
+				<< "  --jobs [count]		systems scraped at once (default is 2)\n"
+				<< "  --fixtures [directory]	recorded responses and images\n"
+				<< "  --emulationstation [file]	the scraper run (default is next to " << argv[0] << ")\n"
+				<< "  --keep			keep the temporary home\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchOptions options;
+	if(!parseOptions(argc, argv, options))
+		return 1;
+
+	StandInServer server(options);
+	std::string error;
+	if(!server.start(error))
+	{
+		std::cerr << "Can't start the stand-in server: " << error << "\n";
+		return 1;
+	}
+
+	const fs::path home = fs::temp_directory_path() / fs::unique_path("es-scrape-bench-%%%%-%%%%");
+	int gameCount = 0;
+	if(!prepareHome(options, home, gameCount, error))
+	{
+		std::cerr << "Can't prepare " << home.string() << ": " << error << "\n";
+		return 1;
+	}
+
+	// headless, without any display or sound card
+	setenv("HOME", home.c_str(), 1);
+	setenv("SDL_VIDEODRIVER", "dummy", 0);
+	setenv("SDL_AUDIODRIVER", "dummy", 0);
+
+	const std::string command = quote(options.emulationstation) + " --scrape-auto --scrape-all --scrape-restart"
+		" --scrape-jobs " + std::to_string(options.jobs) + " --scrape-server " + quote(server.getUrl());
+	std::cout << "Scraping " << gameCount << " games from " << server.getUrl() << ", latency " << options.latency
+		<< " ms, bandwidth " << (options.bandwidth > 0 ? std::to_string(options.bandwidth) + " KB/s" : "unlimited") << std::endl;
+
+	// the last record of the scraper output: done <scraped> <skipped> <ms> <games per second>
+	std::vector<std::string> done;
+	FILE* scraper = popen(command.c_str(), "r");
+	if(scraper != NULL)
+	{
+		char line[4096];
+		while(fgets(line, sizeof(line), scraper) != NULL)
+		{
+			if(strncmp(line, "done\t", 5) != 0)
+				continue;
+			std::stringstream record(line);
+			std::string field;
+			done.clear();
+			while(std::getline(record, field, '\t'))
+				done.push_back(field);
+		}
+		pclose(scraper);
+	}
+	server.stop();
+
+	boost::system::error_code ec;
+	if(!options.keep)
+		fs::remove_all(home, ec);
+	else
+		std::cout << "Home kept in " << home.string() << "\n";
+
+	if(done.size() < 5)
+	{
+		std::cerr << "The scraper did not complete, see " << options.emulationstation << " --scrape-auto\n";
+		return 1;
+	}
+
+	std::cout << "Scraped " << done[1] << " games, " << done[2] << " skipped, in " << atoi(done[3].c_str()) / 1000.0f << " s: "
+		<< atof(done[4].c_str()) << " games/s\n";
+	std::cout << "Served " << server.getRequestCount() << " requests, " << server.getBytesSent() / 1024 << " KB\n";
+
+	// every game is served, so any game not scraped is a failure
+	if(atoi(done[1].c_str()) != gameCount || atoi(done[2].c_str()) != 0)
+	{
+		std::cerr << "Expected " << gameCount << " games scraped and none skipped\n";
+		return 1;
+	}
+	return 0;
+}
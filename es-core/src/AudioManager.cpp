@@ -9,6 +9,7 @@
 #include "Settings.h"
 #include "ThemeData.h"
 #include "Locale.h"
+#include "resources/ResourceManager.h"
 #include <unistd.h>
 #include <time.h>
 #include <views/ViewController.h>
@@ -97,13 +98,13 @@ void AudioManager::themeChanged(const std::shared_ptr<ThemeData>& theme)
   if (RecalboxConf::getInstance()->get("audio.bgmusic") == "1")
   {
     const ThemeData::ThemeElement* elem = theme->getElement("system", "directory", "sound");
-    if (!elem || !elem->has("path"))
+    if (!elem || !elem->has(ThemeProperty::PATH))
     {
       currentThemeMusicDirectory = "";
     }
     else
     {
-      currentThemeMusicDirectory = elem->get<std::string>("path");
+      currentThemeMusicDirectory = elem->get<std::string>(ThemeProperty::PATH);
     }
 
     std::shared_ptr<Music> bgsound = Music::getFromTheme(theme, "system", "bgsound");
@@ -236,13 +237,25 @@ void AudioManager::stop()
 std::vector<std::string> getMusicIn(const std::string& path)
 {
   std::vector<std::string> all_matching_files;
+  const boost::regex my_filter(".*\\.(mp3|ogg)$");
+
+  // A directory of a theme pack
+  std::vector<std::string> packed = ResourceManager::getInstance()->getPackedFiles(path);
+  for (auto it = packed.begin(); it != packed.end(); it++)
+  {
+    boost::smatch what;
+    if (boost::regex_match(*it, what, my_filter)) { all_matching_files.push_back(*it); }
+  }
+  if (!packed.empty())
+  {
+    return all_matching_files;
+  }
 
   if (!boost::filesystem::is_directory(path))
   {
     return all_matching_files;
   }
   const std::string target_path(path);
-  const boost::regex my_filter(".*\\.(mp3|ogg)$");
 
 
   boost::filesystem::recursive_directory_iterator end_itr; // Default ctor yields past-the-end
@@ -259,6 +272,7 @@ std::vector<std::string> getMusicIn(const std::string& path)
     // File matches, store it
     all_matching_files.push_back(i->path().string());
   }
+  return all_matching_files;
 }
 
 std::shared_ptr<Music> AudioManager::getRandomMusic(std::string themeSoundDirectory)
@@ -295,12 +309,12 @@ void AudioManager::playCheckSound()
   std::string selectedTheme = Settings::getInstance()->getString("ThemeSet");
   std::string loadingMusic = getHomePath() + "/.emulationstation/themes/" + selectedTheme + "/fx/loading.ogg";
 
-  if (boost::filesystem::exists(loadingMusic) == false)
+  if (ResourceManager::getInstance()->fileExists(loadingMusic) == false)
   {
     loadingMusic = "/recalbox/share_init/system/.emulationstation/themes/recalbox/fx/loading.ogg";
   }
 
-  if (boost::filesystem::exists(loadingMusic))
+  if (ResourceManager::getInstance()->fileExists(loadingMusic))
   {
     Music::get(loadingMusic)->play(false, NULL);
   }
@@ -0,0 +1,120 @@
+#include "FileWatcher.h"
+#include "Log.h"
+#include <boost/filesystem.hpp>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+#if defined(__linux__)
+#define WATCH_EVENTS	(IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF)
+#endif
+
+FileWatcher::FileWatcher() : mFd(-1)
+{
+#if defined(__linux__)
+	mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(mFd < 0)
+		LOG(LogWarning) << "inotify is not available, file changes will not be watched";
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#if defined(__linux__)
+	if(mFd >= 0)
+		close(mFd);
+#endif
+}
+
+bool FileWatcher::watch(const std::string& directory, bool recursive)
+{
+#if defined(__linux__)
+	if(mFd < 0)
+		return false;
+
+	int wd = inotify_add_watch(mFd, directory.c_str(), WATCH_EVENTS | IN_ONLYDIR);
+	if(wd < 0)
+		return false;
+
+	Watch& watch = mWatches[wd];
+	watch.path = directory;
+	watch.recursive = recursive;
+
+	if(recursive)
+	{
+		boost::system::error_code ec;
+		for(fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec))
+			if(fs::is_directory(it->status()))
+				this->watch(it->path().generic_string(), true);
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void FileWatcher::clear()
+{
+#if defined(__linux__)
+	for(auto it = mWatches.begin(); it != mWatches.end(); it++)
+		inotify_rm_watch(mFd, it->first);
+#endif
+	mWatches.clear();
+}
+
+bool FileWatcher::poll(std::vector<std::string>& changes)
+{
+#if defined(__linux__)
+	if(mFd < 0)
+		return false;
+
+	bool complete = true;
+	char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	while(true)
+	{
+		ssize_t length = read(mFd, buffer, sizeof(buffer));
+		if(length <= 0)
+			break;
+
+		for(char* ptr = buffer; ptr < buffer + length; )
+		{
+			const struct inotify_event* event = (const struct inotify_event*)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			if(event->mask & IN_Q_OVERFLOW)
+			{
+				complete = false;
+				continue;
+			}
+
+			auto it = mWatches.find(event->wd);
+			if(it == mWatches.end())
+				continue;
+
+			// the directory is gone, and its watch with it
+			if(event->mask & IN_IGNORED)
+			{
+				mWatches.erase(it);
+				continue;
+			}
+
+			std::string path = it->second.path;
+			if(event->len > 0)
+				path += std::string("/") + event->name;
+
+			if((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)) && it->second.recursive)
+				watch(path, true);
+
+			changes.push_back(path);
+		}
+	}
+	return complete;
+#else
+	return false;
+#endif
+}
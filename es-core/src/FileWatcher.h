@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+//
+// Tells which files changed in a set of watched directories, using inotify.
+// Nothing runs in the background: events queue up in the kernel until poll() reads them,
+// so checking for changes costs a single system call when there are none.
+// Not thread safe, callers guard it along with what it keeps up to date.
+//
+class FileWatcher
+{
+public:
+	FileWatcher();
+	~FileWatcher();
+
+	// False where inotify is not available: poll() then always reports everything changed
+	inline bool isAvailable() const { return mFd >= 0; }
+
+	// Watch the files of a directory, and of all its subdirectories if recursive (including the ones created later).
+	// Returns false if the directory can't be watched.
+	bool watch(const std::string& directory, bool recursive);
+	// Stop watching everything
+	void clear();
+
+	// Add the paths created, written, deleted or moved since the last call to changes.
+	// Returns false if changes may have been missed (no inotify, event queue overflow):
+	// callers must then consider everything changed.
+	bool poll(std::vector<std::string>& changes);
+
+private:
+	struct Watch
+	{
+		std::string path;
+		bool recursive;
+	};
+
+	int mFd;
+	std::map<int, Watch> mWatches;
+};
@@ -7,7 +7,8 @@
 #include "Settings.h"
 
 GuiComponent::GuiComponent(Window* window) : mWindow(window), mParent(NULL), mOpacity(255), 
-	mPosition(Eigen::Vector3f::Zero()), mOrigin(Eigen::Vector2f::Zero()), mRotationOrigin(0.5, 0.5), mSize(Eigen::Vector2f::Zero()), mTransform(Eigen::Affine3f::Identity()), mIsProcessing(false)
+	mPosition(Eigen::Vector3f::Zero()), mOrigin(Eigen::Vector2f::Zero()), mRotationOrigin(0.5, 0.5), mSize(Eigen::Vector2f::Zero()), mTransform(Eigen::Affine3f::Identity()), mIsProcessing(false),
+	mUpdateReasons(0), mUpdatingCount(0)
 {
 	for(unsigned char i = 0; i < MAX_ANIMATIONS; i++)
 		mAnimationMap[i] = NULL;
@@ -47,10 +48,32 @@ void GuiComponent::updateChildren(int deltaTime)
 {
 	for(unsigned int i = 0; i < getChildCount(); i++)
 	{
-		getChild(i)->update(deltaTime);
+		// idle children cost nothing: most of the tree neither animates nor has timers
+		GuiComponent* child = getChild(i);
+		if(child->isUpdating())
+			child->update(deltaTime);
 	}
 }
 
+void GuiComponent::setUpdating(bool updating, UpdateReason reason)
+{
+	const unsigned char reasons = updating ? (mUpdateReasons | reason) : (mUpdateReasons & ~reason);
+	if(reasons == mUpdateReasons)
+		return;
+
+	if(mUpdateReasons == 0)
+		changeUpdatingCount(1);
+	else if(reasons == 0)
+		changeUpdatingCount(-1);
+	mUpdateReasons = reasons;
+}
+
+void GuiComponent::changeUpdatingCount(int delta)
+{
+	for(GuiComponent* cmp = this; cmp != NULL; cmp = cmp->mParent)
+		cmp->mUpdatingCount += delta;
+}
+
 void GuiComponent::update(int deltaTime)
 {
 	updateSelf(deltaTime);
@@ -223,7 +246,14 @@ GuiComponent* GuiComponent::getChild(unsigned int i) const
 
 void GuiComponent::setParent(GuiComponent* parent)
 {
+	// the whole subtree moves, with what it has to update
+	if(mParent && mUpdatingCount)
+		mParent->changeUpdatingCount(-mUpdatingCount);
+
 	mParent = parent;
+
+	if(mParent && mUpdatingCount)
+		mParent->changeUpdatingCount(mUpdatingCount);
 }
 
 GuiComponent* GuiComponent::getParent() const
@@ -301,6 +331,8 @@ void GuiComponent::setAnimation(Animation* anim, int delay, std::function<void()
 
 	AnimationController* oldAnim = mAnimationMap[slot];
 	mAnimationMap[slot] = new AnimationController(anim, delay, finishedCallback, reverse);
+	if(!oldAnim)
+		changeUpdatingCount(1);
 
 	if(oldAnim)
 		delete oldAnim;
@@ -313,6 +345,7 @@ bool GuiComponent::stopAnimation(unsigned char slot)
 	{
 		delete mAnimationMap[slot];
 		mAnimationMap[slot] = NULL;
+		changeUpdatingCount(-1);
 		return true;
 	}else{
 		return false;
@@ -327,6 +360,7 @@ bool GuiComponent::cancelAnimation(unsigned char slot)
 		mAnimationMap[slot]->removeFinishedCallback();
 		delete mAnimationMap[slot];
 		mAnimationMap[slot] = NULL;
+		changeUpdatingCount(-1);
 		return true;
 	}else{
 		return false;
@@ -344,6 +378,7 @@ bool GuiComponent::finishAnimation(unsigned char slot)
 
 		delete mAnimationMap[slot]; // will also call finishedCallback
 		mAnimationMap[slot] = NULL;
+		changeUpdatingCount(-1);
 		return true;
 	}else{
 		return false;
@@ -360,6 +395,7 @@ bool GuiComponent::advanceAnimation(unsigned char slot, unsigned int time)
 		if(done)
 		{
 			mAnimationMap[slot] = NULL;
+			changeUpdatingCount(-1);
 			delete anim;
 		}
 		return true;
@@ -416,28 +452,28 @@ void GuiComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const std
 		return;
 
 	using namespace ThemeFlags;
-	if(properties & POSITION && elem->has("pos"))
+	if(properties & POSITION && elem->has(ThemeProperty::POS))
 	{
-		Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>("pos").cwiseProduct(scale);
+		Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>(ThemeProperty::POS).cwiseProduct(scale);
 		setPosition(Eigen::Vector3f(denormalized.x(), denormalized.y(), 0));
 	}
 
-	if(properties & ThemeFlags::SIZE && elem->has("size"))
-		setSize(elem->get<Eigen::Vector2f>("size").cwiseProduct(scale));
+	if(properties & ThemeFlags::SIZE && elem->has(ThemeProperty::SIZE))
+		setSize(elem->get<Eigen::Vector2f>(ThemeProperty::SIZE).cwiseProduct(scale));
 
 	// position + size also implies origin
-	if((properties & ORIGIN || (properties & POSITION && properties & ThemeFlags::SIZE)) && elem->has("origin"))
-		setOrigin(elem->get<Eigen::Vector2f>("origin"));
+	if((properties & ORIGIN || (properties & POSITION && properties & ThemeFlags::SIZE)) && elem->has(ThemeProperty::ORIGIN))
+		setOrigin(elem->get<Eigen::Vector2f>(ThemeProperty::ORIGIN));
 
 	if(properties & ThemeFlags::ROTATION) {
-		if(elem->has("rotation"))
-			setRotationDegrees(elem->get<float>("rotation"));
-		if(elem->has("rotationOrigin"))
-			setRotationOrigin(elem->get<Eigen::Vector2f>("rotationOrigin"));
+		if(elem->has(ThemeProperty::ROTATION))
+			setRotationDegrees(elem->get<float>(ThemeProperty::ROTATION));
+		if(elem->has(ThemeProperty::ROTATION_ORIGIN))
+			setRotationOrigin(elem->get<Eigen::Vector2f>(ThemeProperty::ROTATION_ORIGIN));
 	}
 	
-	if(properties & ThemeFlags::Z_INDEX && elem->has("zIndex"))
-		setZIndex(elem->get<float>("zIndex"));
+	if(properties & ThemeFlags::Z_INDEX && elem->has(ThemeProperty::Z_INDEX))
+		setZIndex(elem->get<float>(ThemeProperty::Z_INDEX));
 	else
 		setZIndex(getDefaultZIndex());
 }
@@ -10,6 +10,7 @@ class Animation;
 class AnimationController;
 class ThemeData;
 class Font;
+class TextureResource;
 
 typedef std::pair<std::string, std::string> HelpPrompt;
 
@@ -26,8 +27,12 @@ public:
 	virtual bool input(InputConfig* config, Input input);
 
 	//Called when time passes.  Default implementation calls updateSelf(deltaTime) and updateChildren(deltaTime) - so you should probably call GuiComponent::update(deltaTime) at some point (or at least updateSelf so animations work).
+	//Children are only updated while isUpdating(): a component with timers of its own must register them with setUpdating.
 	virtual void update(int deltaTime);
 
+	// True if this component or one of its children plays an animation or registered for updates
+	inline bool isUpdating() const { return mUpdatingCount > 0; }
+
 	//Called when it's time to render.  By default, just calls renderChildren(parentTrans * getTransform()).
 	//You probably want to override this like so:
 	//1. Calculate the new transform that your control will draw at with Eigen::Affine3f t = parentTrans * getTransform().
@@ -118,6 +123,9 @@ public:
 	// Returns a list of help prompts.
 	virtual std::vector<HelpPrompt> getHelpPrompts() { return std::vector<HelpPrompt>(); };
 
+	// Textures drawn by this component, for views that manage which ones stay in memory
+	virtual void getTextures(std::vector< std::shared_ptr<TextureResource> >& textures) const {};
+
 	// Called whenever help prompts change.
 	void updateHelpPrompts();
 	
@@ -133,6 +141,17 @@ protected:
 	void updateSelf(int deltaTime); // updates animations
 	void updateChildren(int deltaTime); // updates animations
 
+	// Reasons a component can register for update() calls, when a class and its base both need to
+	enum UpdateReason : unsigned char
+	{
+		UPDATE_TIMER = 1,
+		UPDATE_LIST = 2
+	};
+
+	// Register for update() calls while a timer, a scrolling or a marquee runs, unregister once it is done.
+	// The component stays registered while any reason is set.
+	void setUpdating(bool updating, UpdateReason reason = UPDATE_TIMER);
+
     Eigen::Vector2f denormalise(float x, float y);
     Eigen::Vector2f denormalise(Eigen::Vector2f value);
 
@@ -159,6 +178,13 @@ public:
 	const static unsigned char MAX_ANIMATIONS = 4;
 
 private:
+	// add to the update count of this component and its parents
+	void changeUpdatingCount(int delta);
+
 	Eigen::Affine3f mTransform; //Don't access this directly! Use getTransform()!
 	AnimationController* mAnimationMap[MAX_ANIMATIONS];
+
+	unsigned char mUpdateReasons;
+	// animations playing and update reasons set, here and in every child
+	int mUpdatingCount;
 };
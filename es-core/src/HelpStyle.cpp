@@ -24,48 +24,48 @@ void HelpStyle::applyTheme(const std::shared_ptr<ThemeData>& theme, const std::s
 	if(!elem)
 		return;
 
-	if(elem->has("pos"))
-		position = elem->get<Eigen::Vector2f>("pos").cwiseProduct(Eigen::Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight()));
+	if(elem->has(ThemeProperty::POS))
+		position = elem->get<Eigen::Vector2f>(ThemeProperty::POS).cwiseProduct(Eigen::Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight()));
 
-	if(elem->has("textColor"))
-		textColor = elem->get<unsigned int>("textColor");
+	if(elem->has(ThemeProperty::TEXT_COLOR))
+		textColor = elem->get<unsigned int>(ThemeProperty::TEXT_COLOR);
 
-	if(elem->has("iconColor"))
-		iconColor = elem->get<unsigned int>("iconColor");
+	if(elem->has(ThemeProperty::ICON_COLOR))
+		iconColor = elem->get<unsigned int>(ThemeProperty::ICON_COLOR);
 
-	if(elem->has("fontPath") || elem->has("fontSize"))
+	if(elem->has(ThemeProperty::FONT_PATH) || elem->has(ThemeProperty::FONT_SIZE))
 		font = Font::getFromTheme(elem, ThemeFlags::ALL, font);
 	
-	if(elem->has("iconUpDown"))
-		iconMap["up/down"] = elem->get<std::string>("iconUpDown");
+	if(elem->has(ThemeProperty::ICON_UP_DOWN))
+		iconMap["up/down"] = elem->get<std::string>(ThemeProperty::ICON_UP_DOWN);
 	
-	if(elem->has("iconLeftRight"))
-		iconMap["left/right"] = elem->get<std::string>("iconLeftRight");
+	if(elem->has(ThemeProperty::ICON_LEFT_RIGHT))
+		iconMap["left/right"] = elem->get<std::string>(ThemeProperty::ICON_LEFT_RIGHT);
 	
-	if(elem->has("iconUpDownLeftRight"))
-		iconMap["up/down/left/right"] = elem->get<std::string>("iconUpDownLeftRight");
+	if(elem->has(ThemeProperty::ICON_UP_DOWN_LEFT_RIGHT))
+		iconMap["up/down/left/right"] = elem->get<std::string>(ThemeProperty::ICON_UP_DOWN_LEFT_RIGHT);
 	
-	if(elem->has("iconA"))
-		iconMap["a"] = elem->get<std::string>("iconA");
+	if(elem->has(ThemeProperty::ICON_A))
+		iconMap["a"] = elem->get<std::string>(ThemeProperty::ICON_A);
 	
-	if(elem->has("iconB"))
-		iconMap["b"] = elem->get<std::string>("iconB");
+	if(elem->has(ThemeProperty::ICON_B))
+		iconMap["b"] = elem->get<std::string>(ThemeProperty::ICON_B);
 	
-	if(elem->has("iconX"))
-		iconMap["x"] = elem->get<std::string>("iconX");
+	if(elem->has(ThemeProperty::ICON_X))
+		iconMap["x"] = elem->get<std::string>(ThemeProperty::ICON_X);
 	
-	if(elem->has("iconY"))
-		iconMap["y"] = elem->get<std::string>("iconY");
+	if(elem->has(ThemeProperty::ICON_Y))
+		iconMap["y"] = elem->get<std::string>(ThemeProperty::ICON_Y);
 	
-	if(elem->has("iconL"))
-		iconMap["l"] = elem->get<std::string>("iconL");
+	if(elem->has(ThemeProperty::ICON_L))
+		iconMap["l"] = elem->get<std::string>(ThemeProperty::ICON_L);
 	
-	if(elem->has("iconR"))
-		iconMap["r"] = elem->get<std::string>("iconR");
+	if(elem->has(ThemeProperty::ICON_R))
+		iconMap["r"] = elem->get<std::string>(ThemeProperty::ICON_R);
 	
-	if(elem->has("iconStart"))
-		iconMap["start"] = elem->get<std::string>("iconStart");
+	if(elem->has(ThemeProperty::ICON_START))
+		iconMap["start"] = elem->get<std::string>(ThemeProperty::ICON_START);
 	
-	if(elem->has("iconSelect"))
-		iconMap["select"] = elem->get<std::string>("iconSelect");
+	if(elem->has(ThemeProperty::ICON_SELECT))
+		iconMap["select"] = elem->get<std::string>(ThemeProperty::ICON_SELECT);
 }
@@ -1,11 +1,237 @@
 #include <iostream>
 #include "HttpReq.h"
 #include "Log.h"
+#include "Util.h"
 #include <boost/filesystem.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <thread>
 
-CURLM* HttpReq::s_multi_handle = curl_multi_init();
+// connections opened at once to a host, more requests wait for one (or share it with HTTP/2)
+#define MAX_HOST_CONNECTIONS	4
+#define MAX_IDLE_HANDLES		8
+// without curl_multi_wakeup, how long new requests may wait for the I/O thread
+#define POLL_TIMEOUT_MS			50
 
-std::map<CURL*, HttpReq*> HttpReq::s_requests;
+//
+// Runs all the transfers: it alone drives the multi handle, so the network progresses whatever the frame rate,
+// and TLS or decompression work doesn't take time from the UI.
+// Requests are posted to it through a lock-free queue. It publishes their completion in HttpReq::mStatus,
+// stored last so that the content, file and error message are complete once a caller sees it.
+// Started with the first request, stopped when the program exits.
+//
+class HttpReq::IOThread
+{
+public:
+	IOThread() : mThread(NULL), mExit(false), mCommands(64) {}
+	~IOThread();
+
+	void post(HttpReq* request, bool cancel);
+	// Wait until the thread dropped a request posted for cancellation
+	void waitCancelled(HttpReq* request);
+
+private:
+	struct Command
+	{
+		HttpReq* request;
+		bool cancel;
+	};
+
+	void run();
+	void wakeUp();
+
+	std::thread* mThread;
+	std::once_flag mStarted;
+	std::atomic<bool> mExit;
+	boost::lockfree::queue<Command> mCommands;
+
+	std::mutex mCancelMutex;
+	std::condition_variable mCancelled;
+
+	// only used by the thread
+	//god dammit libcurl why can't you have some way to check the status of an individual handle
+	//why do I have to handle ALL messages at once
+	std::map<CURL*, HttpReq*> mRequests;
+};
+
+CURLM* HttpReq::s_multi_handle = HttpReq::initMultiHandle();
+CURLSH* HttpReq::s_share_handle = HttpReq::initShareHandle();
+std::mutex HttpReq::s_share_locks[CURL_LOCK_DATA_LAST];
+std::vector<CURL*> HttpReq::s_idle_handles;
+std::mutex HttpReq::s_idle_handles_mutex;
+
+// last, to be stopped before the handles it uses are gone
+HttpReq::IOThread HttpReq::s_io_thread;
+
+HttpReq::IOThread::~IOThread()
+{
+	if(mThread == NULL)
+		return;
+
+	mExit = true;
+	wakeUp();
+	mThread->join();
+	delete mThread;
+}
+
+void HttpReq::IOThread::post(HttpReq* request, bool cancel)
+{
+	std::call_once(mStarted, [this] { mThread = new std::thread(&HttpReq::IOThread::run, this); });
+
+	Command command = { request, cancel };
+	mCommands.push(command);
+	wakeUp();
+}
+
+void HttpReq::IOThread::waitCancelled(HttpReq* request)
+{
+	std::unique_lock<std::mutex> lock(mCancelMutex);
+	mCancelled.wait(lock, [request] { return request->mCancelled; });
+}
+
+void HttpReq::IOThread::wakeUp()
+{
+#if LIBCURL_VERSION_NUM >= 0x074400
+	curl_multi_wakeup(s_multi_handle);
+#endif
+}
+
+void HttpReq::IOThread::run()
+{
+	while(!mExit)
+	{
+		Command command;
+		while(mCommands.pop(command))
+		{
+			HttpReq* req = command.request;
+			if(!command.cancel)
+			{
+				// hashing what an interrupted download left takes a while, not to be done by the caller
+				if(!req->mPath.empty() && !req->openPart())
+				{
+					req->onError(("Cannot open " + req->mPath + ".part to write").c_str());
+					req->mStatus = REQ_IO_ERROR;
+					continue;
+				}
+
+				CURLMcode merr = curl_multi_add_handle(s_multi_handle, req->mHandle);
+				if(merr != CURLM_OK)
+				{
+					LOG(LogError) << "Error adding curl_easy handle to curl_multi: " << curl_multi_strerror(merr);
+					req->onDone(CURLE_FAILED_INIT);
+					continue;
+				}
+				mRequests[req->mHandle] = req;
+				continue;
+			}
+
+			// the request may be done already
+			auto it = mRequests.find(req->mHandle);
+			if(it != mRequests.end())
+			{
+				curl_multi_remove_handle(s_multi_handle, req->mHandle);
+				mRequests.erase(it);
+			}
+			{
+				std::unique_lock<std::mutex> lock(mCancelMutex);
+				req->mCancelled = true;
+			}
+			mCancelled.notify_all();
+		}
+
+		int handle_count;
+		CURLMcode merr = curl_multi_perform(s_multi_handle, &handle_count);
+		if(merr != CURLM_OK && merr != CURLM_CALL_MULTI_PERFORM)
+			LOG(LogError) << "curl_multi_perform failed: " << curl_multi_strerror(merr);
+
+		// messages don't survive curl_multi_remove_handle
+		std::vector< std::pair<CURL*, CURLcode> > done;
+		int msgs_left;
+		CURLMsg* msg;
+		while((msg = curl_multi_info_read(s_multi_handle, &msgs_left)))
+		{
+			if(msg->msg == CURLMSG_DONE)
+				done.push_back(std::make_pair(msg->easy_handle, msg->data.result));
+		}
+
+		for(auto it = done.begin(); it != done.end(); it++)
+		{
+			auto request = mRequests.find(it->first);
+			if(request == mRequests.end())
+			{
+				LOG(LogError) << "Cannot find easy handle!";
+				continue;
+			}
+
+			HttpReq* req = request->second;
+			mRequests.erase(request);
+			curl_multi_remove_handle(s_multi_handle, it->first);
+			// the request is the caller's again from there
+			req->onDone(it->second);
+		}
+
+#if LIBCURL_VERSION_NUM >= 0x074400
+		// until there is something to do, or a request is posted
+		curl_multi_poll(s_multi_handle, NULL, 0, 1000, NULL);
+#else
+		curl_multi_wait(s_multi_handle, NULL, 0, POLL_TIMEOUT_MS, NULL);
+#endif
+	}
+
+	for(auto it = mRequests.begin(); it != mRequests.end(); it++)
+		curl_multi_remove_handle(s_multi_handle, it->first);
+	mRequests.clear();
+}
+
+CURLM* HttpReq::initMultiHandle()
+{
+	CURLM* multi = curl_multi_init();
+	// open connections are kept in the multi handle and reused by the next requests
+#if LIBCURL_VERSION_NUM >= 0x071e00
+	curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)MAX_HOST_CONNECTIONS);
+#endif
+#if defined(CURLPIPE_MULTIPLEX)
+	curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+	return multi;
+}
+
+CURLSH* HttpReq::initShareHandle()
+{
+	// handles are set up and cleaned up by the callers while the I/O thread uses the caches
+	CURLSH* share = curl_share_init();
+	curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &HttpReq::lock_share);
+	curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, &HttpReq::unlock_share);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+	return share;
+}
+
+void HttpReq::lock_share(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+	s_share_locks[data].lock();
+}
+
+void HttpReq::unlock_share(CURL* handle, curl_lock_data data, void* userptr)
+{
+	s_share_locks[data].unlock();
+}
+
+CURL* HttpReq::takeEasyHandle()
+{
+	std::unique_lock<std::mutex> lock(s_idle_handles_mutex);
+	if(s_idle_handles.empty())
+		return curl_easy_init();
+
+	// reset keeps the handle's connections and caches
+	CURL* handle = s_idle_handles.back();
+	s_idle_handles.pop_back();
+	curl_easy_reset(handle);
+	return handle;
+}
 
 std::string HttpReq::urlEncode(const std::string &s)
 {
@@ -37,9 +263,84 @@ bool HttpReq::isUrl(const std::string& str)
 }
 
 HttpReq::HttpReq(const std::string& url)
-	: mStatus(REQ_IN_PROGRESS), mHandle(NULL)
+	: mHandle(NULL), mStatus(REQ_IN_PROGRESS), mUrl(url), mFile(NULL), mResumeFrom(0), mResumeChecked(true), mHeaders(NULL), mDownloaded(0), mTotalSize(0), mCrc32(0), mCancelled(false)
+{
+	start(url);
+}
+
+// the .part is opened by the I/O thread, see openPart()
+HttpReq::HttpReq(const std::string& url, const std::string& path)
+	: mHandle(NULL), mStatus(REQ_IN_PROGRESS), mUrl(url), mPath(path), mFile(NULL), mResumeFrom(0), mResumeChecked(false), mHeaders(NULL), mDownloaded(0), mTotalSize(0), mCrc32(0), mCancelled(false)
+{
+	start(url);
+}
+
+bool HttpReq::openPart()
+{
+	const std::string part = mPath + ".part";
+
+	// the URL a .part came from and the validator of its content, one per line
+	std::string url, validator;
+	std::ifstream info(part + ".info");
+	std::getline(info, url);
+	std::getline(info, validator);
+	info.close();
+
+	// names are not unique to a URL, another file's start is not resumed
+	boost::system::error_code ec;
+	if(url != mUrl)
+	{
+		boost::filesystem::remove(part, ec);
+		boost::filesystem::remove(part + ".info", ec);
+	}
+
+	// what an interrupted download left is hashed again, so the CRC stays the one of the whole file
+	FILE* existing = fopen(part.c_str(), "rb");
+	if(existing != NULL)
+	{
+		char buffer[64 * 1024];
+		size_t read;
+		while((read = fread(buffer, 1, sizeof(buffer), existing)) > 0)
+		{
+			mCrc32 = crc32(mCrc32, buffer, read);
+			mResumeFrom += read;
+		}
+		fclose(existing);
+	}
+
+	mDownloaded = mResumeFrom;
+	mFile = fopen(part.c_str(), "ab");
+
+	// a plain Range header rather than CURLOPT_RESUME_FROM, that fails when the server sends the whole file
+	if(mResumeFrom > 0)
+	{
+		curl_easy_setopt(mHandle, CURLOPT_RANGE, (std::to_string(mResumeFrom) + "-").c_str());
+		// the server sends the whole file again if it changed since
+		if(!validator.empty())
+		{
+			mHeaders = curl_slist_append(mHeaders, ("If-Range: " + validator).c_str());
+			curl_easy_setopt(mHandle, CURLOPT_HTTPHEADER, mHeaders);
+		}
+	}
+
+	return mFile != NULL;
+}
+
+// Where the .part comes from, written once the response starts
+bool HttpReq::writePartInfo()
 {
-	mHandle = curl_easy_init();
+	// a strong ETag, or the date of the file; If-Range takes no weak ETag
+	const std::string& validator = (!mETag.empty() && mETag.compare(0, 2, "W/") != 0) ? mETag : mLastModified;
+
+	std::ofstream info(mPath + ".part.info", std::ios::trunc);
+	info << mUrl << "\n" << validator << "\n";
+	info.close();
+	return !info.fail();
+}
+
+void HttpReq::start(const std::string& url)
+{
+	mHandle = takeEasyHandle();
 
 	if(mHandle == NULL)
 	{
@@ -48,6 +349,28 @@ HttpReq::HttpReq(const std::string& url)
 		return;
 	}
 
+	// best effort, older libcurl versions just ignore what they don't know
+	curl_easy_setopt(mHandle, CURLOPT_SHARE, s_share_handle);
+#if LIBCURL_VERSION_NUM >= 0x071900
+	curl_easy_setopt(mHandle, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+#if defined(CURL_HTTP_VERSION_2TLS)
+	curl_easy_setopt(mHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	// rather wait for a connection able to multiplex than open a new one
+	curl_easy_setopt(mHandle, CURLOPT_PIPEWAIT, 1L);
+#endif
+
+	if(!mPath.empty())
+	{
+		// an error page is not the file
+		curl_easy_setopt(mHandle, CURLOPT_FAILONERROR, 1L);
+		// for the validator of the content
+		curl_easy_setopt(mHandle, CURLOPT_HEADERFUNCTION, &HttpReq::write_header);
+		curl_easy_setopt(mHandle, CURLOPT_HEADERDATA, this);
+	}
+
 	//set the url
 	CURLcode err = curl_easy_setopt(mHandle, CURLOPT_URL, url.c_str());
 	if(err != CURLE_OK)
@@ -75,79 +398,94 @@ HttpReq::HttpReq(const std::string& url)
 		return;
 	}
 
-	//add the handle to our multi
-	CURLMcode merr = curl_multi_add_handle(s_multi_handle, mHandle);
-	if(merr != CURLM_OK)
-	{
-		mStatus = REQ_IO_ERROR;
-		onError(curl_multi_strerror(merr));
-		return;
-	}
-
-	s_requests[mHandle] = this;
+	//the I/O thread adds the handle to our multi
+	s_io_thread.post(this, false);
 }
 
 HttpReq::~HttpReq()
 {
-	if(mHandle)
+	// still running on the I/O thread, that must let go of it first
+	if(mHandle && mStatus == REQ_IN_PROGRESS)
 	{
-		s_requests.erase(mHandle);
+		s_io_thread.post(this, true);
+		s_io_thread.waitCancelled(this);
+	}
 
-		CURLMcode merr = curl_multi_remove_handle(s_multi_handle, mHandle);
+	// an interrupted download keeps its .part, to be resumed by the next request of the file
+	if(mFile != NULL)
+		fclose(mFile);
 
-        if(merr != CURLM_OK) {
-			LOG(LogError) << "Error removing curl_easy handle from curl_multi: " << curl_multi_strerror(merr);
-        }
+	if(mHeaders != NULL)
+		curl_slist_free_all(mHeaders);
 
-		curl_easy_cleanup(mHandle);
+	if(mHandle)
+	{
+		std::unique_lock<std::mutex> lock(s_idle_handles_mutex);
+		if(s_idle_handles.size() < MAX_IDLE_HANDLES)
+			s_idle_handles.push_back(mHandle);
+		else
+			curl_easy_cleanup(mHandle);
 	}
 }
 
 HttpReq::Status HttpReq::status()
 {
-	if(mStatus == REQ_IN_PROGRESS)
+	return mStatus;
+}
+
+void HttpReq::onDone(CURLcode result)
+{
+	// an empty response to a resume did not go through write()
+	if(result == CURLE_OK && !mResumeChecked && !write(NULL, 0))
+		result = CURLE_WRITE_ERROR;
+
+	if(mFile != NULL)
 	{
-		int handle_count;
-		CURLMcode merr = curl_multi_perform(s_multi_handle, &handle_count);
-		if(merr != CURLM_OK && merr != CURLM_CALL_MULTI_PERFORM)
-		{
-			mStatus = REQ_IO_ERROR;
-			onError(curl_multi_strerror(merr));
-			return mStatus;
-		}
+		if(fclose(mFile) != 0 && result == CURLE_OK)
+			result = CURLE_WRITE_ERROR;
+		mFile = NULL;
+	}
 
-		int msgs_left;
-		CURLMsg* msg;
-        while((msg = curl_multi_info_read(s_multi_handle, &msgs_left)))
+	if(result != CURLE_OK)
+	{
+		onError(curl_easy_strerror(result));
+		if(result == CURLE_HTTP_RETURNED_ERROR)
 		{
-			if(msg->msg == CURLMSG_DONE)
+			// nothing worth resuming
+			if(!mPath.empty())
 			{
-				HttpReq* req = s_requests[msg->easy_handle];
-				
-				if(req == NULL)
-				{
-					LOG(LogError) << "Cannot find easy handle!";
-					continue;
-				}
-
-				if(msg->data.result == CURLE_OK)
-				{
-					req->mStatus = REQ_SUCCESS;
-				}else{
-					req->mStatus = REQ_IO_ERROR;
-					req->onError(curl_easy_strerror(msg->data.result));
-				}
+				boost::system::error_code ec;
+				boost::filesystem::remove(mPath + ".part", ec);
+				boost::filesystem::remove(mPath + ".part.info", ec);
 			}
+			mStatus = REQ_BAD_STATUS_CODE;
+			return;
 		}
+		mStatus = REQ_IO_ERROR;
+		return;
 	}
 
-	return mStatus;
+	if(!mPath.empty())
+	{
+		// the complete file replaces the previous one at once
+		boost::system::error_code ec;
+		boost::filesystem::rename(mPath + ".part", mPath, ec);
+		if(ec)
+		{
+			onError(("Cannot rename " + mPath + ".part: " + ec.message()).c_str());
+			mStatus = REQ_IO_ERROR;
+			return;
+		}
+		boost::filesystem::remove(mPath + ".part.info", ec);
+	}
+
+	mStatus = REQ_SUCCESS;
 }
 
-std::string HttpReq::getContent() const
+const std::string& HttpReq::getContent() const
 {
 	assert(mStatus == REQ_SUCCESS);
-	return mContent.str();
+	return mContent;
 }
 
 void HttpReq::onError(const char* msg)
@@ -165,10 +503,87 @@ std::string HttpReq::getErrorMsg()
 //return value is number of elements successfully read
 size_t HttpReq::write_content(void* buff, size_t size, size_t nmemb, void* req_ptr)
 {
-	std::stringstream& ss = ((HttpReq*)req_ptr)->mContent;
-	ss.write((char*)buff, size * nmemb);
+	// anything else than nmemb aborts the transfer
+	return ((HttpReq*)req_ptr)->write((const char*)buff, size * nmemb) ? nmemb : 0;
+}
+
+//used as a curl callback, called once per header line, the body comes after all of them
+size_t HttpReq::write_header(char* buff, size_t size, size_t nitems, void* req_ptr)
+{
+	HttpReq* req = (HttpReq*)req_ptr;
+	std::string line(buff, size * nitems);
+	while(!line.empty() && (line.back() == '\r' || line.back() == '\n'))
+		line.pop_back();
+
+	size_t colon = line.find(':');
+	if(line.compare(0, 5, "HTTP/") == 0)
+	{
+		// the response after a redirection
+		req->mETag.clear();
+		req->mLastModified.clear();
+	}else if(colon != std::string::npos)
+	{
+		std::string name = line.substr(0, colon);
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+		size_t start = line.find_first_not_of(' ', colon + 1);
+		std::string value = start != std::string::npos ? line.substr(start) : "";
+		if(name == "etag")
+			req->mETag = value;
+		else if(name == "last-modified")
+			req->mLastModified = value;
+	}
+
+	return size * nitems;
+}
+
+bool HttpReq::write(const char* data, size_t length)
+{
+	if(!mResumeChecked)
+	{
+		// the server may ignore the range and send the whole file again
+		mResumeChecked = true;
+		long code = 0;
+		curl_easy_getinfo(mHandle, CURLINFO_RESPONSE_CODE, &code);
+		if(code != 206)
+		{
+			if(mResumeFrom > 0)
+				LOG(LogInfo) << mPath << " can't be resumed, downloading it again";
+			mFile = freopen((mPath + ".part").c_str(), "wb", mFile);
+			if(mFile == NULL || !writePartInfo())
+				return false;
+			mResumeFrom = 0;
+			mDownloaded = 0;
+			mCrc32 = 0;
+		}
+	}
+
+	if(mTotalSize == 0)
+	{
+#if LIBCURL_VERSION_NUM >= 0x073700
+		curl_off_t contentLength = -1;
+		curl_easy_getinfo(mHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &contentLength);
+#else
+		double contentLength = -1;
+		curl_easy_getinfo(mHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &contentLength);
+#endif
+		// the length of a resumed download is the one of the range
+		if(contentLength > 0)
+			mTotalSize = mResumeFrom + (size_t)contentLength;
+	}
+
+	if(mFile == NULL)
+	{
+		mContent.append(data, length);
+		mDownloaded += length;
+		return true;
+	}
+
+	if(fwrite(data, 1, length, mFile) != length)
+		return false;
 
-	return nmemb;
+	mDownloaded += length;
+	mCrc32 = crc32(mCrc32, data, length);
+	return true;
 }
 
 //used as a curl callback
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <curl/curl.h>
-#include <sstream>
-#include <map>
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
 
 /* Usage:
- * HttpReq myRequest("www.google.com", "/index.html");
+ * HttpReq myRequest("http://www.google.com/index.html");
  * //for blocking behavior: while(myRequest.status() == HttpReq::REQ_IN_PROGRESS);
  * //for non-blocking behavior: check if(myRequest.status() != HttpReq::REQ_IN_PROGRESS) in some sort of update method
  * 
@@ -19,12 +22,24 @@
  *
  * std::string content = myRequest.getContent();
  * //process contents...
+ *
+ * Large downloads are better streamed than kept in memory: HttpReq myDownload(url, "/path/to/file") writes the
+ * response to "/path/to/file.part" as it arrives, and renames it to "/path/to/file" once complete.
+ * A .part left by an interrupted download of the same URL is resumed from where it stopped with a Range request,
+ * and an If-Range of the ETag or Last-Modified date it was downloaded with: a file changed since is downloaded again.
+ *
+ * Requests run on an I/O thread, that drives all of them together in one curl multi handle: status() only reads
+ * where a request is at, it doesn't have to be called for the transfer to progress.
+ * Connections are kept alive and reused between requests (multiplexed with HTTP/2 when available),
+ * and DNS and TLS sessions are shared, so successive requests to a host don't pay for a handshake each.
 */
 
 class HttpReq
 {
 public:
 	HttpReq(const std::string& url);
+	// stream the response to a file, see above
+	HttpReq(const std::string& url, const std::string& path);
 
 	~HttpReq();
 
@@ -38,31 +53,72 @@ public:
 		REQ_INVALID_RESPONSE	//the HTTP response was invalid
 	};
 
-	Status status(); //process any received data and return the status afterwards
+	Status status(); //the request's content and error are complete once it is no longer REQ_IN_PROGRESS
 
 	std::string getErrorMsg();
 
-	std::string getContent() const; // mStatus must be REQ_SUCCESS
+	const std::string& getContent() const; // mStatus must be REQ_SUCCESS
+
+	// progress: bytes received so far (a resumed part included) out of the total size, 0 while unknown
+	inline size_t getDownloadedSize() const { return mDownloaded; }
+	inline size_t getTotalSize() const { return mTotalSize; }
+	// CRC-32 of the content, only kept when streaming, once the request is done
+	inline unsigned int getCrc32() const { return mCrc32; }
 
 	static std::string urlEncode(const std::string &s);
 	static bool isUrl(const std::string& s);
 
 private:
+	class IOThread;
+
 	static size_t write_content(void* buff, size_t size, size_t nmemb, void* req_ptr);
+	static size_t write_header(char* buff, size_t size, size_t nitems, void* req_ptr);
 	//static int update_progress(void* req_ptr, double dlTotal, double dlNow, double ulTotal, double ulNow);
-
-	//god dammit libcurl why can't you have some way to check the status of an individual handle
-	//why do I have to handle ALL messages at once
-	static std::map<CURL*, HttpReq*> s_requests;
+	static void lock_share(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+	static void unlock_share(CURL* handle, curl_lock_data data, void* userptr);
 
 	static CURLM* s_multi_handle;
-
+	// DNS and TLS session caches of all the requests
+	static CURLSH* s_share_handle;
+	static std::mutex s_share_locks[CURL_LOCK_DATA_LAST];
+	// easy handles of finished requests, reset and reused by the next ones
+	static std::vector<CURL*> s_idle_handles;
+	static std::mutex s_idle_handles_mutex;
+
+	static IOThread s_io_thread;
+
+	static CURLM* initMultiHandle();
+	static CURLSH* initShareHandle();
+	static CURL* takeEasyHandle();
+
+	void start(const std::string& url);
+	bool openPart();
+	bool writePartInfo();
+	bool write(const char* data, size_t length);
+	void onDone(CURLcode result);
 	void onError(const char* msg);
 
 	CURL* mHandle;
 
-	Status mStatus;
+	std::atomic<Status> mStatus;
 
-	std::stringstream mContent;
+	std::string mUrl;
+	std::string mContent;
 	std::string mErrorMsg;
+
+	// streaming, to mPath + ".part", with the URL and validator in mPath + ".part.info"
+	std::string mPath;
+	FILE* mFile;
+	size_t mResumeFrom;
+	bool mResumeChecked;
+	std::string mETag;
+	std::string mLastModified;
+	curl_slist* mHeaders;
+
+	std::atomic<size_t> mDownloaded;
+	std::atomic<size_t> mTotalSize;
+	unsigned int mCrc32;
+
+	// set by the I/O thread once it dropped the request
+	bool mCancelled;
 };
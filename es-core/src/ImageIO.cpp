@@ -30,24 +30,7 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 						fiBitmap = fiConverted;
 					}
 				}
-        width = FreeImage_GetWidth(fiBitmap);
-        height = FreeImage_GetHeight(fiBitmap);
-        // loop through scanlines and add all pixel data to the return vector
-        // this is necessary, because width*height*bpp might not be == pitch
-        // do on-the-fly argb to abgr convertion
-        rawData.resize(width * height *4);
-        unsigned char* tempData = rawData.data();
-        int w = (int)width;
-        for (int y = (int)height; --y >= 0; )
-        {
-          unsigned int* argb = (unsigned int*)FreeImage_GetScanLine(fiBitmap, y);
-          unsigned int* abgr = (unsigned int*)(tempData + (y * width * 4));
-          for(int x = w ; --x >= 0;)
-          {
-            unsigned int c = argb[x];
-            abgr[x] = (c & 0xFF00FF00) | ((c & 0xFF) << 16) | ((c >> 16) & 0xFF);
-          }
-        }
+        rawData = toRGBA32(fiBitmap, width, height);
         //free bitmap data
         FreeImage_Unload(fiBitmap);
 			}
@@ -66,6 +49,69 @@ std::vector<unsigned char> ImageIO::loadFromMemoryRGBA32(const unsigned char * d
 	return std::move(rawData);
 }
 
+std::vector<unsigned char> ImageIO::toRGBA32(FIBITMAP* fiBitmap, size_t & width, size_t & height)
+{
+	std::vector<unsigned char> rawData;
+	width = FreeImage_GetWidth(fiBitmap);
+	height = FreeImage_GetHeight(fiBitmap);
+	// loop through scanlines and add all pixel data to the return vector
+	// this is necessary, because width*height*bpp might not be == pitch
+	// do on-the-fly argb to abgr convertion
+	rawData.resize(width * height *4);
+	unsigned char* tempData = rawData.data();
+	int w = (int)width;
+	for (int y = (int)height; --y >= 0; )
+	{
+		unsigned int* argb = (unsigned int*)FreeImage_GetScanLine(fiBitmap, y);
+		unsigned int* abgr = (unsigned int*)(tempData + (y * width * 4));
+		for(int x = w ; --x >= 0;)
+		{
+			unsigned int c = argb[x];
+			abgr[x] = (c & 0xFF00FF00) | ((c & 0xFF) << 16) | ((c >> 16) & 0xFF);
+		}
+	}
+	return rawData;
+}
+
+static bool getBitmapSize(FIBITMAP* fiBitmap, size_t & width, size_t & height)
+{
+	if (fiBitmap == nullptr)
+		return false;
+	width = FreeImage_GetWidth(fiBitmap);
+	height = FreeImage_GetHeight(fiBitmap);
+	FreeImage_Unload(fiBitmap);
+	return width > 0 && height > 0;
+}
+
+bool ImageIO::getSize(const std::string& path, size_t & width, size_t & height)
+{
+#ifdef FIF_LOAD_NOPIXELS
+	FREE_IMAGE_FORMAT format = FreeImage_GetFileType(path.c_str());
+	if (format == FIF_UNKNOWN || !FreeImage_FIFSupportsNoPixels(format))
+		return false;
+	return getBitmapSize(FreeImage_Load(format, path.c_str(), FIF_LOAD_NOPIXELS), width, height);
+#else
+	return false;
+#endif
+}
+
+bool ImageIO::getSizeFromMemory(const unsigned char * data, const size_t size, size_t & width, size_t & height)
+{
+#ifdef FIF_LOAD_NOPIXELS
+	FIMEMORY * fiMemory = FreeImage_OpenMemory((BYTE *)data, (DWORD)size);
+	if (fiMemory == nullptr)
+		return false;
+	bool known = false;
+	FREE_IMAGE_FORMAT format = FreeImage_GetFileTypeFromMemory(fiMemory);
+	if (format != FIF_UNKNOWN && FreeImage_FIFSupportsNoPixels(format))
+		known = getBitmapSize(FreeImage_LoadFromMemory(format, fiMemory, FIF_LOAD_NOPIXELS), width, height);
+	FreeImage_CloseMemory(fiMemory);
+	return known;
+#else
+	return false;
+#endif
+}
+
 void ImageIO::flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height)
 {
 	unsigned int temp;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 #include <FreeImage.h>
 
@@ -7,5 +8,10 @@ class ImageIO
 {
 public:
 	static std::vector<unsigned char> loadFromMemoryRGBA32(const unsigned char * data, const size_t size, size_t & width, size_t & height);
+	// Pixels of a 32 bits bitmap, in the same layout as loadFromMemoryRGBA32
+	static std::vector<unsigned char> toRGBA32(FIBITMAP* bitmap, size_t & width, size_t & height);
+	// Dimensions read from the header only, false if unknown
+	static bool getSize(const std::string& path, size_t & width, size_t & height);
+	static bool getSizeFromMemory(const unsigned char * data, const size_t size, size_t & width, size_t & height);
 	static void flipPixelsVert(unsigned char* imagePx, const size_t& width, const size_t& height);
 };
\ No newline at end of file
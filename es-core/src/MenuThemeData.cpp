@@ -7,7 +7,9 @@
 std::shared_ptr<MenuThemeData> MenuThemeData::sInstance = NULL;
 
 std::shared_ptr<MenuThemeData> MenuThemeData::getInstance() {
-	if (sInstance == NULL || Settings::getInstance()->getBool("ThemeChanged"))
+	// every list renders through here
+	static const SettingHandle<bool> themeChanged = Settings::getInstance()->getBoolHandle("ThemeChanged");
+	if (sInstance == NULL || themeChanged)
 		sInstance = std::shared_ptr<MenuThemeData>(new MenuThemeData());
 	return sInstance;
 }
@@ -20,140 +22,140 @@ MenuThemeData::MenuThemeData(){
 	
 	if (elem)
 	{
-		if (elem->has("path"))
-			mCurrent->menuBackground.path = elem->get<std::string>("path");
-		if (elem->has("fadePath"))
-			mCurrent->menuBackground.fadePath = elem->get<std::string>("fadePath");
-		if (elem->has("color"))
-			mCurrent->menuBackground.color = elem->get<unsigned int>("color");
+		if (elem->has(ThemeProperty::PATH))
+			mCurrent->menuBackground.path = elem->get<std::string>(ThemeProperty::PATH);
+		if (elem->has(ThemeProperty::FADE_PATH))
+			mCurrent->menuBackground.fadePath = elem->get<std::string>(ThemeProperty::FADE_PATH);
+		if (elem->has(ThemeProperty::COLOR))
+			mCurrent->menuBackground.color = elem->get<unsigned int>(ThemeProperty::COLOR);
 	}
 	
 	elem = ThemeData::getCurrent()->getElement("menu", "menutitle", "menuText");
 	
 	if (elem)
 	{
-		if(elem->has("fontPath") || elem->has("fontSize"))
+		if(elem->has(ThemeProperty::FONT_PATH) || elem->has(ThemeProperty::FONT_SIZE))
 			mCurrent->menuTitle.font = Font::getFromTheme(elem, ThemeFlags::ALL, Font::get(FONT_SIZE_LARGE));
-		if(elem->has("color"))
-			mCurrent->menuTitle.color = elem->get<unsigned int>("color");
+		if(elem->has(ThemeProperty::COLOR))
+			mCurrent->menuTitle.color = elem->get<unsigned int>(ThemeProperty::COLOR);
 	}
 	
 	elem = ThemeData::getCurrent()->getElement("menu", "menufooter", "menuText");
 	
 	if (elem)
 	{
-		if(elem->has("fontPath") || elem->has("fontSize"))
+		if(elem->has(ThemeProperty::FONT_PATH) || elem->has(ThemeProperty::FONT_SIZE))
 			mCurrent->menuFooter.font = Font::getFromTheme(elem, ThemeFlags::ALL, Font::get(FONT_SIZE_SMALL));
-		if(elem->has("color"))
-			mCurrent->menuFooter.color = elem->get<unsigned int>("color");
+		if(elem->has(ThemeProperty::COLOR))
+			mCurrent->menuFooter.color = elem->get<unsigned int>(ThemeProperty::COLOR);
 	}
 	
 	elem = ThemeData::getCurrent()->getElement("menu", "menutext", "menuText");
 	
 	if (elem)
 	{
-		if(elem->has("fontPath") || elem->has("fontSize"))
+		if(elem->has(ThemeProperty::FONT_PATH) || elem->has(ThemeProperty::FONT_SIZE))
 		{
 			mCurrent->menuText.font = Font::getFromTheme(elem, ThemeFlags::ALL, Font::get(FONT_SIZE_MEDIUM));
 		}
 			
-		if(elem->has("color"))
-			mCurrent->menuText.color = elem->get<unsigned int>("color");
-		if(elem->has("separatorColor"))
-			mCurrent->menuText.separatorColor = elem->get<unsigned int>("separatorColor");
-		if(elem->has("selectedColor"))
-			mCurrent->menuText.selectedColor = elem->get<unsigned int>("selectedColor");
-		if(elem->has("selectorColor"))
-			mCurrent->menuText.selectorColor = elem->get<unsigned int>("selectorColor");
+		if(elem->has(ThemeProperty::COLOR))
+			mCurrent->menuText.color = elem->get<unsigned int>(ThemeProperty::COLOR);
+		if(elem->has(ThemeProperty::SEPARATOR_COLOR))
+			mCurrent->menuText.separatorColor = elem->get<unsigned int>(ThemeProperty::SEPARATOR_COLOR);
+		if(elem->has(ThemeProperty::SELECTED_COLOR))
+			mCurrent->menuText.selectedColor = elem->get<unsigned int>(ThemeProperty::SELECTED_COLOR);
+		if(elem->has(ThemeProperty::SELECTOR_COLOR))
+			mCurrent->menuText.selectorColor = elem->get<unsigned int>(ThemeProperty::SELECTOR_COLOR);
 	}
 	
 	elem = ThemeData::getCurrent()->getElement("menu", "menutextsmall", "menuTextSmall");
 	
 	if (elem)
 	{
-		if(elem->has("fontPath") || elem->has("fontSize"))
+		if(elem->has(ThemeProperty::FONT_PATH) || elem->has(ThemeProperty::FONT_SIZE))
 		{
 			mCurrent->menuTextSmall.font = Font::getFromTheme(elem, ThemeFlags::ALL, Font::get(FONT_SIZE_SMALL));
 		}
 			
-		if(elem->has("color"))
-			mCurrent->menuTextSmall.color = elem->get<unsigned int>("color");
-		if(elem->has("selectedColor"))
-			mCurrent->menuText.selectedColor = elem->get<unsigned int>("selectedColor");
-		if(elem->has("selectorColor"))
-			mCurrent->menuText.selectedColor = elem->get<unsigned int>("selectorColor");
+		if(elem->has(ThemeProperty::COLOR))
+			mCurrent->menuTextSmall.color = elem->get<unsigned int>(ThemeProperty::COLOR);
+		if(elem->has(ThemeProperty::SELECTED_COLOR))
+			mCurrent->menuText.selectedColor = elem->get<unsigned int>(ThemeProperty::SELECTED_COLOR);
+		if(elem->has(ThemeProperty::SELECTOR_COLOR))
+			mCurrent->menuText.selectedColor = elem->get<unsigned int>(ThemeProperty::SELECTOR_COLOR);
 	}
 	
 	elem = ThemeData::getCurrent()->getElement("menu", "menubutton", "menuButton");
 	
 	if (elem)
 	{
-		if(elem->has("path"))
-			mCurrent->iconSet.button = elem->get<std::string>("path");
-		if(elem->has("filledPath"))
-			mCurrent->iconSet.button_filled = elem->get<std::string>("filledPath");
+		if(elem->has(ThemeProperty::PATH))
+			mCurrent->iconSet.button = elem->get<std::string>(ThemeProperty::PATH);
+		if(elem->has(ThemeProperty::FILLED_PATH))
+			mCurrent->iconSet.button_filled = elem->get<std::string>(ThemeProperty::FILLED_PATH);
 	}
 	
 	elem = ThemeData::getCurrent()->getElement("menu", "menuswitch", "menuSwitch");
 	
 	if (elem)
 	{
-		if(elem->has("pathOn"))
-			mCurrent->iconSet.on = elem->get<std::string>("pathOn");
-		if(elem->has("pathOff"))
-			mCurrent->iconSet.off = elem->get<std::string>("pathOff");
+		if(elem->has(ThemeProperty::PATH_ON))
+			mCurrent->iconSet.on = elem->get<std::string>(ThemeProperty::PATH_ON);
+		if(elem->has(ThemeProperty::PATH_OFF))
+			mCurrent->iconSet.off = elem->get<std::string>(ThemeProperty::PATH_OFF);
 	}
 	
 	elem = ThemeData::getCurrent()->getElement("menu", "menuslider", "menuSlider");
 	
 	if (elem)
-		if(elem->has("path"))
-			mCurrent->iconSet.knob = elem->get<std::string>("path");
+		if(elem->has(ThemeProperty::PATH))
+			mCurrent->iconSet.knob = elem->get<std::string>(ThemeProperty::PATH);
 
 	elem = ThemeData::getCurrent()->getElement("menu", "menuicons", "menuIcons");
 
 	if (elem) {
-		if (elem->has("iconKodi"))
-			mCurrent->menuIconSet.kodi = elem->get<std::string>("iconKodi");
+		if (elem->has(ThemeProperty::ICON_KODI))
+			mCurrent->menuIconSet.kodi = elem->get<std::string>(ThemeProperty::ICON_KODI);
 
-		if (elem->has("iconSystem"))
-			mCurrent->menuIconSet.system = elem->get<std::string>("iconSystem");
+		if (elem->has(ThemeProperty::ICON_SYSTEM))
+			mCurrent->menuIconSet.system = elem->get<std::string>(ThemeProperty::ICON_SYSTEM);
 
-		if (elem->has("iconUpdates"))
-			mCurrent->menuIconSet.updates = elem->get<std::string>("iconUpdates");
+		if (elem->has(ThemeProperty::ICON_UPDATES))
+			mCurrent->menuIconSet.updates = elem->get<std::string>(ThemeProperty::ICON_UPDATES);
 
-		if (elem->has("iconGames"))
-			mCurrent->menuIconSet.games = elem->get<std::string>("iconGames");
+		if (elem->has(ThemeProperty::ICON_GAMES))
+			mCurrent->menuIconSet.games = elem->get<std::string>(ThemeProperty::ICON_GAMES);
 
-		if (elem->has("iconControllers"))
-			mCurrent->menuIconSet.controllers = elem->get<std::string>("iconControllers");
+		if (elem->has(ThemeProperty::ICON_CONTROLLERS))
+			mCurrent->menuIconSet.controllers = elem->get<std::string>(ThemeProperty::ICON_CONTROLLERS);
 
-		if (elem->has("iconUI"))
-			mCurrent->menuIconSet.ui = elem->get<std::string>("iconUI");
+		if (elem->has(ThemeProperty::ICON_UI))
+			mCurrent->menuIconSet.ui = elem->get<std::string>(ThemeProperty::ICON_UI);
 
-		if (elem->has("iconSound"))
-			mCurrent->menuIconSet.sound = elem->get<std::string>("iconSound");
+		if (elem->has(ThemeProperty::ICON_SOUND))
+			mCurrent->menuIconSet.sound = elem->get<std::string>(ThemeProperty::ICON_SOUND);
 
-		if (elem->has("iconNetwork"))
-			mCurrent->menuIconSet.network = elem->get<std::string>("iconNetwork");
+		if (elem->has(ThemeProperty::ICON_NETWORK))
+			mCurrent->menuIconSet.network = elem->get<std::string>(ThemeProperty::ICON_NETWORK);
 
-		if (elem->has("iconScraper"))
-			mCurrent->menuIconSet.scraper = elem->get<std::string>("iconScraper");
+		if (elem->has(ThemeProperty::ICON_SCRAPER))
+			mCurrent->menuIconSet.scraper = elem->get<std::string>(ThemeProperty::ICON_SCRAPER);
 
-		if (elem->has("iconAdvanced"))
-			mCurrent->menuIconSet.advanced = elem->get<std::string>("iconAdvanced");
+		if (elem->has(ThemeProperty::ICON_ADVANCED))
+			mCurrent->menuIconSet.advanced = elem->get<std::string>(ThemeProperty::ICON_ADVANCED);
 
-		if (elem->has("iconQuit"))
-            		mCurrent->menuIconSet.quit = elem->get<std::string>("iconQuit");
+		if (elem->has(ThemeProperty::ICON_QUIT))
+            		mCurrent->menuIconSet.quit = elem->get<std::string>(ThemeProperty::ICON_QUIT);
 
-        	if (elem->has("iconRestart"))
-            		mCurrent->menuIconSet.restart = elem->get<std::string>("iconRestart");
+        	if (elem->has(ThemeProperty::ICON_RESTART))
+            		mCurrent->menuIconSet.restart = elem->get<std::string>(ThemeProperty::ICON_RESTART);
 
-        	if (elem->has("iconShutdown"))
-            		mCurrent->menuIconSet.shutdown = elem->get<std::string>("iconShutdown");
+        	if (elem->has(ThemeProperty::ICON_SHUTDOWN))
+            		mCurrent->menuIconSet.shutdown = elem->get<std::string>(ThemeProperty::ICON_SHUTDOWN);
 
-        	if (elem->has("iconFastShutdown"))
-            		mCurrent->menuIconSet.fastshutdown = elem->get<std::string>("iconFastShutdown");
+        	if (elem->has(ThemeProperty::ICON_FAST_SHUTDOWN))
+            		mCurrent->menuIconSet.fastshutdown = elem->get<std::string>(ThemeProperty::ICON_FAST_SHUTDOWN);
 	}
 		
 	
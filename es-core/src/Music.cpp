@@ -24,12 +24,12 @@ std::shared_ptr<Music> Music::getFromTheme(const std::shared_ptr<ThemeData>& the
 {
 	LOG(LogInfo) << " req music [" << view << "." << element << "]";
 	const ThemeData::ThemeElement* elem = theme->getElement(view, element, "sound");
-	if(!elem || !elem->has("path"))
+	if(!elem || !elem->has(ThemeProperty::PATH))
 	{
 		LOG(LogInfo) << "   (missing)";
 		return NULL;
 	}
-	return get(elem->get<std::string>("path"));
+	return get(elem->get<std::string>(ThemeProperty::PATH));
 }
 
 Music::Music(const std::string & path) : music(NULL), playing(false)
@@ -58,14 +58,21 @@ void Music::initMusic()
 	if(mPath.empty())
 		return;
 
-	//load wav file via SDL
+	//load the file via SDL, streamed from the disk; packed files are read from memory
         Mix_Music *gMusic = NULL;
-        gMusic = Mix_LoadMUS( mPath.c_str() );
+        ResourceData data = {NULL, 0};
+        if(ResourceManager::getInstance()->isPacked(mPath)){
+            data = ResourceManager::getInstance()->getFileData(mPath);
+            if(data.ptr)
+                gMusic = Mix_LoadMUS_RW( SDL_RWFromConstMem(data.ptr.get(), (int)data.length), 1 );
+        }else
+            gMusic = Mix_LoadMUS(mPath.c_str());
         if(gMusic == NULL){
             LOG(LogError) << "Error loading sound \"" << mPath << "\"!\n" << "	" << SDL_GetError();
             return;
         }else {
             music = gMusic;
+            mData = data.ptr;
         }
 }
 
@@ -76,6 +83,7 @@ void Music::deinitMusic()
             Mix_FreeMusic( music );
             music = NULL;
         }
+        mData.reset();
 }
 
 void Music::play(bool repeat, void (* callback)())
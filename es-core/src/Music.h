@@ -5,6 +5,7 @@
 #include <map>
 #include <memory>
 #include "SDL_mixer.h"
+#include "resources/ResourceManager.h"
 
 class ThemeData;
 
@@ -12,6 +13,8 @@ class Music
 {	
         std::string mPath;
 	Mix_Music * music;
+	// packed files only, read by the mixer while the music plays
+	std::shared_ptr<unsigned char> mData;
 	bool playing;
 
 public:
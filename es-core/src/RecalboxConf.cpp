@@ -1,23 +1,125 @@
 #include "RecalboxConf.h"
 #include <iostream>
 #include <fstream>
-#include <boost/regex.hpp>
+#include <sstream>
 #include "Log.h"
-#include <boost/algorithm/string/predicate.hpp>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <errno.h>
 
 RecalboxConf *RecalboxConf::sInstance = NULL;
-boost::regex validLine("^(?<key>[^;|#].*?)=(?<val>.*?)$");
-boost::regex commentLine("^;(?<key>.*?)=(?<val>.*?)$");
 
 std::string recalboxConfFile = "/recalbox/share/system/recalbox.conf";
 std::string recalboxConfFileInit = "/recalbox/share_init/system/recalbox.conf";
-std::string recalboxConfFileTmp = "/recalbox/share/system/recalbox.conf.tmp";
 
-RecalboxConf::RecalboxConf(bool mainFile) {
+enum LineType {
+    LINE_OTHER,
+    LINE_KEY,       // key=value
+    LINE_COMMENTED  // ;key=value
+};
+
+// A key doesn't start with ';', '|' or '#' and ends at the first '='
+static LineType parseLine(const std::string &line, std::string &key, std::string &value) {
+    if (line.empty() || line[0] == '|' || line[0] == '#')
+        return LINE_OTHER;
+
+    const bool commented = line[0] == ';';
+    const size_t start = commented ? 1 : 0;
+    const size_t equal = line.find('=', start);
+    if (equal == std::string::npos || (!commented && equal == 0))
+        return LINE_OTHER;
+
+    key = line.substr(start, equal - start);
+    value = line.substr(equal + 1);
+    return commented ? LINE_COMMENTED : LINE_KEY;
+}
+
+// Lines as std::getline would read them
+static void splitLines(const std::string &content, std::vector<std::string> &lines) {
+    lines.clear();
+    size_t start = 0;
+    while (start < content.size()) {
+        size_t end = content.find('\n', start);
+        if (end == std::string::npos)
+            end = content.size();
+        lines.push_back(content.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+static bool readContent(const std::string &path, std::string &content) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return false;
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    content = buffer.str();
+    return true;
+}
+
+// Tells whether the file was replaced or changed since it was stamped
+static std::string getFileStamp(const std::string &path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return "";
+    return std::to_string(info.st_ino) + ":" + std::to_string(info.st_size) + ":" +
+           std::to_string(info.st_mtim.tv_sec) + "." + std::to_string(info.st_mtim.tv_nsec);
+}
+
+// Written aside, synced, then renamed over the file: it is never seen half written, even after a power cut
+static bool writeAtomically(const std::string &path, const std::string &content) {
+    const std::string tmpPath = path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    const char *data = content.data();
+    size_t left = content.size();
+    while (left > 0) {
+        ssize_t written = write(fd, data, left);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        data += written;
+        left -= (size_t) written;
+    }
+    bool ok = left == 0 && fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    // the rename itself
+    const std::string directory = boost::filesystem::path(path).parent_path().string();
+    int dirFd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        close(dirFd);
+    }
+    return true;
+}
+
+RecalboxConf::RecalboxConf(bool mainFile) : savePending(false), writing(false), writeOk(true), quit(false) {
     loadRecalboxConf(mainFile);
 }
 
 RecalboxConf::~RecalboxConf() {
+    if (writer.joinable()) {
+        sync();
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            quit = true;
+        }
+        writeCondition.notify_all();
+        writer.join();
+    }
 	if (sInstance && sInstance == this)
 		delete sInstance;
 }
@@ -30,103 +132,172 @@ RecalboxConf *RecalboxConf::getInstance() {
 }
 
 bool RecalboxConf::loadRecalboxConf(bool mainFile) {
-    std::string line;
     std::string filePath = mainFile ? recalboxConfFile : recalboxConfFileInit;
-    std::ifstream recalboxConf(filePath);
-    if (recalboxConf && recalboxConf.is_open()) {
-        while (std::getline(recalboxConf, line)) {
-            boost::smatch lineInfo;
-            if (boost::regex_match(line, lineInfo, validLine)) {
-                confMap[std::string(lineInfo["key"])] = std::string(lineInfo["val"]);
-            }
-        }
-        recalboxConf.close();
-    } else {
+    std::string content;
+    if (!readContent(filePath, content)) {
         LOG(LogError) << "Unable to open " << filePath;
         return false;
     }
+
+    std::vector<std::string> lines;
+    splitLines(content, lines);
+    std::string key, value;
+    for (auto it = lines.begin(); it != lines.end(); ++it) {
+        if (parseLine(*it, key, value) == LINE_KEY)
+            confMap[key] = value;
+    }
     return true;
 }
 
+void RecalboxConf::saveRecalboxConf() {
+    savePending = true;
+}
 
-bool RecalboxConf::saveRecalboxConf() {
-    std::ifstream filein(recalboxConfFile); //File to read from
-    if (!filein) {
-        LOG(LogError) << "Unable to open for saving :  " << recalboxConfFile << "\n";
-        return false;
-    }
-    /* Read all lines in a vector */
-    std::vector<std::string> fileLines;
-    std::string line;
-    while (std::getline(filein, line)) {
-        fileLines.push_back(line);
+void RecalboxConf::update() {
+    if (!savePending)
+        return;
+    savePending = false;
+    if (dirtyKeys.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        for (auto it = dirtyKeys.begin(); it != dirtyKeys.end(); ++it)
+            toWrite[*it] = confMap[*it];
+        if (!writer.joinable())
+            writer = std::thread(&RecalboxConf::writerLoop, this);
     }
-    filein.close();
+    dirtyKeys.clear();
+    writeCondition.notify_all();
+}
+
+bool RecalboxConf::sync() {
+    update();
 
+    std::unique_lock<std::mutex> lock(writeMutex);
+    writeCondition.wait(lock, [this] { return toWrite.empty() && !writing; });
+    return writeOk;
+}
 
-    /* Save new value if exists */
-    for (std::map<std::string, std::string>::iterator it = confMap.begin(); it != confMap.end(); ++it) {
-        std::string key = it->first;
-        std::string val = it->second;
-        bool lineFound = false;
-        for (int i = 0; i < fileLines.size(); i++) {
-            std::string currentLine = fileLines[i];
+void RecalboxConf::writerLoop() {
+    std::unique_lock<std::mutex> lock(writeMutex);
+    while (true) {
+        writeCondition.wait(lock, [this] { return !toWrite.empty() || quit; });
+        if (toWrite.empty())
+            return;
 
-            if (boost::starts_with(currentLine, key+"=") || boost::starts_with(currentLine, ";"+key+"=")){
-                fileLines[i] = key + "=" + val;
-                lineFound = true;
-            }
-        }
-        if(!lineFound){
-            fileLines.push_back(key + "=" + val);
-        }
+        // the saves made meanwhile are written together
+        std::map<std::string, std::string> values;
+        values.swap(toWrite);
+        writing = true;
+        lock.unlock();
+
+        bool ok = writeFile(values);
+
+        lock.lock();
+        writing = false;
+        writeOk = ok;
+        writeCondition.notify_all();
     }
-    std::ofstream fileout(recalboxConfFileTmp); //Temporary file
-    if (!fileout) {
-        LOG(LogError) << "Unable to open for saving :  " << recalboxConfFileTmp << "\n";
+}
+
+bool RecalboxConf::readFile() {
+    std::string content;
+    if (!readContent(recalboxConfFile, content)) {
+        LOG(LogError) << "Unable to open for saving :  " << recalboxConfFile;
         return false;
     }
-    for (int i = 0; i < fileLines.size(); i++) {
-        fileout << fileLines[i] << "\n";
+
+    splitLines(content, fileLines);
+    keyLines.clear();
+    commentedKeyLines.clear();
+    std::string key, value;
+    for (size_t i = 0; i < fileLines.size(); i++) {
+        LineType type = parseLine(fileLines[i], key, value);
+        if (type == LINE_KEY)
+            keyLines[key].push_back(i);
+        else if (type == LINE_COMMENTED && commentedKeyLines.find(key) == commentedKeyLines.end())
+            commentedKeyLines[key] = i;
+    }
+    fileStamp = getFileStamp(recalboxConfFile);
+    return true;
+}
+
+bool RecalboxConf::writeFile(const std::map<std::string, std::string> &values) {
+    // a script may have edited the file since it was last written
+    if (fileStamp.empty() || fileStamp != getFileStamp(recalboxConfFile)) {
+        if (!readFile())
+            return false;
     }
 
-    fileout.close();
+    // every line of a key, or else its commented line, else a new line at the end
+    for (auto it = values.begin(); it != values.end(); ++it) {
+        const std::string line = it->first + "=" + it->second;
+        auto lines = keyLines.find(it->first);
+        if (lines != keyLines.end()) {
+            for (auto index = lines->second.begin(); index != lines->second.end(); ++index)
+                fileLines[*index] = line;
+            continue;
+        }
 
+        auto commented = commentedKeyLines.find(it->first);
+        if (commented != commentedKeyLines.end()) {
+            fileLines[commented->second] = line;
+            keyLines[it->first].push_back(commented->second);
+            commentedKeyLines.erase(commented);
+        } else {
+            keyLines[it->first].push_back(fileLines.size());
+            fileLines.push_back(line);
+        }
+    }
 
-    /* Copy back the tmp to recalbox.conf */
-    std::ifstream  src(recalboxConfFileTmp, std::ios::binary);
-    std::ofstream  dst(recalboxConfFile,   std::ios::binary);
-    dst << src.rdbuf();
+    std::string content;
+    for (auto it = fileLines.begin(); it != fileLines.end(); ++it) {
+        content += *it;
+        content += '\n';
+    }
 
-    remove(recalboxConfFileTmp.c_str());
+    // through a symbolic link, the file it points to is replaced
+    boost::system::error_code ec;
+    boost::filesystem::path target = boost::filesystem::canonical(recalboxConfFile, ec);
+    if (ec || !writeAtomically(target.string(), content)) {
+        LOG(LogError) << "Unable to save " << recalboxConfFile;
+        fileStamp.clear();
+        return false;
+    }
 
+    fileStamp = getFileStamp(recalboxConfFile);
     return true;
 }
 
 std::string RecalboxConf::get(const std::string &name) {
-    if (confMap.count(name)) {
-        return confMap[name];
+    auto it = confMap.find(name);
+    if (it != confMap.end()) {
+        return it->second;
     }
     return "";
 }
 std::string RecalboxConf::get(const std::string &name, const std::string &defaultValue) {
-    if (confMap.count(name)) {
-        return confMap[name];
+    auto it = confMap.find(name);
+    if (it != confMap.end()) {
+        return it->second;
     }
     return defaultValue;
 }
 
 bool RecalboxConf::getBool(const std::string &name, bool defaultValue) {
-    if (confMap.count(name)) {
-        return confMap[name] == "1";
+    auto it = confMap.find(name);
+    if (it != confMap.end()) {
+        return it->second == "1";
     }
     return defaultValue;
 }
 
 unsigned int RecalboxConf::getUInt(const std::string &name, unsigned int defaultValue) {
     try {
-        if (confMap.count(name)) {
-            int value = std::stoi(confMap[name]);
+        auto it = confMap.find(name);
+        if (it != confMap.end()) {
+            int value = std::stoi(it->second);
             return value > 0 ? (unsigned int) value : 0;
         }
     } catch(std::invalid_argument&) {}
@@ -135,21 +306,51 @@ unsigned int RecalboxConf::getUInt(const std::string &name, unsigned int default
 }
 
 void RecalboxConf::set(const std::string &name, const std::string &value) {
-    confMap[name] = value;
+    setValue(name, value);
 }
 
 void RecalboxConf::setBool(const std::string &name, bool value) {
-    confMap[name] = value ? "1" : "0";
+    setValue(name, value ? "1" : "0");
 }
 
 void RecalboxConf::setUInt(const std::string &name, unsigned int value) {
-    confMap[name] = std::to_string(value).c_str();
+    setValue(name, std::to_string(value));
+}
+
+void RecalboxConf::addChangeCallback(const std::string &name, const void *owner, const ChangeCallback &callback) {
+    Listener listener = { owner, callback };
+    listeners[name].push_back(listener);
+}
+
+void RecalboxConf::removeChangeCallbacks(const void *owner) {
+    for (auto it = listeners.begin(); it != listeners.end(); ++it) {
+        std::vector<Listener> &list = it->second;
+        list.erase(std::remove_if(list.begin(), list.end(), [owner](const Listener &listener) { return listener.owner == owner; }), list.end());
+    }
+}
+
+// Store the value, to be written by the next save, then tell the listeners if it changed
+void RecalboxConf::setValue(const std::string &name, const std::string &value) {
+    auto current = confMap.find(name);
+    if (current != confMap.end() && current->second == value)
+        return;
+    confMap[name] = value;
+    dirtyKeys.insert(name);
+
+    auto it = listeners.find(name);
+    if (it == listeners.end())
+        return;
+    // a copy, a callback may add or remove listeners
+    std::vector<Listener> list = it->second;
+    for (auto listener = list.begin(); listener != list.end(); ++listener)
+        listener->callback(name);
 }
 
 bool RecalboxConf::isInList(const std::string &name, const std::string &value) {
     bool result = false;
-    if (confMap.count(name)) {
-        std::string s = confMap[name];
+    auto it = confMap.find(name);
+    if (it != confMap.end()) {
+        std::string s = it->second;
         std::string delimiter = ",";
 
         size_t pos = 0;
@@ -8,6 +8,12 @@
 
 #include <string>
 #include <map>
+#include <set>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 class RecalboxConf {
 
@@ -18,7 +24,12 @@ public:
 
     bool loadRecalboxConf(bool mainFile = true);
 
-    bool saveRecalboxConf();
+    // Saves are coalesced: the keys set since the last write are written by the next update()
+    void saveRecalboxConf();
+    // Once per frame, hands the keys saved to the writer thread
+    void update();
+    // Write what was saved and wait for it, before something else reads the file
+    bool sync();
 
     std::string get(const std::string &name);
     std::string get(const std::string &name, const std::string &defaultValue);
@@ -31,12 +42,49 @@ public:
 
     bool isInList(const std::string &name, const std::string &value);
 
+    // Called after a set that changes the value, so that readers can keep it rather than look it up
+    typedef std::function<void(const std::string &name)> ChangeCallback;
+    void addChangeCallback(const std::string &name, const void *owner, const ChangeCallback &callback);
+    void removeChangeCallbacks(const void *owner);
+
     static RecalboxConf *sInstance;
 
     static RecalboxConf *getInstance();
 private:
     std::map<std::string, std::string> confMap;
 
+    struct Listener {
+        const void *owner;
+        ChangeCallback callback;
+    };
+    std::map<std::string, std::vector<Listener> > listeners;
+
+    void setValue(const std::string &name, const std::string &value);
+
+    // set since the last write
+    std::set<std::string> dirtyKeys;
+    bool savePending;
+
+    // The writer patches the lines of the keys it is given in the file, read again only if changed by
+    // someone else, and replaces the file atomically. toWrite and the flags are guarded by writeMutex,
+    // the lines are the writer's own.
+    void writerLoop();
+    bool writeFile(const std::map<std::string, std::string> &values);
+    bool readFile();
+
+    std::thread writer;
+    std::mutex writeMutex;
+    std::condition_variable writeCondition;
+    std::map<std::string, std::string> toWrite;
+    bool writing;
+    bool writeOk;
+    bool quit;
+
+    // lines of the file as last read or written, with the lines of each key
+    std::vector<std::string> fileLines;
+    std::map<std::string, std::vector<size_t> > keyLines;
+    std::map<std::string, size_t> commentedKeyLines;
+    std::string fileStamp;
 };
 
 
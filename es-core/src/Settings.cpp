@@ -4,6 +4,7 @@
 #include "platform.h"
 #include <boost/filesystem.hpp>
 #include <boost/assign.hpp>
+#include <algorithm>
 
 Settings *Settings::sInstance = NULL;
 
@@ -81,10 +82,15 @@ void Settings::setDefaults() {
 	mIntMap["MusicPopupTime"] = 3;
     mIntMap["ScraperResizeWidth"] = 400;
     mIntMap["ScraperResizeHeight"] = 0;
+    mIntMap["ScraperThreads"] = 0; // games scraped at once, 0 for the scraper's default
+    mIntMap["ScraperCacheDays"] = 30; // 0 keeps the responses forever
+    mIntMap["ScraperCacheSize"] = 64; // MB
+    mIntMap["ThumbnailCacheSize"] = 256; // MB
     mIntMap["SystemVolume"] = 96;
 	mIntMap["HelpPopupTime"] = 4;
     mIntMap["NetplayPopupTime"] = 4;
 	mIntMap["MaxVRAM"] = 80;
+	mIntMap["SystemResidency"] = 2; // systems on each side of the carousel cursor kept in memory
 
     mStringMap["TransitionStyle"] = "fade";
     mStringMap["PopupPosition"] = "Top/Right";
@@ -97,6 +103,7 @@ void Settings::setDefaults() {
 	mStringMap["ThemeRegionName"] = "eu";
     mStringMap["ScreenSaverBehavior"] = "dim";
     mStringMap["Scraper"] = "Screenscraper";
+    mStringMap["ScreenscraperServer"] = "https://screenscraper.recalbox.com"; // a local stand-in to measure scraping offline
     mStringMap["Lang"] = "en_US";
     mStringMap["INPUT P1"] = "DEFAULT";
     mStringMap["INPUT P2"] = "DEFAULT";
@@ -187,7 +194,8 @@ void Settings::loadFile() {
 }
 
 //Print a warning message if the setting we're trying to get doesn't already exist in the map, then return the value in the map.
-#define SETTINGS_GETSET(type, mapName, getMethodName, setMethodName) type Settings::getMethodName(const std::string& name) \
+//A set that changes the value notifies its listeners.
+#define SETTINGS_GETSET(type, mapName, getMethodName, setMethodName, handleType, getHandleMethodName) type Settings::getMethodName(const std::string& name) \
 { \
     if(mapName.find(name) == mapName.end()) \
     { \
@@ -197,13 +205,49 @@ void Settings::loadFile() {
 } \
 void Settings::setMethodName(const std::string& name, type value) \
 { \
+    auto it = mapName.find(name); \
+    if(it != mapName.end() && it->second == value) \
+        return; \
     mapName[name] = value; \
+    notifyChange(name); \
+} \
+SettingHandle<handleType> Settings::getHandleMethodName(const std::string& name) \
+{ \
+    getMethodName(name); \
+    return SettingHandle<handleType>(&mapName[name]); \
 }
 
-SETTINGS_GETSET(bool, mBoolMap, getBool, setBool);
+SETTINGS_GETSET(bool, mBoolMap, getBool, setBool, bool, getBoolHandle);
+
+SETTINGS_GETSET(int, mIntMap, getInt, setInt, int, getIntHandle);
 
-SETTINGS_GETSET(int, mIntMap, getInt, setInt);
+SETTINGS_GETSET(float, mFloatMap, getFloat, setFloat, float, getFloatHandle);
 
-SETTINGS_GETSET(float, mFloatMap, getFloat, setFloat);
+SETTINGS_GETSET(const std::string&, mStringMap, getString, setString, std::string, getStringHandle);
 
-SETTINGS_GETSET(const std::string&, mStringMap, getString, setString);
+void Settings::addChangeCallback(const std::string& name, const void* owner, const ChangeCallback& callback)
+{
+    Listener listener = { owner, callback };
+    mListeners[name].push_back(listener);
+}
+
+void Settings::removeChangeCallbacks(const void* owner)
+{
+    for (auto it = mListeners.begin(); it != mListeners.end(); it++)
+    {
+        std::vector<Listener>& listeners = it->second;
+        listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [owner](const Listener& listener) { return listener.owner == owner; }), listeners.end());
+    }
+}
+
+void Settings::notifyChange(const std::string& name)
+{
+    auto it = mListeners.find(name);
+    if (it == mListeners.end())
+        return;
+
+    // a copy, a callback may add or remove listeners
+    std::vector<Listener> listeners = it->second;
+    for (auto listener = listeners.begin(); listener != listeners.end(); listener++)
+        listener->callback(name);
+}
@@ -1,6 +1,24 @@
 #pragma once
 #include <string>
 #include <map>
+#include <vector>
+#include <functional>
+
+// A setting looked up once: reading it is a plain load, for the paths that run every frame.
+// Values live in the nodes of the Settings maps, which never move, so a handle is valid forever.
+template<typename T>
+class SettingHandle
+{
+public:
+	inline const T& get() const { return *mValue; }
+	inline operator const T&() const { return *mValue; }
+
+private:
+	friend class Settings;
+	SettingHandle(const T* value) : mValue(value) {}
+
+	const T* mValue;
+};
 
 //This is a singleton for storing settings.
 class Settings
@@ -22,6 +40,17 @@ public:
 	void setFloat(const std::string& name, float value);
 	void setString(const std::string& name, const std::string& value);
 
+	//Handles, resolved once, to settings read in hot paths.
+	SettingHandle<bool> getBoolHandle(const std::string& name);
+	SettingHandle<int> getIntHandle(const std::string& name);
+	SettingHandle<float> getFloatHandle(const std::string& name);
+	SettingHandle<std::string> getStringHandle(const std::string& name);
+
+	//Called after a set that changes the value, on the thread that sets it.
+	typedef std::function<void(const std::string& name)> ChangeCallback;
+	void addChangeCallback(const std::string& name, const void* owner, const ChangeCallback& callback);
+	void removeChangeCallbacks(const void* owner);
+
 private:
 	static Settings* sInstance;
 
@@ -34,4 +63,13 @@ private:
 	std::map<std::string, int> mIntMap;
 	std::map<std::string, float> mFloatMap;
 	std::map<std::string, std::string> mStringMap;
+
+	void notifyChange(const std::string& name);
+
+	struct Listener
+	{
+		const void* owner;
+		ChangeCallback callback;
+	};
+	std::map<std::string, std::vector<Listener> > mListeners;
 };
@@ -3,6 +3,7 @@
 #include "Log.h"
 #include "Settings.h"
 #include "ThemeData.h"
+#include "resources/ResourceManager.h"
 
 std::map< std::string, std::shared_ptr<Sound> > Sound::sMap;
 
@@ -23,13 +24,13 @@ std::shared_ptr<Sound> Sound::getFromTheme(const std::shared_ptr<ThemeData>& the
 	LOG(LogInfo) << " req sound [" << view << "." << element << "]";
 
 	const ThemeData::ThemeElement* elem = theme->getElement(view, element, "sound");
-	if(!elem || !elem->has("path"))
+	if(!elem || !elem->has(ThemeProperty::PATH))
 	{
 		LOG(LogInfo) << "   (missing)";
 		return get("");
 	}
 
-	return get(elem->get<std::string>("path"));
+	return get(elem->get<std::string>(ThemeProperty::PATH));
 }
 
 Sound::Sound(const std::string & path) : mSampleData(NULL), playing(false)
@@ -56,8 +57,12 @@ void Sound::init()
 	if(mPath.empty())
 		return;
 
-	//load wav file via SDL
-	mSampleData = Mix_LoadWAV(mPath.c_str());
+	//load wav file via SDL, from memory as it may come from a theme pack
+	const ResourceData data = ResourceManager::getInstance()->getFileData(mPath);
+	if(data.ptr)
+		mSampleData = Mix_LoadWAV_RW(SDL_RWFromConstMem(data.ptr.get(), (int)data.length), 1);
+	else
+		mSampleData = NULL;
 	if(mSampleData == NULL) {
 		LOG(LogError) << "Error loading sound \"" << mPath << "\"!\n" << "	" << SDL_GetError();
 		return;
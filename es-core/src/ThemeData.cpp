@@ -5,9 +5,11 @@
 #include "resources/TextureResource.h"
 #include "Log.h"
 #include "Settings.h"
+#include "FileWatcher.h"
 #include "pugixml/pugixml.hpp"
 #include <boost/assign.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <set>
 
 #include "components/ImageComponent.h"
 #include "components/TextComponent.h"
@@ -24,9 +26,90 @@ ElementMapType makeMap(const T& mapInit)
 	return m;
 }
 
-std::vector<std::string> ThemeData::sSupportedViews = boost::assign::list_of("system")("basic")("detailed")("menu");
+std::vector<std::string> ThemeData::sSupportedViews = boost::assign::list_of("system")("basic")("detailed")("grid")("menu");
 std::vector<std::string> ThemeData::sSupportedFeatures = boost::assign::list_of("carousel")("z-index");
 
+// same order as ThemeProperty::Id
+static const char* sPropertyNames[ThemeProperty::COUNT] =
+{
+	"alignment",
+	"backgroundColor",
+	"color",
+	"defaultTransition",
+	"fadePath",
+	"filledPath",
+	"fontPath",
+	"fontSize",
+	"forceUppercase",
+	"horizontalMargin",
+	"iconA",
+	"iconAdvanced",
+	"iconB",
+	"iconColor",
+	"iconControllers",
+	"iconFastShutdown",
+	"iconGames",
+	"iconKodi",
+	"iconL",
+	"iconLeftRight",
+	"iconNetwork",
+	"iconQuit",
+	"iconR",
+	"iconRestart",
+	"iconScraper",
+	"iconSelect",
+	"iconShutdown",
+	"iconSound",
+	"iconStart",
+	"iconSystem",
+	"iconUI",
+	"iconUpDown",
+	"iconUpDownLeftRight",
+	"iconUpdates",
+	"iconX",
+	"iconY",
+	"lineSpacing",
+	"logoAlignment",
+	"logoRotation",
+	"logoRotationOrigin",
+	"logoScale",
+	"logoSize",
+	"margin",
+	"maxLogoCount",
+	"maxSize",
+	"origin",
+	"path",
+	"pathOff",
+	"pathOn",
+	"pos",
+	"primaryColor",
+	"rotation",
+	"rotationOrigin",
+	"scrollSound",
+	"secondaryColor",
+	"selectedColor",
+	"selectorColor",
+	"selectorHeight",
+	"selectorImagePath",
+	"selectorImageTile",
+	"selectorOffsetY",
+	"separatorColor",
+	"size",
+	"text",
+	"textColor",
+	"tile",
+	"tileSize",
+	"type",
+	"unfilledPath",
+	"value",
+	"zIndex",
+};
+
+std::map<std::string, std::shared_ptr<ThemeData::CachedFile> > ThemeData::sFileCache;
+std::string ThemeData::sFileCacheThemeSet;
+std::string ThemeData::sFileCacheRegion;
+std::mutex ThemeData::sFileCacheMutex;
+
 std::map< std::string, ElementMapType > ThemeData::sElementMap = boost::assign::map_list_of
 	("image", makeMap(boost::assign::map_list_of
 		("pos", NORMALIZED_PAIR)
@@ -75,6 +158,15 @@ std::map< std::string, ElementMapType > ThemeData::sElementMap = boost::assign::
 		("forceUppercase", BOOLEAN)
 		("lineSpacing", FLOAT)
 		("zIndex", FLOAT)))
+	("imagegrid", makeMap(boost::assign::map_list_of
+		("pos", NORMALIZED_PAIR)
+		("size", NORMALIZED_PAIR)
+		("origin", NORMALIZED_PAIR)
+		("tileSize", NORMALIZED_PAIR)
+		("margin", NORMALIZED_PAIR)
+		("color", COLOR)
+		("selectedColor", COLOR)
+		("zIndex", FLOAT)))
 	("container", makeMap(boost::assign::map_list_of
 		("pos", NORMALIZED_PAIR)
 		("size", NORMALIZED_PAIR)
@@ -253,22 +345,17 @@ void ThemeData::loadFile(const std::string systemThemeFolder, const std::string&
 	ThemeException error;
 	error.setFiles(mPaths);
 
-	if(!fs::exists(path))
+	if(!ResourceManager::getInstance()->fileExists(path))
 		throw error << "File does not exist!";
 
 	mVersion = 0;
 	mViews.clear();
 	
 	mSystemThemeFolder = systemThemeFolder;
-	
-
 
-	pugi::xml_document doc;
-	pugi::xml_parse_result res = doc.load_file(path.c_str());
-	if(!res)
-		throw error << "XML parsing error: \n    " << res.description();
+	std::shared_ptr<CachedFile> file = getCachedFile(path, error);
 
-	pugi::xml_node root = doc.child("theme");
+	pugi::xml_node root = file->doc.child("theme");
 	if(!root)
 		throw error << "Missing <theme> tag!";
 
@@ -281,8 +368,7 @@ void ThemeData::loadFile(const std::string systemThemeFolder, const std::string&
 		throw error << "Theme uses format version " << mVersion << ". Minimum supported version is " << MINIMUM_THEME_FORMAT_VERSION << ".";
 	
 	parseIncludes(root);
-	parseViews(root);
-	parseFeatures(root);
+	applyFile(file, root);
 	mPaths.pop_back();
 }
 
@@ -312,17 +398,13 @@ void ThemeData::parseIncludes(const pugi::xml_node& root)
 
 				mPaths.push_back(path);
 
-				pugi::xml_document includeDoc;
-				pugi::xml_parse_result result = includeDoc.load_file(path.c_str());
-				if(!result)
-					throw error << "Error parsing file: \n    " << result.description();
+				std::shared_ptr<CachedFile> file = getCachedFile(path, error);
 
-				pugi::xml_node root = includeDoc.child("theme");
+				pugi::xml_node root = file->doc.child("theme");
 				if(!root)
 					throw error << "Missing <theme> tag!";
 				parseIncludes(root);
-				parseViews(root);
-				parseFeatures(root);
+				applyFile(file, root);
 			
 				mPaths.pop_back();
 			}			
@@ -330,6 +412,149 @@ void ThemeData::parseIncludes(const pugi::xml_node& root)
 	}
 }
 
+// theme files may be packed, see ResourceManager::mountPack
+static pugi::xml_parse_result loadThemeDocument(pugi::xml_document& doc, const std::string& path)
+{
+	const ResourceData data = ResourceManager::getInstance()->getFileData(path);
+	if(!data.ptr)
+	{
+		pugi::xml_parse_result result;
+		result.status = pugi::status_file_not_found;
+		return result;
+	}
+	return doc.load_buffer(data.ptr.get(), data.length);
+}
+
+// subdirectories of a theme directory, on disk or packed
+static std::vector<fs::path> getThemeDirectories(const fs::path& path)
+{
+	std::vector<fs::path> directories;
+	boost::system::error_code ec;
+	for(fs::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if(fs::is_directory(it->status()))
+			directories.push_back(it->path());
+	}
+
+	const std::vector<std::string> packed = ResourceManager::getInstance()->getPackedDirectories(path.generic_string());
+	for(auto it = packed.begin(); it != packed.end(); it++)
+	{
+		if(std::find(directories.begin(), directories.end(), path / *it) == directories.end())
+			directories.push_back(path / *it);
+	}
+	return directories;
+}
+
+// true if a text of the node or of its children, includes aside, uses $system
+static bool hasSystemVariable(const pugi::xml_node& node)
+{
+	for(pugi::xml_node child = node.first_child(); child; child = child.next_sibling())
+	{
+		if(child.type() == pugi::node_pcdata || child.type() == pugi::node_cdata)
+		{
+			if(strstr(child.value(), "$system") != NULL)
+				return true;
+		}
+		else if(strcmp(child.name(), "include") != 0 && hasSystemVariable(child))
+			return true;
+	}
+	return false;
+}
+
+std::shared_ptr<ThemeData::CachedFile> ThemeData::getCachedFile(const std::string& path, ThemeException& error)
+{
+	const std::time_t modified = ResourceManager::getInstance()->getLastWriteTime(path);
+
+	// subsets only decide which files are included, each file is parsed the same whatever they are.
+	// The region decides which elements a file defines, so it only invalidates the definitions.
+	const std::string themeSet = Settings::getInstance()->getString("ThemeSet");
+	const std::string region = Settings::getInstance()->getString("ThemeRegionName");
+
+	{
+		std::lock_guard<std::mutex> lock(sFileCacheMutex);
+		if(themeSet != sFileCacheThemeSet)
+		{
+			sFileCache.clear();
+			sFileCacheThemeSet = themeSet;
+			sFileCacheRegion = region;
+		}
+		else if(region != sFileCacheRegion)
+		{
+			for(auto it = sFileCache.begin(); it != sFileCache.end(); it++)
+				it->second->definitions.clear();
+			sFileCacheRegion = region;
+		}
+
+		auto it = sFileCache.find(path);
+		if(it != sFileCache.end() && it->second->modified == modified)
+			return it->second;
+	}
+
+	// parsed out of the lock, systems loading at the same time may each parse it once
+	std::shared_ptr<CachedFile> file = std::make_shared<CachedFile>();
+	file->modified = modified;
+	pugi::xml_parse_result res = loadThemeDocument(file->doc, path);
+	if(!res)
+		throw error << "XML parsing error: \n    " << res.description();
+	file->usesSystemVariable = hasSystemVariable(file->doc.child("theme"));
+
+	std::lock_guard<std::mutex> lock(sFileCacheMutex);
+	sFileCache[path] = file;
+	return file;
+}
+
+void ThemeData::applyFile(const std::shared_ptr<CachedFile>& file, const pugi::xml_node& root)
+{
+	const std::string key = file->usesSystemVariable ? mSystemThemeFolder : "";
+
+	std::shared_ptr<const FileDefinitions> definitions;
+	{
+		std::lock_guard<std::mutex> lock(sFileCacheMutex);
+		auto it = file->definitions.find(key);
+		if(it != file->definitions.end())
+			definitions = it->second;
+	}
+
+	if(!definitions)
+	{
+		std::shared_ptr<FileDefinitions> parsed = std::make_shared<FileDefinitions>();
+		parsed->hasMenuView = false;
+		parseViews(root, *parsed);
+		parseFeatures(root, *parsed);
+
+		std::lock_guard<std::mutex> lock(sFileCacheMutex);
+		definitions = file->definitions.insert(std::make_pair(key, std::shared_ptr<const FileDefinitions>(parsed))).first->second;
+	}
+
+	if(definitions->hasMenuView)
+		Settings::getInstance()->setBool("ThemeHasMenuView", true);
+
+	for(auto it = definitions->elements.begin(); it != definitions->elements.end(); it++)
+		mergeElement(*it);
+}
+
+void ThemeData::mergeElement(const ElementDefinition& definition)
+{
+	ThemeView& view = mViews[definition.view];
+	if(definition.name.empty())
+		return;
+
+	auto it = view.elements.find(definition.name);
+	if(it == view.elements.end())
+	{
+		view.elements[definition.name] = definition.element;
+		view.orderedKeys.push_back(definition.name);
+		return;
+	}
+
+	// copy on write: the element may be shared with the cache and other systems
+	std::shared_ptr<ThemeElement>& element = it->second;
+	if(element.use_count() > 1)
+		element = std::make_shared<ThemeElement>(*element);
+
+	element->merge(*definition.element);
+}
+
 bool ThemeData::parseSubset(const pugi::xml_node& node)
 {
 	bool parse = true;
@@ -372,7 +597,7 @@ bool ThemeData::parseSubset(const pugi::xml_node& node)
 	
 }
 
-void ThemeData::parseFeatures(const pugi::xml_node& root)
+void ThemeData::parseFeatures(const pugi::xml_node& root, FileDefinitions& definitions)
 {
 	ThemeException error;
 	error.setFiles(mPaths);
@@ -386,12 +611,12 @@ void ThemeData::parseFeatures(const pugi::xml_node& root)
 
 		if (std::find(sSupportedFeatures.begin(), sSupportedFeatures.end(), supportedAttr) != sSupportedFeatures.end())
 		{
-			parseViews(node);
+			parseViews(node, definitions);
 		}
 	}
 }
 
-void ThemeData::parseViews(const pugi::xml_node& root)
+void ThemeData::parseViews(const pugi::xml_node& root, FileDefinitions& definitions)
 {
 	ThemeException error;
 	error.setFiles(mPaths);
@@ -407,24 +632,30 @@ void ThemeData::parseViews(const pugi::xml_node& root)
 		size_t prevOff = nameAttr.find_first_not_of(delim, 0);
 		size_t off = nameAttr.find_first_of(delim, prevOff);
 		std::string viewKey;
+		std::vector<std::string> viewKeys;
 		while(off != std::string::npos || prevOff != std::string::npos)
 		{
 			viewKey = nameAttr.substr(prevOff, off - prevOff);
 			if (viewKey == "menu")
-				Settings::getInstance()->setBool("ThemeHasMenuView", true);
+				definitions.hasMenuView = true;
 			prevOff = nameAttr.find_first_not_of(delim, off);
 			off = nameAttr.find_first_of(delim, prevOff);
 			
 			if (std::find(sSupportedViews.begin(), sSupportedViews.end(), viewKey) != sSupportedViews.end())
 			{
-				ThemeView& view = mViews.insert(std::pair<std::string, ThemeView>(viewKey, ThemeView())).first->second;
-				parseView(node, view);
+				// the view exists even without elements
+				ElementDefinition definition = { viewKey, "", nullptr };
+				definitions.elements.push_back(definition);
+				viewKeys.push_back(viewKey);
 			}
 		}
+
+		if (!viewKeys.empty())
+			parseView(node, viewKeys, definitions);
 	}
 }
 
-void ThemeData::parseView(const pugi::xml_node& root, ThemeView& view)
+void ThemeData::parseView(const pugi::xml_node& root, const std::vector<std::string>& viewKeys, FileDefinitions& definitions)
 {
 	ThemeException error;
 	error.setFiles(mPaths);
@@ -442,6 +673,9 @@ void ThemeData::parseView(const pugi::xml_node& root, ThemeView& view)
 		
 		if (parseRegion(node))
 		{
+			// parsed once, shared by every name and view it is defined for
+			std::shared_ptr<ThemeElement> element = std::make_shared<ThemeElement>();
+			parseElement(node, elemTypeIt->second, *element);
 
 			const char* delim = " \t\r\n,";
 			const std::string nameAttr = node.attribute("name").as_string();
@@ -453,11 +687,11 @@ void ThemeData::parseView(const pugi::xml_node& root, ThemeView& view)
 				prevOff = nameAttr.find_first_not_of(delim, off);
 				off = nameAttr.find_first_of(delim, prevOff);
 			
-				parseElement(node, elemTypeIt->second, 
-					view.elements.insert(std::pair<std::string, ThemeElement>(elemKey, ThemeElement())).first->second);
-
-				if(std::find(view.orderedKeys.begin(), view.orderedKeys.end(), elemKey) == view.orderedKeys.end())
-					view.orderedKeys.push_back(elemKey);
+				for (auto viewKey = viewKeys.begin(); viewKey != viewKeys.end(); viewKey++)
+				{
+					ElementDefinition definition = { *viewKey, elemKey, element };
+					definitions.elements.push_back(definition);
+				}
 			}
 		}
 	}
@@ -493,6 +727,52 @@ bool ThemeData::parseRegion(const pugi::xml_node& node)
 }
 
 
+ThemeProperty::Id ThemeData::getPropertyId(const std::string& name)
+{
+	static const std::map<std::string, ThemeProperty::Id> ids = [] {
+		std::map<std::string, ThemeProperty::Id> map;
+		for(unsigned char i = 0; i < ThemeProperty::COUNT; i++)
+			map[sPropertyNames[i]] = (ThemeProperty::Id)i;
+		return map;
+	}();
+
+	auto it = ids.find(name);
+	return it != ids.end() ? it->second : ThemeProperty::COUNT;
+}
+
+void ThemeData::ThemeElement::set(ThemeProperty::Id prop, const Property& value)
+{
+	auto it = std::lower_bound(mProperties.begin(), mProperties.end(), prop,
+		[](const std::pair<ThemeProperty::Id, Property>& p, ThemeProperty::Id id) { return p.first < id; });
+	if(it != mProperties.end() && it->first == prop)
+		it->second = value;
+	else
+		mProperties.insert(it, std::make_pair(prop, value));
+	mDefined.set(prop);
+}
+
+void ThemeData::ThemeElement::merge(const ThemeElement& other)
+{
+	type = other.type;
+	extra = other.extra;
+	for(auto it = other.mProperties.begin(); it != other.mProperties.end(); it++)
+		set(it->first, it->second);
+}
+
+bool ThemeData::ThemeElement::operator==(const ThemeElement& other) const
+{
+	return extra == other.extra && type == other.type && mDefined == other.mDefined && mProperties == other.mProperties;
+}
+
+const ThemeData::ThemeElement::Property& ThemeData::ThemeElement::at(ThemeProperty::Id prop) const
+{
+	auto it = std::lower_bound(mProperties.begin(), mProperties.end(), prop,
+		[](const std::pair<ThemeProperty::Id, Property>& p, ThemeProperty::Id id) { return p.first < id; });
+	if(it == mProperties.end() || it->first != prop)
+		throw std::out_of_range(std::string("Theme property not defined: ") + sPropertyNames[prop]);
+	return it->second;
+}
+
 void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::string, ElementPropertyType>& typeMap, ThemeElement& element)
 {
 	ThemeException error;
@@ -506,6 +786,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 		auto typeIt = typeMap.find(node.name());
 		if(typeIt == typeMap.end())
 			throw error << "Unknown property type \"" << node.name() << "\" (for element of type " << root.name() << ").";
+		const ThemeProperty::Id prop = getPropertyId(node.name());
 		
 		std::string str = resolveSystemVariable(mSystemThemeFolder, node.text().as_string());
 
@@ -523,11 +804,11 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 
 			Eigen::Vector2f val(atof(first.c_str()), atof(second.c_str()));
 
-			element.properties[node.name()] = val;
+			element.set(prop, val);
 			break;
 		}
 		case STRING:
-			element.properties[node.name()] = str;
+			element.set(prop, str);
 			break;
 		case PATH:
 		{
@@ -547,16 +828,16 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 				}
 				break;
 			}
-			element.properties[node.name()] = path;
+			element.set(prop, path);
 			break;
 		}
 		case COLOR:
-			element.properties[node.name()] = getHexColor(str.c_str());
+			element.set(prop, getHexColor(str.c_str()));
 			break;
 		case FLOAT:
 			{
 			float floatVal = static_cast<float>(strtod(str.c_str(), 0));
-			element.properties[node.name()] = floatVal;
+			element.set(prop, floatVal);
   			break;
 			}
 		case BOOLEAN:
@@ -565,7 +846,7 @@ void ThemeData::parseElement(const pugi::xml_node& root, const std::map<std::str
 			char first = str[0];
 			// 1*, t* (true), T* (True), y* (yes), Y* (YES)
 			bool boolVal = (first == '1' || first == 't' || first == 'T' || first == 'y' || first == 'Y');
-			element.properties[node.name()] = boolVal;
+			element.set(prop, boolVal);
   			break;
 			}
 		default:
@@ -584,14 +865,42 @@ const ThemeData::ThemeElement* ThemeData::getElement(const std::string& view, co
 	auto elemIt = viewIt->second.elements.find(element);
 	if(elemIt == viewIt->second.elements.end()) return NULL;
 
-	if(elemIt->second.type != expectedType && !expectedType.empty())
+	if(elemIt->second->type != expectedType && !expectedType.empty())
 	{
 		LOG(LogWarning) << " requested mismatched theme type for [" << view << "." << element << "] - expected \"" 
-			<< expectedType << "\", got \"" << elemIt->second.type << "\"";
+			<< expectedType << "\", got \"" << elemIt->second->type << "\"";
 		return NULL;
 	}
 
-	return &elemIt->second;
+	return elemIt->second.get();
+}
+
+std::vector<std::string> ThemeData::getChangedElements(const ThemeData& other, const std::string& view) const
+{
+	static const ThemeView empty;
+	auto viewIt = mViews.find(view);
+	auto otherViewIt = other.mViews.find(view);
+	const ThemeView& elements = viewIt != mViews.end() ? viewIt->second : empty;
+	const ThemeView& otherElements = otherViewIt != other.mViews.end() ? otherViewIt->second : empty;
+
+	std::vector<std::string> changed;
+	for(auto it = elements.elements.begin(); it != elements.elements.end(); it++)
+	{
+		auto otherIt = otherElements.elements.find(it->first);
+		if(otherIt == otherElements.elements.end() || (otherIt->second != it->second && *otherIt->second != *it->second))
+			changed.push_back(it->first);
+	}
+	for(auto it = otherElements.elements.begin(); it != otherElements.elements.end(); it++)
+	{
+		if(elements.elements.find(it->first) == elements.elements.end())
+			changed.push_back(it->first);
+	}
+
+	// extras are drawn in declaration order
+	if(changed.empty() && elements.orderedKeys != otherElements.orderedKeys)
+		changed = elements.orderedKeys;
+
+	return changed;
 }
 
 const std::shared_ptr<ThemeData>& ThemeData::getDefault()
@@ -622,7 +931,8 @@ const std::shared_ptr<ThemeData>& ThemeData::getDefault()
 const std::shared_ptr<ThemeData>& ThemeData::getCurrent()
 {
 	static std::shared_ptr<ThemeData> theme = nullptr;
-	if(theme == nullptr || Settings::getInstance()->getBool("ThemeChanged"))
+	static const SettingHandle<bool> themeChanged = Settings::getInstance()->getBoolHandle("ThemeChanged");
+	if(theme == nullptr || themeChanged)
 	{
 		theme = std::shared_ptr<ThemeData>(new ThemeData());
 		fs::path path;
@@ -634,36 +944,28 @@ const std::shared_ptr<ThemeData>& ThemeData::getCurrent()
 		};
 	
 
-		fs::directory_iterator end;
-
 		for(size_t i = 0; i < pathCount; i++)
 		{
-			if(!fs::is_directory(paths[i]))
-				continue;
-
-			for(fs::directory_iterator it(paths[i]); it != end; ++it)
+			const std::vector<fs::path> directories = getThemeDirectories(paths[i]);
+			for(auto it = directories.begin(); it != directories.end(); ++it)
 			{
-				if(fs::is_directory(*it))
+				path = *it / "theme.xml";
+				if(ResourceManager::getInstance()->fileExists(path.string()))
 				{
-					path = *it / "theme.xml";
-					if(fs::exists(path))
+					try
 					{
-						try
-						{
-							std::string empty = "";
-							theme->loadFile(empty, path.string());
-							return theme;
-						} catch(ThemeException& e)
-						{
-							LOG(LogError) << e.what();
-							theme = std::shared_ptr<ThemeData>(new ThemeData()); //reset to empty
-						}
+						std::string empty = "";
+						theme->loadFile(empty, path.string());
+						return theme;
+					} catch(ThemeException& e)
+					{
+						LOG(LogError) << e.what();
+						theme = std::shared_ptr<ThemeData>(new ThemeData()); //reset to empty
 					}
-				
 				}
 			}
 			path = paths[i] / "theme.xml";
-			if(fs::exists(path))
+			if(ResourceManager::getInstance()->fileExists(path.string()))
 					{
 						try
 						{
@@ -692,6 +994,12 @@ void ThemeExtras::setExtras(const std::vector<GuiComponent*>& extras)
 		addChild(*it);
 }
 
+void ThemeExtras::getTextures(std::vector< std::shared_ptr<TextureResource> >& textures) const
+{
+	for(auto it = mExtras.begin(); it != mExtras.end(); it++)
+		(*it)->getTextures(textures);
+}
+
 ThemeExtras::~ThemeExtras()
 {
 	for(auto it = mExtras.begin(); it != mExtras.end(); it++)
@@ -709,7 +1017,7 @@ std::vector<GuiComponent*> ThemeData::makeExtras(const std::shared_ptr<ThemeData
 	
 	for(auto it = viewIt->second.orderedKeys.begin(); it != viewIt->second.orderedKeys.end(); it++)
 	{
-		ThemeElement& elem = viewIt->second.elements.at(*it);
+		const ThemeElement& elem = *viewIt->second.elements.at(*it);
 		if(elem.extra)
 		{
 			GuiComponent* comp = NULL;
@@ -728,20 +1036,90 @@ std::vector<GuiComponent*> ThemeData::makeExtras(const std::shared_ptr<ThemeData
 	return comps;
 }
 
+// Theme sets and their subsets are crawled once, then only again when something changes
+// in the theme directories. Loading threads ask for them concurrently.
+static std::mutex sThemeSetsMutex;
+static std::unique_ptr<FileWatcher> sThemeSetsWatcher;
+static bool sThemeSetsValid = false;
+static std::map<std::string, ThemeSet> sThemeSets;
+static std::map< std::string, std::map<std::string, std::string> > sThemeSubSets;
+// theme directories that did not exist, so could not be watched, when the sets were crawled
+static std::vector<fs::path> sMissingThemeRoots;
+// mount points of the packed theme sets found by the last crawl
+static std::set<std::string> sThemePackMounts;
+
+static const size_t themeRootCount = 2;
+
+static void getThemeRoots(fs::path roots[themeRootCount])
+{
+	roots[0] = "/etc/emulationstation/themes";
+	roots[1] = getHomePath() + "/.emulationstation/themes";
+}
+
+// Forget what changed since the last call. Must be called with sThemeSetsMutex locked.
+static void refreshThemeSets()
+{
+	if(!sThemeSetsWatcher)
+		sThemeSetsWatcher.reset(new FileWatcher());
+
+	std::vector<std::string> changes;
+	if(!sThemeSetsWatcher->poll(changes))
+	{
+		sThemeSetsValid = false;
+		sThemeSubSets.clear();
+		return;
+	}
+
+	for(auto it = sMissingThemeRoots.begin(); it != sMissingThemeRoots.end(); it++)
+		if(fs::is_directory(*it))
+			sThemeSetsValid = false;
+
+	fs::path roots[themeRootCount];
+	getThemeRoots(roots);
+	for(auto change = changes.begin(); change != changes.end(); change++)
+	{
+		for(size_t i = 0; i < themeRootCount; i++)
+		{
+			const std::string root = roots[i].generic_string() + "/";
+			if(change->compare(0, root.size(), root) != 0)
+				continue;
+
+			// a theme set directory or pack itself, or a file inside a theme set
+			const size_t slash = change->find('/', root.size());
+			std::string name = change->substr(root.size(), slash - root.size());
+			if(slash == std::string::npos)
+			{
+				sThemeSetsValid = false;
+				if(fs::path(name).extension() == ".pack")
+					name = fs::path(name).stem().string();
+			}
+			sThemeSubSets.erase(name);
+		}
+	}
+}
+
 std::map<std::string, ThemeSet> ThemeData::getThemeSets()
 {
-	std::map<std::string, ThemeSet> sets;
+	std::lock_guard<std::mutex> lock(sThemeSetsMutex);
+	refreshThemeSets();
+	if(sThemeSetsValid)
+		return sThemeSets;
+
+	std::map<std::string, ThemeSet>& sets = sThemeSets;
+	sets.clear();
+	sMissingThemeRoots.clear();
+	std::set<std::string> packMounts;
 
-	static const size_t pathCount = 2;
-	fs::path paths[pathCount] = { 
-		"/etc/emulationstation/themes", 
-		getHomePath() + "/.emulationstation/themes" 
-	};
+	fs::path paths[themeRootCount];
+	getThemeRoots(paths);
 
 	fs::directory_iterator end;
 
-	for(size_t i = 0; i < pathCount; i++)
+	for(size_t i = 0; i < themeRootCount; i++)
 	{
+		// watched before crawling, so nothing changing meanwhile is missed
+		if(!fs::is_directory(paths[i]) || !sThemeSetsWatcher->watch(paths[i].generic_string(), false))
+			sMissingThemeRoots.push_back(paths[i]);
 		if(!fs::is_directory(paths[i]))
 			continue;
 
@@ -752,50 +1130,69 @@ std::map<std::string, ThemeSet> ThemeData::getThemeSets()
 				ThemeSet set = {*it};
 				sets[set.getName()] = set;
 			}
+			// a packed theme set is served as if it was extracted next to its pack
+			else if(it->path().extension() == ".pack")
+			{
+				const fs::path mountPoint = it->path().parent_path() / it->path().stem();
+				if(ResourceManager::getInstance()->mountPack(it->path().generic_string(), mountPoint.generic_string()))
+				{
+					ThemeSet set = {mountPoint};
+					sets[set.getName()] = set;
+					packMounts.insert(mountPoint.generic_string());
+				}
+			}
 		}
 	}
 
+	// packs removed, or no longer valid, since the last crawl
+	for(auto it = sThemePackMounts.begin(); it != sThemePackMounts.end(); it++)
+		if(packMounts.find(*it) == packMounts.end())
+			ResourceManager::getInstance()->unmountPack(*it);
+	sThemePackMounts.swap(packMounts);
+
+	sThemeSetsValid = true;
 	return sets;
 }
 
 std::map<std::string, std::string> ThemeData::getThemeSubSets(const std::string& theme)
 {
+	std::lock_guard<std::mutex> lock(sThemeSetsMutex);
+	refreshThemeSets();
+	auto cached = sThemeSubSets.find(theme);
+	if(cached != sThemeSubSets.end())
+		return cached->second;
+
 	std::map<std::string, std::string> sets;
 	fs::path path;
 	std::deque<boost::filesystem::path> dequepath;
-	static const size_t pathCount = 2;
-	fs::path paths[pathCount] = { 
-		"/etc/emulationstation/themes/" + theme, 
-		getHomePath() + "/.emulationstation/themes/" + theme
-	};
-	
-
-	fs::directory_iterator end;
+	const size_t pathCount = themeRootCount;
+	fs::path paths[pathCount];
+	getThemeRoots(paths);
+	for(size_t i = 0; i < pathCount; i++)
+		paths[i] /= theme;
 
 	for(size_t i = 0; i < pathCount; i++)
 	{
-		if(!fs::is_directory(paths[i]))
-			continue;
+		if(fs::is_directory(paths[i]))
+			sThemeSetsWatcher->watch(paths[i].generic_string(), true);
 
-		for(fs::directory_iterator it(paths[i]); it != end; ++it)
+		const std::vector<fs::path> directories = getThemeDirectories(paths[i]);
+		for(auto it = directories.begin(); it != directories.end(); ++it)
 		{
-			if(fs::is_directory(*it))
-			{
-				path = *it / "theme.xml";
-				dequepath.push_back(path);
-				pugi::xml_document doc;
-				pugi::xml_parse_result res = doc.load_file(path.c_str());
-				pugi::xml_node root = doc.child("theme");
-				crawlIncludes(root, sets, dequepath);
-				dequepath.pop_back();
-			}
+			path = *it / "theme.xml";
+			dequepath.push_back(path);
+			pugi::xml_document doc;
+			pugi::xml_parse_result res = loadThemeDocument(doc, path.string());
+			pugi::xml_node root = doc.child("theme");
+			crawlIncludes(root, sets, dequepath);
+			dequepath.pop_back();
 		}
 		path = paths[i] / "theme.xml";
-			if(fs::exists(path))
+			if(ResourceManager::getInstance()->fileExists(path.string()))
 			{
 				dequepath.push_back(path);
 				pugi::xml_document doc;
-				pugi::xml_parse_result res = doc.load_file(path.c_str());
+				pugi::xml_parse_result res = loadThemeDocument(doc, path.string());
 				pugi::xml_node root = doc.child("theme");			
 				crawlIncludes(root, sets, dequepath);
 				findRegion(doc, sets);
@@ -803,6 +1200,7 @@ std::map<std::string, std::string> ThemeData::getThemeSubSets(const std::string&
 			}
 	}
 
+	sThemeSubSets[theme] = sets;
 	return sets;
 }
 
@@ -817,7 +1215,7 @@ void ThemeData::crawlIncludes(const pugi::xml_node& root, std::map<std::string,
 		std::string path = resolvePath(relPath, dequepath.back());
 		dequepath.push_back(path);
 		pugi::xml_document includeDoc;
-		pugi::xml_parse_result result = includeDoc.load_file(path.c_str());
+		pugi::xml_parse_result result = loadThemeDocument(includeDoc, path);
 		pugi::xml_node root = includeDoc.child("theme");
 		crawlIncludes(root, sets, dequepath);
 		findRegion(includeDoc, sets);
@@ -874,16 +1272,16 @@ std::string ThemeData::getTransition()
 	std::string result = "";
 	auto elem = getElement("system", "systemcarousel", "carousel");
 	if (elem) {
-		if (elem->has("defaultTransition")) {
-			if (!(elem->get<std::string>("defaultTransition").compare("instant"))) {
+		if (elem->has(ThemeProperty::DEFAULT_TRANSITION)) {
+			if (!(elem->get<std::string>(ThemeProperty::DEFAULT_TRANSITION).compare("instant"))) {
 				result = "instant";
 				return result;
 			}
-			if (!(elem->get<std::string>("defaultTransition").compare("fade"))) {
+			if (!(elem->get<std::string>(ThemeProperty::DEFAULT_TRANSITION).compare("fade"))) {
 				result = "fade";
 				return result;
 			}
-			if (!(elem->get<std::string>("defaultTransition").compare("slide"))) {
+			if (!(elem->get<std::string>(ThemeProperty::DEFAULT_TRANSITION).compare("slide"))) {
 				result = "slide";
 				return result;
 			}
@@ -899,5 +1297,5 @@ bool ThemeData::getHasFavoritesInTheme()
 
 bool ThemeData::isFolderHandled() const {
 	auto elem = getElement("detailed", "md_folder_name", "text");
-	return elem ? elem->has("pos") : false;
+	return elem ? elem->has(ThemeProperty::POS) : false;
 }
\ No newline at end of file
@@ -5,7 +5,10 @@
 #include <memory>
 #include <map>
 #include <deque>
+#include <bitset>
 #include <string>
+#include <mutex>
+#include <ctime>
 #include <boost/filesystem.hpp>
 #include <boost/variant.hpp>
 #include <Eigen/Dense>
@@ -44,6 +47,87 @@ namespace ThemeFlags
 	};
 }
 
+namespace ThemeProperty
+{
+	// Every property an element can have, so elements can be looked up by index instead of name
+	enum Id : unsigned char
+	{
+		ALIGNMENT,
+		BACKGROUND_COLOR,
+		COLOR,
+		DEFAULT_TRANSITION,
+		FADE_PATH,
+		FILLED_PATH,
+		FONT_PATH,
+		FONT_SIZE,
+		FORCE_UPPERCASE,
+		HORIZONTAL_MARGIN,
+		ICON_A,
+		ICON_ADVANCED,
+		ICON_B,
+		ICON_COLOR,
+		ICON_CONTROLLERS,
+		ICON_FAST_SHUTDOWN,
+		ICON_GAMES,
+		ICON_KODI,
+		ICON_L,
+		ICON_LEFT_RIGHT,
+		ICON_NETWORK,
+		ICON_QUIT,
+		ICON_R,
+		ICON_RESTART,
+		ICON_SCRAPER,
+		ICON_SELECT,
+		ICON_SHUTDOWN,
+		ICON_SOUND,
+		ICON_START,
+		ICON_SYSTEM,
+		ICON_UI,
+		ICON_UP_DOWN,
+		ICON_UP_DOWN_LEFT_RIGHT,
+		ICON_UPDATES,
+		ICON_X,
+		ICON_Y,
+		LINE_SPACING,
+		LOGO_ALIGNMENT,
+		LOGO_ROTATION,
+		LOGO_ROTATION_ORIGIN,
+		LOGO_SCALE,
+		LOGO_SIZE,
+		MARGIN,
+		MAX_LOGO_COUNT,
+		MAX_SIZE,
+		ORIGIN,
+		PATH,
+		PATH_OFF,
+		PATH_ON,
+		POS,
+		PRIMARY_COLOR,
+		ROTATION,
+		ROTATION_ORIGIN,
+		SCROLL_SOUND,
+		SECONDARY_COLOR,
+		SELECTED_COLOR,
+		SELECTOR_COLOR,
+		SELECTOR_HEIGHT,
+		SELECTOR_IMAGE_PATH,
+		SELECTOR_IMAGE_TILE,
+		SELECTOR_OFFSET_Y,
+		SEPARATOR_COLOR,
+		SIZE,
+		TEXT,
+		TEXT_COLOR,
+		TILE,
+		TILE_SIZE,
+		TYPE,
+		UNFILLED_PATH,
+		VALUE,
+		Z_INDEX,
+
+		COUNT
+	};
+}
+
 class ThemeException : public std::exception
 {
 public:
@@ -81,6 +165,7 @@ public:
 	// will take ownership of the components within extras (delete them in destructor or when setExtras is called again)
 	void setExtras(const std::vector<GuiComponent*>& extras);
 	inline std::vector<GuiComponent*> getmExtras(){return mExtras;}
+	void getTextures(std::vector< std::shared_ptr<TextureResource> >& textures) const override;
 	inline void sortExtrasByZIndex(){
 		std::stable_sort(mExtras.begin(), mExtras.end(),  [](GuiComponent* a, GuiComponent* b) {
 			return b->getZIndex() > a->getZIndex();
@@ -110,22 +195,62 @@ public:
 		bool extra;
 		std::string type;
 
-		std::map< std::string, boost::variant<Eigen::Vector2f, std::string, unsigned int, float, bool> > properties;
+		typedef boost::variant<Eigen::Vector2f, std::string, unsigned int, float, bool> Property;
 
+		// throws std::out_of_range if the property is not defined
 		template<typename T>
-		T get(const std::string& prop) const { return boost::get<T>(properties.at(prop)); }
+		const T& get(ThemeProperty::Id prop) const { return boost::get<T>(at(prop)); }
+
+		inline bool has(ThemeProperty::Id prop) const { return mDefined[prop]; }
+
+		void set(ThemeProperty::Id prop, const Property& value);
+		// copy the properties defined by another element over these ones
+		void merge(const ThemeElement& other);
 
-		inline bool has(const std::string& prop) const { return (properties.find(prop) != properties.end()); }
+		bool operator==(const ThemeElement& other) const;
+		inline bool operator!=(const ThemeElement& other) const { return !(*this == other); }
+
+	private:
+		const Property& at(ThemeProperty::Id prop) const;
+
+		// an element only defines a few properties: they are kept sorted by id
+		std::vector< std::pair<ThemeProperty::Id, Property> > mProperties;
+		std::bitset<ThemeProperty::COUNT> mDefined;
 	};
 
 private:
 	class ThemeView
 	{
 	public:
-		std::map<std::string, ThemeElement> elements;
+		// elements may be shared with other systems, see mergeElement
+		std::map<std::string, std::shared_ptr<ThemeElement> > elements;
 		std::vector<std::string> orderedKeys;
 	};
 
+	// An element as defined by one theme file, merged into the views in file order
+	struct ElementDefinition
+	{
+		std::string view;
+		std::string name; // empty when the view is only declared
+		std::shared_ptr<ThemeElement> element;
+	};
+
+	struct FileDefinitions
+	{
+		std::vector<ElementDefinition> elements;
+		bool hasMenuView;
+	};
+
+	// A theme file parsed once for every system of a theme set. Its definitions are resolved
+	// once too, or once per system theme folder when the file uses $system.
+	struct CachedFile
+	{
+		pugi::xml_document doc;
+		std::time_t modified;
+		bool usesSystemVariable;
+		std::map<std::string, std::shared_ptr<const FileDefinitions> > definitions;
+	};
+
 public:
 
 	ThemeData();
@@ -143,8 +268,16 @@ public:
 		BOOLEAN
 	};
 
+	// ThemeProperty::COUNT if the name is not a property of any element
+	static ThemeProperty::Id getPropertyId(const std::string& name);
+
 	// If expectedType is an empty string, will do no type checking.
 	const ThemeElement* getElement(const std::string& view, const std::string& element, const std::string& expectedType) const;
+	inline bool hasView(const std::string& view) const { return mViews.find(view) != mViews.end(); }
+
+	// Names of the elements of a view that are added, removed or defined differently than in another theme.
+	// Elements both themes took from the same unchanged file are not even compared.
+	std::vector<std::string> getChangedElements(const ThemeData& other, const std::string& view) const;
 
 	static std::vector<GuiComponent*> makeExtras(const std::shared_ptr<ThemeData>& theme, const std::string& view, Window* window);
 
@@ -174,10 +307,10 @@ private:
 	std::string mGamelistview;
 	std::string mSystemThemeFolder;
 	
-	void parseFeatures(const pugi::xml_node& themeRoot);
+	void parseFeatures(const pugi::xml_node& themeRoot, FileDefinitions& definitions);
 	void parseIncludes(const pugi::xml_node& themeRoot);
-	void parseViews(const pugi::xml_node& themeRoot);
-	void parseView(const pugi::xml_node& viewNode, ThemeView& view);
+	void parseViews(const pugi::xml_node& themeRoot, FileDefinitions& definitions);
+	void parseView(const pugi::xml_node& viewNode, const std::vector<std::string>& viewKeys, FileDefinitions& definitions);
 	void parseElement(const pugi::xml_node& elementNode, const std::map<std::string, ElementPropertyType>& typeMap, ThemeElement& element);
 	bool parseRegion(const pugi::xml_node& root);
 	bool parseSubset(const pugi::xml_node& node);
@@ -186,5 +319,17 @@ private:
 	
 	std::string resolveSystemVariable(const std::string& systemThemeFolder, const std::string& path);
 
+	// throws ThemeException
+	std::shared_ptr<CachedFile> getCachedFile(const std::string& path, ThemeException& error);
+	void applyFile(const std::shared_ptr<CachedFile>& file, const pugi::xml_node& themeRoot);
+	void mergeElement(const ElementDefinition& definition);
+
+	// parsed files of the current theme set, by path
+	static std::map<std::string, std::shared_ptr<CachedFile> > sFileCache;
+	// theme set of the cached files, and region their definitions were resolved for
+	static std::string sFileCacheThemeSet;
+	static std::string sFileCacheRegion;
+	static std::mutex sFileCacheMutex;
+
 	std::map<std::string, ThemeView> mViews;
 };
@@ -206,3 +206,28 @@ boost::posix_time::ptime string_to_ptime(const std::string& str, const std::stri
 
 	return time;
 }
+
+unsigned int crc32(unsigned int crc, const void* data, size_t length)
+{
+	struct Table
+	{
+		unsigned int values[256];
+		Table()
+		{
+			for(unsigned int i = 0; i < 256; i++)
+			{
+				unsigned int c = i;
+				for(int k = 0; k < 8; k++)
+					c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+				values[i] = c;
+			}
+		}
+	};
+	static const Table table;
+
+	const unsigned char* bytes = (const unsigned char*)data;
+	crc = ~crc;
+	for(size_t i = 0; i < length; i++)
+		crc = table.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
@@ -32,3 +32,6 @@ boost::filesystem::path makeRelativePath(const boost::filesystem::path& path, co
 boost::filesystem::path resolvePath(const boost::filesystem::path& path, const boost::filesystem::path& relativeTo, bool allowHome);
 
 boost::posix_time::ptime string_to_ptime(const std::string& str, const std::string& fmt = "%Y%m%dT%H%M%S%F%q");
+
+// CRC-32 (zlib's), computed incrementally: start with crc = 0 and pass back the result for the next block
+unsigned int crc32(unsigned int crc, const void* data, size_t length);
@@ -18,8 +18,13 @@
 #include "views/ViewController.h"
 
 Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCountElapsed(0), mAverageDeltaTime(10), 
-	mAllowSleep(true), mSleeping(false), mTimeSinceLastInput(0), mInfoPopup(NULL)
+	mAllowSleep(true), mSleeping(false), mTimeSinceLastInput(0), mInfoPopup(NULL),
+	mDrawFramerate(Settings::getInstance()->getBoolHandle("DrawFramerate")),
+	mScreenSaverTime(Settings::getInstance()->getIntHandle("ScreenSaverTime"))
 {
+	// the last framerate drawn would show again when turned back on
+	Settings::getInstance()->addChangeCallback("DrawFramerate", this, [this](const std::string&) { mFrameDataText.reset(); });
+
 	mHelp = new HelpComponent(this);
 	mBackgroundOverlay = new ImageComponent(this);
 	auto menuTheme = MenuThemeData::getInstance()->getCurrentTheme();
@@ -27,6 +32,7 @@ Window::Window() : mNormalizeNextUpdate(false), mFrameTimeElapsed(0), mFrameCoun
 }
 
 Window::~Window() {
+	Settings::getInstance()->removeChangeCallbacks(this);
 	delete mBackgroundOverlay;
 	deleteAllGui();
 	delete mHelp;
@@ -195,7 +201,7 @@ void Window::update(int deltaTime)
 	{
 		mAverageDeltaTime = mFrameTimeElapsed / mFrameCountElapsed;
 		
-		if(Settings::getInstance()->getBool("DrawFramerate"))
+		if(mDrawFramerate)
 		{
 			std::stringstream ss;
 			
@@ -208,7 +214,12 @@ void Window::update(int deltaTime)
 			float textureTotalUsageMb = TextureResource::getTotalTextureSize() / 1000.0f / 1000.0f;
 			float fontVramUsageMb = Font::getTotalMemUsage() / 1000.0f / 1000.0f;;
 			ss << "\nFont VRAM: " << fontVramUsageMb << " Tex VRAM: " << textureVramUsageMb <<
-				  " Tex Max: " << textureTotalUsageMb;
+				  " Tex Max: " << textureTotalUsageMb << " Budget: " << Settings::getInstance()->getInt("MaxVRAM");
+
+			// memory kept resident by views, against their budgets
+			const std::map< std::string, std::pair<size_t, size_t> >& residencies = TextureResource::getResidencies();
+			for (auto it = residencies.begin(); it != residencies.end(); it++)
+				ss << "\n" << it->first << ": " << it->second.first / 1000.0f / 1000.0f << " / " << it->second.second / 1000.0f / 1000.0f;
 
 			mFrameDataText = std::unique_ptr<TextCache>(mDefaultFonts.at(1)->buildTextCache(ss.str(), 50.f, 50.f, 0xFF00FFFF));
 		}
@@ -246,13 +257,13 @@ void Window::render()
 	if(!mRenderedHelpPrompts)
 		mHelp->render(transform);
 
-	if(Settings::getInstance()->getBool("DrawFramerate") && mFrameDataText)
+	if(mDrawFramerate && mFrameDataText)
 	{
 		Renderer::setMatrix(Eigen::Affine3f::Identity());
 		mDefaultFonts.at(1)->renderTextCache(mFrameDataText.get());
 	}
 
-	unsigned int screensaverTime = (unsigned int)Settings::getInstance()->getInt("ScreenSaverTime");
+	unsigned int screensaverTime = (unsigned int)mScreenSaverTime.get();
 	if(mTimeSinceLastInput >= screensaverTime && screensaverTime != 0)
 	{
 
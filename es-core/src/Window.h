@@ -4,6 +4,7 @@
 #include <vector>
 #include "resources/Font.h"
 #include "InputManager.h"
+#include "Settings.h"
 
 class HelpComponent;
 class ImageComponent;
@@ -81,6 +82,10 @@ private:
 
 	std::unique_ptr<TextCache> mFrameDataText;
 
+	// read every frame
+	SettingHandle<bool> mDrawFramerate;
+	SettingHandle<int> mScreenSaverTime;
+
 	bool mNormalizeNextUpdate;
 
 	bool mAllowSleep;
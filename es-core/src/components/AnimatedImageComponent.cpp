@@ -32,6 +32,7 @@ void AnimatedImageComponent::load(const AnimationDef* def)
 	mCurrentFrame = 0;
 	mFrameAccumulator = 0;
 	mEnabled = true;
+	setUpdating(mFrames.size() > 1);
 }
 
 void AnimatedImageComponent::reset()
@@ -69,6 +70,7 @@ void AnimatedImageComponent::update(int deltaTime)
 				// done, stop at last frame
 				mCurrentFrame--;
 				mEnabled = false;
+				setUpdating(false);
 				break;
 			}
 		}
@@ -352,6 +352,8 @@ void ComponentGrid::update(int deltaTime)
     GridEntry* cursorEntry = getCellAt(mCursor);
     for(auto it = mCells.begin(); it != mCells.end(); it++)
     {
+        if(!it->component->isUpdating())
+            continue;
         if(it->updateType == UPDATE_ALWAYS || (it->updateType == UPDATE_WHEN_SELECTED && cursorEntry == &(*it)))
             it->component->update(deltaTime);
     }
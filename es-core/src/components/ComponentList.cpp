@@ -115,7 +115,8 @@ void ComponentList::update(int deltaTime)
 	{
 		// update our currently selected row
 		for(auto it = mEntries.at(mCursor).data.elements.begin(); it != mEntries.at(mCursor).data.elements.end(); it++)
-			it->component->update(deltaTime);
+			if(it->component->isUpdating())
+				it->component->update(deltaTime);
 	}
 }
 
@@ -14,12 +14,14 @@ DateTimeComponent::DateTimeComponent(Window* window, DisplayMode dispMode) : Gui
 	setFont(menuTheme->menuTextSmall.font);
 	setColor(menuTheme->menuText.color);
 	mFlag = true;
-	updateTextCache();
+	setDisplayMode(dispMode);
 }
 
 void DateTimeComponent::setDisplayMode(DisplayMode mode)
 {
 	mDisplayMode = mode;
+	// relative dates and times are refreshed every second
+	setUpdating(mDisplayMode == DISP_RELATIVE_TO_NOW || mDisplayMode == DISP_TIME);
 	updateTextCache();
 }
 
@@ -360,17 +362,17 @@ void DateTimeComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, cons
 	// setSize(), which will call updateTextCache(), which will reset mSize if 
 	// mAutoSize == true, ignoring the theme's value.
 	if(properties & ThemeFlags::SIZE)
-		mAutoSize = !elem->has("size");
+		mAutoSize = !elem->has(ThemeProperty::SIZE);
 
 	GuiComponent::applyTheme(theme, view, element, properties);
 
 	using namespace ThemeFlags;
 
-	if(properties & COLOR && elem->has("color"))
-		setColor(elem->get<unsigned int>("color"));
+	if(properties & COLOR && elem->has(ThemeProperty::COLOR))
+		setColor(elem->get<unsigned int>(ThemeProperty::COLOR));
 
-	if(properties & FORCE_UPPERCASE && elem->has("forceUppercase"))
-		setUppercase(elem->get<bool>("forceUppercase"));
+	if(properties & FORCE_UPPERCASE && elem->has(ThemeProperty::FORCE_UPPERCASE))
+		setUppercase(elem->get<bool>(ThemeProperty::FORCE_UPPERCASE));
 
 	setFont(Font::getFromTheme(elem, properties, mFont));
 }
@@ -60,6 +60,8 @@ public:
 		std::string name;
 		UserData object;
 		EntryData data;
+		// initial used for letter navigation, 0 if the entry is not indexed
+		char letter = 0;
 	};
 
 protected:
@@ -80,6 +82,9 @@ protected:
 	const ListLoopType mLoopType;
 
 	std::vector<Entry> mEntries;
+
+	// index of the first entry of each initial, -1 if none
+	int mLetterIndex[256];
 	
 public:
 	IList(Window* window, const ScrollTierList& tierList = LIST_SCROLL_STYLE_QUICK, const ListLoopType& loopType = LIST_PAUSE_AT_END) : GuiComponent(window), 
@@ -89,6 +94,7 @@ public:
 		mScrollVelocity = 0;
 		mScrollTierAccumulator = 0;
 		mScrollCursorAccumulator = 0;
+		resetLetterIndex();
 		
 		mTitleOverlayOpacity = 0x00;
 		mTitleOverlayColor = 0xFFFFFF00;
@@ -113,6 +119,7 @@ public:
 	// see onCursorChanged warn
 	void clear() {
 		mEntries.clear();
+		resetLetterIndex();
 		mCursor = 0;
 		listInput(0);
 	}
@@ -203,13 +210,32 @@ public:
 	// entry management
 	void add(const Entry& e) {
 		mEntries.push_back(e);
+		int& first = mLetterIndex[(unsigned char)e.letter];
+		if (e.letter != 0 && first < 0) {
+			first = mEntries.size() - 1;
+		}
 	}
 
 	// insert at the beginning
 	void unshift(const Entry& e) {
+		insertIntoLetterIndex(e.letter, 0);
 		mEntries.insert(mEntries.begin(), e);
 	}
 
+	// insert at the given position, the cursor stays on the same entry
+	void insert(const Entry& e, int index) {
+		insertIntoLetterIndex(e.letter, index);
+		mEntries.insert(mEntries.begin() + index, e);
+		if (index <= mCursor && mEntries.size() > 1) {
+			mCursor++;
+		}
+	}
+
+	void removeAt(int index) {
+		auto it = mEntries.begin() + index;
+		remove(it);
+	}
+
 	bool remove(const UserData& obj) {
 		int index = 0;
 		for (auto it = mEntries.begin(); it != mEntries.end(); it++) {
@@ -233,9 +259,61 @@ public:
 		if (!ascending) {
 			std::reverse(mEntries.begin(), mEntries.end());
 		}
+		resetLetterIndex();
+		for (int i = mEntries.size(); --i >= 0; ) {
+			if (mEntries[i].letter != 0) {
+				mLetterIndex[(unsigned char)mEntries[i].letter] = i;
+			}
+		}
+	}
+
+	// index of the first entry of the given initial, -1 if none
+	inline int getLetterIndex(char letter) const { return letter != 0 ? mLetterIndex[(unsigned char)letter] : -1; }
+
+	// initials of the indexed entries, in character order
+	std::vector<char> getLetters() const {
+		std::vector<char> letters;
+		for (int i = 1; i < 256; i++) {
+			if (mLetterIndex[i] >= 0) {
+				letters.push_back((char)i);
+			}
+		}
+		return letters;
+	}
+
+	bool jumpToLetter(char letter) {
+		int index = getLetterIndex(letter);
+		if (index < 0) {
+			return false;
+		}
+		mCursor = index;
+		onCursorChanged(CURSOR_STOPPED);
+		return true;
+	}
+
+	// Move the cursor to the first entry of the next (direction > 0) or current/previous (direction < 0)
+	// initial, in list order. Returns false if there is no such entry.
+	bool pageByLetter(int direction) {
+		int target = -1;
+		for (int i = 1; i < 256; i++) {
+			int index = mLetterIndex[i];
+			if (index < 0) {
+				continue;
+			}
+			if (direction > 0 ? (index > mCursor && (target < 0 || index < target)) : (index < mCursor && index > target)) {
+				target = index;
+			}
+		}
+		if (target < 0) {
+			return false;
+		}
+		mCursor = target;
+		onCursorChanged(CURSOR_STOPPED);
+		return true;
 	}
 
 	inline int size() const { return mEntries.size(); }
+	inline const UserData& getObjectAt(int index) const { return mEntries.at(index).object; }
 
 	inline bool isEmpty() const { return mEntries.empty(); }
 	inline int getCursor() const { return mCursor; }
@@ -247,7 +325,49 @@ protected:
 			onCursorChanged(CURSOR_STOPPED);
 		}
 
+		int index = it - mEntries.begin();
+		char letter = (*it).letter;
 		mEntries.erase(it);
+		removeFromLetterIndex(letter, index);
+	}
+
+	void resetLetterIndex() {
+		for (int i = 0; i < 256; i++) {
+			mLetterIndex[i] = -1;
+		}
+	}
+
+	// entries at or after index are shifted by one
+	void insertIntoLetterIndex(char letter, int index) {
+		for (int i = 0; i < 256; i++) {
+			if (mLetterIndex[i] >= index) {
+				mLetterIndex[i]++;
+			}
+		}
+		int& first = mLetterIndex[(unsigned char)letter];
+		if (letter != 0 && (first < 0 || first > index)) {
+			first = index;
+		}
+	}
+
+	// the entry at index has already been erased
+	void removeFromLetterIndex(char letter, int index) {
+		for (int i = 0; i < 256; i++) {
+			if (mLetterIndex[i] > index) {
+				mLetterIndex[i]--;
+			}
+		}
+		int& first = mLetterIndex[(unsigned char)letter];
+		if (letter != 0 && first == index) {
+			// next entry of the same initial, right there when the list is sorted by name
+			first = -1;
+			for (int i = index; i < (int) mEntries.size(); i++) {
+				if (mEntries[i].letter == letter) {
+					first = i;
+					break;
+				}
+			}
+		}
 	}
 
     // see onCursorChanged warn
@@ -256,6 +376,8 @@ protected:
 		mScrollTier = 0;
 		mScrollTierAccumulator = 0;
 		mScrollCursorAccumulator = 0;
+		if (velocity != 0)
+			setUpdating(true, UPDATE_LIST);
 
 		int prevCursor = mCursor;
 		scroll(mScrollVelocity);
@@ -274,7 +396,11 @@ protected:
 			mTitleOverlayOpacity = (unsigned char)op;
 
 		if (mScrollVelocity == 0 || size() < 2)
+		{
+			// nothing left to do once the title overlay has faded out
+			setUpdating(mTitleOverlayOpacity != 0, UPDATE_LIST);
 			return;
+		}
 
 		mScrollCursorAccumulator += deltaTime;
 		mScrollTierAccumulator += deltaTime;
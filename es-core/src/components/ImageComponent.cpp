@@ -15,9 +15,9 @@ Eigen::Vector2i ImageComponent::getTextureSize() const {
     return Eigen::Vector2i::Zero();
 }
 
-ImageComponent::ImageComponent(Window* window, bool forceLoad, bool dynamic) : GuiComponent(window),
+ImageComponent::ImageComponent(Window* window, bool forceLoad, bool dynamic, bool lazy) : GuiComponent(window),
     mTargetIsMax(false), mFlipX(false), mFlipY(false), mTargetSize(0, 0), mColorShift(0xFFFFFFFF),
-    mForceLoad(forceLoad), mDynamic(dynamic), mFadeOpacity(0.0f), mFading(false), mPath("") {
+    mForceLoad(forceLoad), mDynamic(dynamic), mLazy(lazy), mFadeOpacity(0.0f), mFading(false), mPath("") {
     updateColors();
 }
 
@@ -95,7 +95,7 @@ void ImageComponent::setImage(const std::string& path, bool tile) {
     if (path.empty() || !ResourceManager::getInstance()->fileExists(path)) {
         mTexture.reset();
     } else {
-        mTexture = TextureResource::get(path, tile, mForceLoad, mDynamic);
+        mTexture = TextureResource::get(path, tile, mForceLoad, mDynamic, mLazy);
     }
     resize();
 }
@@ -222,7 +222,13 @@ void ImageComponent::render(const Eigen::Affine3f& parentTrans) {
             // The bind() function returns false if the texture is not currently loaded. A blank
             // texture is bound in this case but we want to handle a fade so it doesn't just 'jump' in
             // when it finally loads
-            fadeIn(mTexture->bind());
+            bool loaded = mTexture->bind();
+            if (loaded && mSize.isZero()) {
+                // a lazy texture has no size until it is loaded: lay it out now, it may be rasterized again at that size
+                resize();
+                loaded = mTexture->bind();
+            }
+            fadeIn(loaded);
 
             glEnable(GL_TEXTURE_2D);
             glEnable(GL_BLEND);
@@ -301,44 +307,44 @@ void ImageComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const s
 
     Eigen::Vector2f scale = getParent() ? getParent()->getSize() : Eigen::Vector2f((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
     
-    if (properties & POSITION && elem->has("pos")) {
-        Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>("pos").cwiseProduct(scale);
+    if (properties & POSITION && elem->has(ThemeProperty::POS)) {
+        Eigen::Vector2f denormalized = elem->get<Eigen::Vector2f>(ThemeProperty::POS).cwiseProduct(scale);
         setPosition(Eigen::Vector3f(denormalized.x(), denormalized.y(), 0));
     }
 
     if (properties & ThemeFlags::SIZE) {
-        if (elem->has("size")) {
-            setResize(elem->get<Eigen::Vector2f>("size").cwiseProduct(scale));
-        } else if (elem->has("maxSize")) {
-            setMaxSize(elem->get<Eigen::Vector2f>("maxSize").cwiseProduct(scale));
+        if (elem->has(ThemeProperty::SIZE)) {
+            setResize(elem->get<Eigen::Vector2f>(ThemeProperty::SIZE).cwiseProduct(scale));
+        } else if (elem->has(ThemeProperty::MAX_SIZE)) {
+            setMaxSize(elem->get<Eigen::Vector2f>(ThemeProperty::MAX_SIZE).cwiseProduct(scale));
         }
     }
 
     // position + size also implies origin
-    if ((properties & ORIGIN || (properties & POSITION && properties & ThemeFlags::SIZE)) && elem->has("origin")) {
-        setOrigin(elem->get<Eigen::Vector2f>("origin"));
+    if ((properties & ORIGIN || (properties & POSITION && properties & ThemeFlags::SIZE)) && elem->has(ThemeProperty::ORIGIN)) {
+        setOrigin(elem->get<Eigen::Vector2f>(ThemeProperty::ORIGIN));
     }
 
-    if (properties & PATH && elem->has("path")) {
-        bool tile = (elem->has("tile") && elem->get<bool>("tile"));
-        setImage(elem->get<std::string>("path"), tile);
+    if (properties & PATH && elem->has(ThemeProperty::PATH)) {
+        bool tile = (elem->has(ThemeProperty::TILE) && elem->get<bool>(ThemeProperty::TILE));
+        setImage(elem->get<std::string>(ThemeProperty::PATH), tile);
     }
 
-    if (properties & COLOR && elem->has("color")) {
-        setColorShift(elem->get<unsigned int>("color"));
+    if (properties & COLOR && elem->has(ThemeProperty::COLOR)) {
+        setColorShift(elem->get<unsigned int>(ThemeProperty::COLOR));
     }
 
     if (properties & ThemeFlags::ROTATION) {
-        if (elem->has("rotation")) {
-            setRotationDegrees(elem->get<float>("rotation"));
+        if (elem->has(ThemeProperty::ROTATION)) {
+            setRotationDegrees(elem->get<float>(ThemeProperty::ROTATION));
         }
-        if (elem->has("rotationOrigin")) {
-            setRotationOrigin(elem->get<Eigen::Vector2f>("rotationOrigin"));
+        if (elem->has(ThemeProperty::ROTATION_ORIGIN)) {
+            setRotationOrigin(elem->get<Eigen::Vector2f>(ThemeProperty::ROTATION_ORIGIN));
         }
     }
     
-    if (properties & ThemeFlags::Z_INDEX && elem->has("zIndex")) {
-        setZIndex(elem->get<float>("zIndex"));
+    if (properties & ThemeFlags::Z_INDEX && elem->has(ThemeProperty::Z_INDEX)) {
+        setZIndex(elem->get<float>(ThemeProperty::Z_INDEX));
     } else {
         setZIndex(getDefaultZIndex());
     }
@@ -349,3 +355,9 @@ std::vector<HelpPrompt> ImageComponent::getHelpPrompts() {
     ret.push_back(HelpPrompt("b", _("SELECT")));
     return ret;
 }
+
+void ImageComponent::getTextures(std::vector< std::shared_ptr<TextureResource> >& textures) const
+{
+	if (mTexture)
+		textures.push_back(mTexture);
+}
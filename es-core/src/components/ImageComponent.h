@@ -12,7 +12,8 @@
 class ImageComponent : public GuiComponent
 {
 public:
-	ImageComponent(Window* window, bool forceLoad = false, bool dynamic = true);
+	// lazy: the image is read in the background when first drawn or preloaded, it is laid out once loaded
+	ImageComponent(Window* window, bool forceLoad = false, bool dynamic = true, bool lazy = false);
 	virtual ~ImageComponent();
 
 	//Loads the image at the given filepath. Will tile if tile is true (retrieves texture as tiling, creates vertices accordingly).
@@ -58,6 +59,8 @@ public:
 	virtual void applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties) override;
 
 	virtual std::vector<HelpPrompt> getHelpPrompts() override;
+
+	void getTextures(std::vector< std::shared_ptr<TextureResource> >& textures) const override;
 private:
 	Eigen::Vector2f mTargetSize;
 
@@ -87,6 +90,7 @@ private:
 	bool mFading;
 	bool mForceLoad;
 	bool mDynamic;
+	bool mLazy;
 };
 
 #endif
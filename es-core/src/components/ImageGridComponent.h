@@ -2,14 +2,25 @@
 
 #include "GuiComponent.h"
 #include "components/IList.h"
-#include "components/ImageComponent.h"
+#include "resources/TextureResource.h"
+#include "resources/ThumbnailCache.h"
+#include "ThemeData.h"
+#include "Renderer.h"
 #include "Log.h"
+#include <cmath>
 
 struct ImageGridData
 {
-	std::shared_ptr<TextureResource> texture;
+	std::string imagePath;
 };
 
+//
+// Grid of thumbnails, virtualized: entries only hold their image path, and a fixed pool of
+// tiles sized to the viewport is recycled while scrolling. Entry i is always shown by tile
+// i % pool size, so a row scrolling in only replaces the textures of the tiles it takes over.
+// Textures come from the thumbnail cache, visible ones are bound (and so loaded in the
+// background), the next screen in the scrolling direction is preloaded.
+//
 template<typename T>
 class ImageGridComponent : public IList<ImageGridData, T>
 {
@@ -17,12 +28,12 @@ protected:
 	using IList<ImageGridData, T>::mEntries;
 	using IList<ImageGridData, T>::listUpdate;
 	using IList<ImageGridData, T>::listInput;
-	using IList<ImageGridData, T>::listRenderTitleOverlay;
 	using IList<ImageGridData, T>::getTransform;
 	using IList<ImageGridData, T>::mSize;
 	using IList<ImageGridData, T>::mCursor;
-    using typename IList<ImageGridData, T>::Entry;
+	using typename IList<ImageGridData, T>::Entry;
 	using IList<ImageGridData, T>::mWindow;
+	using IList<ImageGridData, T>::setUpdating;
 
 public:
 	using IList<ImageGridData, T>::size;
@@ -31,83 +42,117 @@ public:
 
 	ImageGridComponent(Window* window);
 
-	void add(const std::string& name, const std::string& imagePath, const T& obj);
-	
+	void add(const std::string& name, const std::string& imagePath, const T& obj, char letter = 0);
+	// the cursor stays on the same entry
+	void insert(const std::string& name, const std::string& imagePath, const T& obj, int index, char letter = 0);
+	void removeAt(int index);
+	void clear();
+
 	void onSizeChanged() override;
 
 	bool input(InputConfig* config, Input input) override;
 	void update(int deltaTime) override;
 	void render(const Eigen::Affine3f& parentTrans) override;
 
-private:
-	Eigen::Vector2f getSquareSize(std::shared_ptr<TextureResource> tex = nullptr) const
-	{
-		Eigen::Vector2f aspect(1, 1);
-
-		if(tex)
-		{
-			const Eigen::Vector2i& texSize = tex->getSize();
+	void applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties) override;
 
-			if(texSize.x() > texSize.y())
-				aspect[0] = (float)texSize.x() / texSize.y();
-			else
-				aspect[1] = (float)texSize.y() / texSize.x();
-		}
+	void getTextures(std::vector< std::shared_ptr<TextureResource> >& textures) const override;
 
-		return Eigen::Vector2f(156 * aspect.x(), 156 * aspect.y());
+private:
+	struct Tile
+	{
+		int entry;
+		std::shared_ptr<TextureResource> texture;
 	};
 
-	Eigen::Vector2f getMaxSquareSize() const
+	struct Vertex
 	{
-		Eigen::Vector2f squareSize(32, 32);
+		Eigen::Vector2f pos;
+		Eigen::Vector2f tex;
+	};
 
-		// calc biggest square size
-		for(auto it = mEntries.begin(); it != mEntries.end(); it++)
-		{
-			Eigen::Vector2f chkSize = getSquareSize(it->data.texture);
-			if(chkSize.x() > squareSize.x())
-				squareSize[0] = chkSize[0];
-			if(chkSize.y() > squareSize.y())
-				squareSize[1] = chkSize[1];
-		}
+	inline int getRowCount() const { return ((int)mEntries.size() + mColumns - 1) / mColumns; }
+	int getTargetRow() const;
 
-		return squareSize;
-	};
+	void buildTiles();
+	void updateTiles();
+	void prefetch(int firstRow, int lastRow);
+	void drawTexture(float x, float y, float width, float height, unsigned int color);
 
-	Eigen::Vector2i getGridSize() const
-	{
-		Eigen::Vector2f squareSize = getMaxSquareSize();
-		Eigen::Vector2i gridSize(mSize.x() / (squareSize.x() + getPadding().x()), mSize.y() / (squareSize.y() + getPadding().y()));
-		return gridSize;
-	};
+	virtual void onCursorChanged(const CursorState& state) override;
 
-	Eigen::Vector2f getPadding() const { return Eigen::Vector2f(24, 24); }
-	
-	void buildImages();
-	void updateImages();
+	// theme
+	Eigen::Vector2f mTileSize;
+	Eigen::Vector2f mMargin;
+	unsigned int mColor;
+	unsigned int mSelectedColor;
 
-	virtual void onCursorChanged(const CursorState& state);
+	// layout
+	int mColumns;
+	int mRows;
+	unsigned int mResolution;
+	Eigen::Vector2f mOffset;
 
-	bool mEntriesDirty;
+	// first visible row, animated towards getTargetRow()
+	float mCamera;
+	int mFirstRow;
+	int mScrollDir;
+	bool mTilesDirty;
 
-	std::vector<ImageComponent> mImages;
+	std::vector<Tile> mTiles;
+	std::vector< std::shared_ptr<TextureResource> > mPrefetched;
 };
 
 template<typename T>
-ImageGridComponent<T>::ImageGridComponent(Window* window) : IList<ImageGridData, T>(window)
+ImageGridComponent<T>::ImageGridComponent(Window* window) : IList<ImageGridData, T>(window, LIST_SCROLL_STYLE_QUICK, LIST_NEVER_LOOP),
+	mColor(0xAAAAAABB), mSelectedColor(0xFFFFFFFF), mColumns(1), mRows(1), mResolution(0),
+	mCamera(0), mFirstRow(0), mScrollDir(1), mTilesDirty(true)
 {
-	mEntriesDirty = true;
+	mTileSize << Renderer::getScreenWidth() * 0.12f, Renderer::getScreenHeight() * 0.2f;
+	mMargin << Renderer::getScreenWidth() * 0.02f, Renderer::getScreenHeight() * 0.03f;
 }
 
 template<typename T>
-void ImageGridComponent<T>::add(const std::string& name, const std::string& imagePath, const T& obj)
+void ImageGridComponent<T>::add(const std::string& name, const std::string& imagePath, const T& obj, char letter)
 {
 	typename IList<ImageGridData, T>::Entry entry;
 	entry.name = name;
 	entry.object = obj;
-	entry.data.texture = ResourceManager::getInstance()->fileExists(imagePath) ? TextureResource::get(imagePath) : TextureResource::get(":/button.png");
+	entry.letter = letter;
+	entry.data.imagePath = imagePath;
 	static_cast<IList< ImageGridData, T >*>(this)->add(entry);
-	mEntriesDirty = true;
+	mTilesDirty = true;
+}
+
+template<typename T>
+void ImageGridComponent<T>::insert(const std::string& name, const std::string& imagePath, const T& obj, int index, char letter)
+{
+	typename IList<ImageGridData, T>::Entry entry;
+	entry.name = name;
+	entry.object = obj;
+	entry.letter = letter;
+	entry.data.imagePath = imagePath;
+	static_cast<IList< ImageGridData, T >*>(this)->insert(entry, index);
+	mTilesDirty = true;
+	onCursorChanged(CURSOR_STOPPED);
+}
+
+template<typename T>
+void ImageGridComponent<T>::removeAt(int index)
+{
+	static_cast<IList< ImageGridData, T >*>(this)->removeAt(index);
+	mTilesDirty = true;
+	onCursorChanged(CURSOR_STOPPED);
+}
+
+template<typename T>
+void ImageGridComponent<T>::clear()
+{
+	IList<ImageGridData, T>::clear();
+	mCamera = 0;
+	mFirstRow = 0;
+	mTilesDirty = true;
+	setUpdating(true);
 }
 
 template<typename T>
@@ -127,7 +172,7 @@ bool ImageGridComponent<T>::input(InputConfig* config, Input input)
 
 		if(dir != Eigen::Vector2i::Zero())
 		{
-			listInput(dir.x() + dir.y() * getGridSize().x());
+			listInput(dir.x() + dir.y() * mColumns);
 			return true;
 		}
 	}else{
@@ -140,116 +185,256 @@ bool ImageGridComponent<T>::input(InputConfig* config, Input input)
 	return GuiComponent::input(config, input);
 }
 
+template<typename T>
+int ImageGridComponent<T>::getTargetRow() const
+{
+	// keep the cursor row in the middle, without scrolling past the ends
+	int row = mCursor / mColumns - mRows / 2;
+	row = std::min(row, getRowCount() - mRows);
+	return std::max(row, 0);
+}
+
 template<typename T>
 void ImageGridComponent<T>::update(int deltaTime)
 {
 	listUpdate(deltaTime);
+
+	// smooth scrolling, the camera catches up with the target row
+	const float target = (float)getTargetRow();
+	if(mCamera != target)
+	{
+		mCamera += (target - mCamera) * std::min(1.0f, deltaTime / 80.0f);
+		if(std::abs(target - mCamera) < 0.01f)
+			mCamera = target;
+	}
+	// idle until the cursor moves again
+	setUpdating(mCamera != target);
+
+	if((int)mCamera != mFirstRow || mTilesDirty)
+		updateTiles();
 }
 
 template<typename T>
 void ImageGridComponent<T>::render(const Eigen::Affine3f& parentTrans)
 {
-	Eigen::Affine3f trans = getTransform() * parentTrans;
+	Eigen::Affine3f trans = parentTrans * getTransform();
 
-	if(mEntriesDirty)
-	{
-		buildImages();
-		updateImages();
-		mEntriesDirty = false;
-	}
+	if(mTilesDirty)
+		updateTiles();
 
-	for(auto it = mImages.begin(); it != mImages.end(); it++)
+	Renderer::pushClipRect(Eigen::Vector2i((int)trans.translation().x(), (int)trans.translation().y()), mSize.template cast<int>());
+	Renderer::setMatrix(trans);
+
+	const Eigen::Vector2f step = mTileSize + mMargin;
+	for(auto it = mTiles.begin(); it != mTiles.end(); it++)
 	{
-		it->render(trans);
+		if(it->entry < 0 || it->entry >= (int)mEntries.size())
+			continue;
+
+		const int row = it->entry / mColumns;
+		const int column = it->entry % mColumns;
+		const bool selected = it->entry == mCursor;
+		float x = mOffset.x() + column * step.x();
+		float y = mOffset.y() + (row - mCamera) * step.y();
+		if(y + mTileSize.y() < 0 || y > mSize.y())
+			continue;
+
+		// the selected tile grows into its margin
+		Eigen::Vector2f box = mTileSize;
+		if(selected)
+		{
+			box += mMargin * 0.9f;
+			x -= mMargin.x() * 0.45f;
+			y -= mMargin.y() * 0.45f;
+		}
+
+		const unsigned int color = selected ? mSelectedColor : mColor;
+		if(it->texture && it->texture->bind() && it->texture->getSize().x() > 0)
+		{
+			// fit the thumbnail in its box, keeping the aspect ratio
+			const Eigen::Vector2i textureSize = it->texture->getSize();
+			const float scale = std::min(box.x() / textureSize.x(), box.y() / textureSize.y());
+			const float width = textureSize.x() * scale;
+			const float height = textureSize.y() * scale;
+			drawTexture(round(x + (box.x() - width) / 2), round(y + (box.y() - height) / 2), round(width), round(height), color);
+		}
+		else
+		{
+			// not loaded yet or no image: a plain placeholder
+			Renderer::drawRect(round(x), round(y), round(box.x()), round(box.y()), (color & 0xFFFFFF00) | ((color & 0xFF) / 3));
+		}
 	}
 
+	Renderer::popClipRect();
+
 	GuiComponent::renderChildren(trans);
 }
 
+template<typename T>
+void ImageGridComponent<T>::drawTexture(float x, float y, float width, float height, unsigned int color)
+{
+	Vertex vertices[6];
+	vertices[0].pos << x, y;
+	vertices[1].pos << x, y + height;
+	vertices[2].pos << x + width, y;
+	vertices[3].pos << x + width, y;
+	vertices[4].pos << x, y + height;
+	vertices[5].pos << x + width, y + height;
+
+	vertices[0].tex << 0, 1;
+	vertices[1].tex << 0, 0;
+	vertices[2].tex << 1, 1;
+	vertices[3].tex << 1, 1;
+	vertices[4].tex << 0, 0;
+	vertices[5].tex << 1, 0;
+
+	GLubyte colors[6 * 4];
+	Renderer::buildGLColorArray(colors, color, 6);
+
+	glEnable(GL_TEXTURE_2D);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+
+	glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].pos);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &vertices[0].tex);
+	glColorPointer(4, GL_UNSIGNED_BYTE, 0, colors);
+
+	glDrawArrays(GL_TRIANGLES, 0, 6);
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+
+	glDisable(GL_TEXTURE_2D);
+	glDisable(GL_BLEND);
+}
+
 template<typename T>
 void ImageGridComponent<T>::onCursorChanged(const CursorState& state)
 {
-	updateImages();
+	const int target = getTargetRow();
+	if(target != mFirstRow)
+		mScrollDir = target > mFirstRow ? 1 : -1;
+	setUpdating(true);
 }
 
 template<typename T>
 void ImageGridComponent<T>::onSizeChanged()
 {
-	buildImages();
-	updateImages();
+	buildTiles();
+}
+
+template<typename T>
+void ImageGridComponent<T>::applyTheme(const std::shared_ptr<ThemeData>& theme, const std::string& view, const std::string& element, unsigned int properties)
+{
+	GuiComponent::applyTheme(theme, view, element, properties);
+
+	const ThemeData::ThemeElement* elem = theme->getElement(view, element, "imagegrid");
+	if(!elem)
+		return;
+
+	Eigen::Vector2f screen((float)Renderer::getScreenWidth(), (float)Renderer::getScreenHeight());
+	if(elem->has(ThemeProperty::TILE_SIZE))
+		mTileSize = elem->get<Eigen::Vector2f>(ThemeProperty::TILE_SIZE).cwiseProduct(screen);
+	if(elem->has(ThemeProperty::MARGIN))
+		mMargin = elem->get<Eigen::Vector2f>(ThemeProperty::MARGIN).cwiseProduct(screen);
+	if(properties & ThemeFlags::COLOR)
+	{
+		if(elem->has(ThemeProperty::COLOR))
+			mColor = elem->get<unsigned int>(ThemeProperty::COLOR);
+		if(elem->has(ThemeProperty::SELECTED_COLOR))
+			mSelectedColor = elem->get<unsigned int>(ThemeProperty::SELECTED_COLOR);
+	}
+
+	buildTiles();
 }
 
-// create and position imagecomponents (mImages)
 template<typename T>
-void ImageGridComponent<T>::buildImages()
+void ImageGridComponent<T>::getTextures(std::vector< std::shared_ptr<TextureResource> >& textures) const
 {
-	mImages.clear();
+	for(auto it = mTiles.begin(); it != mTiles.end(); it++)
+		if(it->texture)
+			textures.push_back(it->texture);
+}
 
-	Eigen::Vector2i gridSize = getGridSize();
-	Eigen::Vector2f squareSize = getMaxSquareSize();
-	Eigen::Vector2f padding = getPadding();
+// size the tile pool to the viewport
+template<typename T>
+void ImageGridComponent<T>::buildTiles()
+{
+	const Eigen::Vector2f step = mTileSize + mMargin;
+	mColumns = std::max(1, (int)((mSize.x() + mMargin.x()) / step.x()));
+	mRows = std::max(1, (int)((mSize.y() + mMargin.y()) / step.y()));
+	mResolution = ThumbnailCache::getResolution((unsigned int)std::max(mTileSize.x(), mTileSize.y()));
+	ThumbnailCache::addDisplayedResolution(mResolution);
 
 	// attempt to center within our size
-	Eigen::Vector2f totalSize(gridSize.x() * (squareSize.x() + padding.x()), gridSize.y() * (squareSize.y() + padding.y()));
-	Eigen::Vector2f offset(mSize.x() - totalSize.x(), mSize.y() - totalSize.y());
-	offset /= 2;
+	mOffset << (mSize.x() - (mColumns * step.x() - mMargin.x())) / 2, (mSize.y() - (mRows * step.y() - mMargin.y())) / 2;
 
-	for(int y = 0; y < gridSize.y(); y++)
-	{
-		for(int x = 0; x < gridSize.x(); x++)
-		{
-			mImages.push_back(ImageComponent(mWindow));
-			ImageComponent& image = mImages.at(y * gridSize.x() + x);
+	// one more row for the one partially shown while scrolling
+	mTiles.clear();
+	mTiles.resize(mColumns * (mRows + 1));
+	for(auto it = mTiles.begin(); it != mTiles.end(); it++)
+		it->entry = -1;
 
-			image.setPosition((squareSize.x() + padding.x()) * (x + 0.5f) + offset.x(), (squareSize.y() + padding.y()) * (y + 0.5f) + offset.y());
-			image.setOrigin(0.5f, 0.5f);
-			image.setResize(squareSize.x(), squareSize.y());
-			image.setImage("");
-		}
-	}
+	mCamera = (float)getTargetRow();
+	mTilesDirty = true;
 }
 
+// give the visible entries to their tiles, keeping the textures of those already shown
 template<typename T>
-void ImageGridComponent<T>::updateImages()
+void ImageGridComponent<T>::updateTiles()
 {
-	if(mImages.empty())
-		buildImages();
+	if(mTiles.empty())
+		buildTiles();
 
-	Eigen::Vector2i gridSize = getGridSize();
+	mFirstRow = (int)mCamera;
+	const int first = mFirstRow * mColumns;
+	const int count = (int)mTiles.size();
 
-	int cursorRow = mCursor / gridSize.x();
-	int cursorCol = mCursor % gridSize.x();
+	for(int entry = first; entry < first + count; entry++)
+	{
+		Tile& tile = mTiles[entry % count];
+		if(tile.entry == entry && !mTilesDirty)
+			continue;
 
-	int start = (cursorRow - (gridSize.y() / 2)) * gridSize.x();
+		tile.entry = entry;
+		if(entry < (int)mEntries.size() && !mEntries[entry].data.imagePath.empty())
+			tile.texture = TextureResource::getThumbnail(mEntries[entry].data.imagePath, mResolution);
+		else
+			tile.texture.reset();
+	}
+	mTilesDirty = false;
 
-	//if we're at the end put the row as close as we can and no higher
-	if(start + (gridSize.x() * gridSize.y()) >= (int)mEntries.size())
-		start = gridSize.x() * ((int)mEntries.size()/gridSize.x() - gridSize.y() + 1);
+	// one screen ahead in the scrolling direction
+	if(mScrollDir > 0)
+		prefetch(mFirstRow + mRows + 1, mFirstRow + 2 * mRows + 1);
+	else
+		prefetch(mFirstRow - mRows, mFirstRow);
+}
 
-	if(start < 0)
-		start = 0;
+template<typename T>
+void ImageGridComponent<T>::prefetch(int firstRow, int lastRow)
+{
+	// built aside, so that the textures still in the window stay referenced:
+	// only those dropped by the swap are freed, or removed from the loading queue
+	std::vector< std::shared_ptr<TextureResource> > prefetched;
 
-	unsigned int i = (unsigned int)start;
-	for(unsigned int img = 0; img < mImages.size(); img++)
+	const int first = std::max(0, firstRow * mColumns);
+	const int last = std::min((int)mEntries.size(), lastRow * mColumns);
+	for(int i = first; i < last; i++)
 	{
-		ImageComponent& image = mImages.at(img);
-		if(i >= (unsigned int)size())
-		{
-			image.setImage("");
+		// the loader takes the latest request first: farthest first
+		const int entry = mScrollDir > 0 ? first + last - 1 - i : i;
+		if(mEntries[entry].data.imagePath.empty())
 			continue;
-		}
-
-		Eigen::Vector2f squareSize = getSquareSize(mEntries.at(i).data.texture);
-		if(i == mCursor)
-		{
-			image.setColorShift(0xFFFFFFFF);
-			image.setResize(squareSize.x() + getPadding().x() * 0.95f, squareSize.y() + getPadding().y() * 0.95f);
-		}else{
-			image.setColorShift(0xAAAAAABB);
-			image.setResize(squareSize.x(), squareSize.y());
-		}
 
-		image.setImage(mEntries.at(i).data.texture);
-		i++;
+		std::shared_ptr<TextureResource> texture = TextureResource::getThumbnail(mEntries[entry].data.imagePath, mResolution);
+		texture->preload();
+		prefetched.push_back(texture);
 	}
+	mPrefetched.swap(prefetched);
 }
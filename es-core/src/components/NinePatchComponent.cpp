@@ -222,6 +222,6 @@ void NinePatchComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, con
 	if(!elem)
 		return;
 
-	if(properties & PATH && elem->has("path"))
-		setImagePath(elem->get<std::string>("path"));
+	if(properties & PATH && elem->has(ThemeProperty::PATH))
+		setImagePath(elem->get<std::string>(ThemeProperty::PATH));
 }
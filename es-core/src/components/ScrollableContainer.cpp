@@ -54,6 +54,7 @@ Eigen::Vector2f ScrollableContainer::getScrollPos() const
 void ScrollableContainer::setScrollPos(const Eigen::Vector2f& pos)
 {
 	mScrollPos = pos;
+	setUpdating(true);
 }
 
 void ScrollableContainer::update(int deltaTime)
@@ -100,9 +101,18 @@ void ScrollableContainer::update(int deltaTime)
 			reset();
 	}
 
+	// nothing to scroll: idle until the next reset, which comes with any change of content
+	if(mAutoScrollSpeed == 0 || contentSize.y() <= getSize().y())
+		setUpdating(false);
+
 	GuiComponent::update(deltaTime);
 }
 
+void ScrollableContainer::onSizeChanged()
+{
+	setUpdating(true);
+}
+
 //this should probably return a box to allow for when controls don't start at 0,0
 Eigen::Vector2f ScrollableContainer::getContentSize()
 {
@@ -126,4 +136,6 @@ void ScrollableContainer::reset()
 	mAutoScrollResetAccumulator = 0;
 	mAutoScrollAccumulator = -mAutoScrollDelay + mAutoScrollSpeed;
 	mAtEnd = false;
+	// the content may have changed, the next update tells if it has to scroll
+	setUpdating(true);
 }
@@ -14,6 +14,7 @@ public:
 
 	void update(int deltaTime) override;
 	void render(const Eigen::Affine3f& parentTrans) override;
+	void onSizeChanged() override;
 	int mAutoScrollDelay; // ms to wait before starting to autoscroll
 	int mAutoScrollSpeed; // ms to wait before scrolling down by mScrollDir
 	int mAutoScrollResetAccumulator;
@@ -37,6 +37,7 @@ bool SliderComponent::input(InputConfig* config, Input input)
 
 		mMoveRate = input.value ? -mSingleIncrement : 0;
 		mMoveAccumulator = -MOVE_REPEAT_DELAY;
+		setUpdating(mMoveRate != 0);
 	}
 	if(config->isMappedTo("right", input))
 	{
@@ -45,6 +46,7 @@ bool SliderComponent::input(InputConfig* config, Input input)
 
 		mMoveRate = input.value ? mSingleIncrement : 0;
 		mMoveAccumulator = -MOVE_REPEAT_DELAY;
+		setUpdating(mMoveRate != 0);
 	}
 
 	return GuiComponent::input(config, input);
@@ -259,18 +259,18 @@ void TextComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const st
 	if(!elem)
 		return;
 
-	if (properties & COLOR && elem->has("color"))
-		setColor(elem->get<unsigned int>("color"));	
+	if (properties & COLOR && elem->has(ThemeProperty::COLOR))
+		setColor(elem->get<unsigned int>(ThemeProperty::COLOR));	
 
 	setRenderBackground(false);
-	if (properties & COLOR && elem->has("backgroundColor")) {
-		setBackgroundColor(elem->get<unsigned int>("backgroundColor"));
+	if (properties & COLOR && elem->has(ThemeProperty::BACKGROUND_COLOR)) {
+		setBackgroundColor(elem->get<unsigned int>(ThemeProperty::BACKGROUND_COLOR));
 		setRenderBackground(true);
 	}
 
-	if(properties & ALIGNMENT && elem->has("alignment"))
+	if(properties & ALIGNMENT && elem->has(ThemeProperty::ALIGNMENT))
 	{
-		std::string str = elem->get<std::string>("alignment");
+		std::string str = elem->get<std::string>(ThemeProperty::ALIGNMENT);
 		if(str == "left")
 			setHorizontalAlignment(ALIGN_LEFT);
 		else if(str == "center")
@@ -281,14 +281,14 @@ void TextComponent::applyTheme(const std::shared_ptr<ThemeData>& theme, const st
 			LOG(LogError) << "Unknown text alignment string: " << str;
 	}
 
-	if(properties & TEXT && elem->has("text"))
-		setText(elem->get<std::string>("text"));
+	if(properties & TEXT && elem->has(ThemeProperty::TEXT))
+		setText(elem->get<std::string>(ThemeProperty::TEXT));
 
-	if(properties & FORCE_UPPERCASE && elem->has("forceUppercase"))
-		setUppercase(elem->get<bool>("forceUppercase"));
+	if(properties & FORCE_UPPERCASE && elem->has(ThemeProperty::FORCE_UPPERCASE))
+		setUppercase(elem->get<bool>(ThemeProperty::FORCE_UPPERCASE));
 
-	if(properties & LINE_SPACING && elem->has("lineSpacing"))
-		setLineSpacing(elem->get<float>("lineSpacing"));
+	if(properties & LINE_SPACING && elem->has(ThemeProperty::LINE_SPACING))
+		setLineSpacing(elem->get<float>(ThemeProperty::LINE_SPACING));
 
 	setFont(Font::getFromTheme(elem, properties, mFont));
 }
@@ -61,6 +61,7 @@ void TextEditComponent::textInput(const char* text)
 	if(mEditing)
 	{
 		mCursorRepeatDir = 0;
+		setUpdating(false);
 		if(text[0] == '\b')
 		{
 			if(mCursor > 0)
@@ -98,7 +99,10 @@ bool TextEditComponent::input(InputConfig* config, Input input)
 	if(input.value == 0)
 	{
 		if(config->isMappedTo("left", input) || config->isMappedTo("right", input))
+		{
 			mCursorRepeatDir = 0;
+			setUpdating(false);
+		}
 
 		return false;
 	}
@@ -139,6 +143,7 @@ bool TextEditComponent::input(InputConfig* config, Input input)
 		{
 			mCursorRepeatDir = config->isMappedTo("left", input) ? -1 : 1;
 			mCursorRepeatTimer = -(CURSOR_REPEAT_START_DELAY - CURSOR_REPEAT_SPEED);
+			setUpdating(true);
 			moveCursor(mCursorRepeatDir);
 		}
 
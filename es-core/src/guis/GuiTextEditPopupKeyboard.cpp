@@ -24,6 +24,7 @@ GuiTextEditPopupKeyboard::GuiTextEditPopupKeyboard(Window* window, const std::st
 
 	mText = std::make_shared<TextEditComponent>(mWindow);
 	mText->setValue(initValue);
+	mLastText = initValue;
 
 	if (!multiLine)
 		mText->setCursor(initValue.size());
@@ -281,7 +282,14 @@ bool GuiTextEditPopupKeyboard::input(InputConfig* config, Input input)
 }
 
 void GuiTextEditPopupKeyboard::update(int deltatime) {
+	if (mTextChangedCallback && mText->getValue() != mLastText) {
+		mLastText = mText->getValue();
+		mTextChangedCallback(mLastText);
+	}
+}
 
+void GuiTextEditPopupKeyboard::setTitle(const std::string& title) {
+	mTitle->setText(strToUpper(title));
 }
 
 // Shifts the keys when user hits the shift button.
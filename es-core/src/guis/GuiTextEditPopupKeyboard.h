@@ -17,6 +17,10 @@ public:
 	void onSizeChanged();
 	std::vector<HelpPrompt> getHelpPrompts() override;
 
+	// Called on update whenever the edited text changed, for live feedback while typing
+	inline void setTextChangedCallback(const std::function<void(const std::string&)>& callback) { mTextChangedCallback = callback; }
+	void setTitle(const std::string& title);
+
 private:
 	void shiftKeys();
 
@@ -52,6 +56,9 @@ private:
 
 	int mxIndex = 0;		// Stores the X index and makes every grid the same.
 
+	std::function<void(const std::string&)> mTextChangedCallback;
+	std::string mLastText;
+
 	bool mMultiLine;
 	bool mShift = false;
 	bool mShiftChange = false;
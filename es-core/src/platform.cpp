@@ -5,6 +5,7 @@
 #include <sys/statvfs.h>
 #include <sstream>
 #include "Settings.h"
+#include "RecalboxConf.h"
 
 #include <fstream>
 
@@ -47,6 +48,8 @@ std::string getHomePath()
 
 int runShutdownCommand()
 {
+	// saves still queued would be lost
+	RecalboxConf::getInstance()->sync();
 #ifdef WIN32 // windows
 	return system("shutdown -s -t 0");
 #else // osx / linux
@@ -56,6 +59,7 @@ int runShutdownCommand()
 
 int runRestartCommand()
 {
+	RecalboxConf::getInstance()->sync();
 #ifdef WIN32 // windows
 	return system("shutdown -r -t 0");
 #else // osx / linux
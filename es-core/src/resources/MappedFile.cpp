@@ -0,0 +1,62 @@
+#include "resources/MappedFile.h"
+#include <fstream>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : mData(NULL), mSize(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	if(mData == NULL)
+		return;
+#ifndef WIN32
+	munmap(mData, mSize);
+#else
+	delete[] mData;
+#endif
+}
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::string& path, size_t minSize)
+{
+	std::unique_ptr<MappedFile> file(new MappedFile());
+
+#ifndef WIN32
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		return nullptr;
+	struct stat info;
+	if(fstat(fd, &info) != 0 || info.st_size <= 0 || (size_t)info.st_size < minSize)
+	{
+		close(fd);
+		return nullptr;
+	}
+	void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED)
+		return nullptr;
+	file->mData = (unsigned char*)data;
+	file->mSize = (size_t)info.st_size;
+#else
+	std::ifstream stream(path, std::ios::binary);
+	if(!stream)
+		return nullptr;
+	stream.seekg(0, stream.end);
+	const std::streamoff size = stream.tellg();
+	stream.seekg(0, stream.beg);
+	if(size <= 0 || (size_t)size < minSize)
+		return nullptr;
+	file->mData = new unsigned char[(size_t)size];
+	file->mSize = (size_t)size;
+	if(!stream.read((char*)file->mData, size))
+		return nullptr;
+#endif
+
+	return file;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+
+//
+// A whole file mapped read-only in memory, for the packed indexes (ThemePack, DatIndex)
+// that are searched in place. Read into memory on platforms without mmap.
+//
+class MappedFile
+{
+public:
+	// nullptr if the file can't be mapped or is smaller than minSize
+	static std::unique_ptr<MappedFile> open(const std::string& path, size_t minSize);
+
+	~MappedFile();
+
+	inline const unsigned char* getData() const { return mData; }
+	inline size_t getSize() const { return mSize; }
+
+private:
+	MappedFile();
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	unsigned char* mData;
+	size_t mSize;
+};
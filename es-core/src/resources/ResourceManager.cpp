@@ -1,5 +1,6 @@
 #include "ResourceManager.h"
 #include "Log.h"
+#include "resources/ThemePack.h"
 #include "../data/Resources.h"
 #include <fstream>
 #include <boost/filesystem.hpp>
@@ -38,6 +39,12 @@ const ResourceData ResourceManager::getFileData(const std::string& path) const
 		return data;
 	}
 
+	//is it packed?
+	std::string packedPath;
+	std::shared_ptr<ThemePack> pack = findPack(path, packedPath);
+	if(pack && pack->contains(packedPath))
+		return pack->getFileData(packedPath);
+
 	//it's not embedded; load the file
 	if(!fs::exists(path))
 	{
@@ -73,9 +80,102 @@ bool ResourceManager::fileExists(const std::string& path) const
 	if(res2hMap.find(path) != res2hMap.end())
 		return true;
 
+	std::string packedPath;
+	std::shared_ptr<ThemePack> pack = findPack(path, packedPath);
+	if(pack && pack->contains(packedPath))
+		return true;
+
 	return fs::exists(path);
 }
 
+std::time_t ResourceManager::getLastWriteTime(const std::string& path) const
+{
+	std::string packedPath;
+	std::shared_ptr<ThemePack> pack = findPack(path, packedPath);
+	if(pack && pack->contains(packedPath))
+		return pack->getLastWriteTime();
+
+	boost::system::error_code ec;
+	return fs::last_write_time(path, ec);
+}
+
+bool ResourceManager::mountPack(const std::string& packPath, const std::string& mountPoint)
+{
+	boost::system::error_code ec;
+	std::time_t modified = fs::last_write_time(packPath, ec);
+
+	{
+		std::lock_guard<std::mutex> lock(mPacksMutex);
+		auto it = mPacks.find(mountPoint);
+		if(it != mPacks.end() && it->second->getPath() == packPath && it->second->getLastWriteTime() == modified)
+			return true;
+	}
+
+	// files still in use keep the previous pack mapped
+	std::shared_ptr<ThemePack> pack = ThemePack::open(packPath);
+	if(!pack)
+	{
+		LOG(LogError) << "Invalid theme pack " << packPath;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mPacksMutex);
+	mPacks[mountPoint] = pack;
+	return true;
+}
+
+void ResourceManager::unmountPack(const std::string& mountPoint)
+{
+	std::lock_guard<std::mutex> lock(mPacksMutex);
+	mPacks.erase(mountPoint);
+}
+
+bool ResourceManager::isPacked(const std::string& path) const
+{
+	std::string packedPath;
+	std::shared_ptr<ThemePack> pack = findPack(path, packedPath);
+	return pack && pack->contains(packedPath);
+}
+
+std::vector<std::string> ResourceManager::getPackedDirectories(const std::string& path) const
+{
+	std::string packedPath;
+	std::shared_ptr<ThemePack> pack = findPack(path, packedPath);
+	if(!pack)
+		return std::vector<std::string>();
+	return pack->getDirectories(packedPath);
+}
+
+std::vector<std::string> ResourceManager::getPackedFiles(const std::string& path) const
+{
+	std::string packedPath;
+	std::shared_ptr<ThemePack> pack = findPack(path, packedPath);
+	if(!pack)
+		return std::vector<std::string>();
+
+	std::vector<std::string> files = pack->getFiles(packedPath);
+	for(auto it = files.begin(); it != files.end(); it++)
+		*it = path + "/" + *it;
+	return files;
+}
+
+std::shared_ptr<ThemePack> ResourceManager::findPack(const std::string& path, std::string& packedPath) const
+{
+	std::lock_guard<std::mutex> lock(mPacksMutex);
+	for(auto it = mPacks.begin(); it != mPacks.end(); it++)
+	{
+		const std::string& mountPoint = it->first;
+		if(path.compare(0, mountPoint.size(), mountPoint) != 0)
+			continue;
+		if(path.size() == mountPoint.size() || path[mountPoint.size()] == '/')
+		{
+			packedPath = path.substr(mountPoint.size());
+			return it->second;
+		}
+	}
+	return nullptr;
+}
+
 void ResourceManager::unloadAll()
 {
 	auto iter = mReloadables.begin();
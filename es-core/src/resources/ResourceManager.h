@@ -4,10 +4,14 @@
 #include <memory>
 #include <map>
 #include <list>
+#include <vector>
+#include <mutex>
+#include <ctime>
 
 //The ResourceManager exists to...
 //Allow loading resources embedded into the executable like an actual file.
 //Allow embedded resources to be optionally remapped to actual files for further customization.
+//Allow theme packs to be served as if their files were in a directory.
 
 struct ResourceData
 {
@@ -16,6 +20,7 @@ struct ResourceData
 };
 
 class ResourceManager;
+class ThemePack;
 
 class IReloadable
 {
@@ -36,6 +41,20 @@ public:
 
 	const ResourceData getFileData(const std::string& path) const;
 	bool fileExists(const std::string& path) const;
+	// The time of the pack for packed files, (time_t)-1 if the file doesn't exist
+	std::time_t getLastWriteTime(const std::string& path) const;
+
+	// Serve the files of a theme pack as the content of mountPoint, before the files really there.
+	// A pack already mounted there is replaced if it changed. Returns false if it is not a valid pack.
+	bool mountPack(const std::string& packPath, const std::string& mountPoint);
+	// Files still in use keep the pack mapped until they are released
+	void unmountPack(const std::string& mountPoint);
+	// True if the file is served from a mounted pack
+	bool isPacked(const std::string& path) const;
+	// Subdirectories of a directory from mounted packs only
+	std::vector<std::string> getPackedDirectories(const std::string& path) const;
+	// Full paths of the files under a directory and its subdirectories, from mounted packs only
+	std::vector<std::string> getPackedFiles(const std::string& path) const;
 
 private:
 	ResourceManager();
@@ -43,6 +62,12 @@ private:
 	static std::shared_ptr<ResourceManager> sInstance;
 
 	ResourceData loadFile(const std::string& path) const;
+	// the pack mounted over a path, and the path relative to it
+	std::shared_ptr<ThemePack> findPack(const std::string& path, std::string& packedPath) const;
+
+	// by mount point, read from the theme loading threads
+	std::map<std::string, std::shared_ptr<ThemePack> > mPacks;
+	mutable std::mutex mPacksMutex;
 
 	std::list< std::weak_ptr<IReloadable> > mReloadables;
 };
@@ -2,6 +2,7 @@
 #include "resources/ResourceManager.h"
 #include "Log.h"
 #include "ImageIO.h"
+#include "resources/ThumbnailCache.h"
 #include "string.h"
 #include "Util.h"
 #include "nanosvg/nanosvg.h"
@@ -11,7 +12,7 @@
 #define DPI 96
 
 TextureData::TextureData(bool tile) : mTile(tile), mTextureID(0), mDataRGBA(nullptr), mScalable(false),
-									  mWidth(0), mHeight(0), mSourceWidth(0.0f), mSourceHeight(0.0f), mSVGImage(NULL)
+									  mWidth(0), mHeight(0), mSourceWidth(0.0f), mSourceHeight(0.0f), mThumbnailResolution(0), mSVGImage(NULL)
 {
 }
 
@@ -141,6 +142,9 @@ bool TextureData::load()
 	// Need to load. See if there is a file
 	if (!mPath.empty())
 	{
+		if (mThumbnailResolution != 0 && loadThumbnail())
+			return true;
+
 		std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
 		const ResourceData& data = rm->getFileData(mPath);
 		// is it an SVG?
@@ -155,6 +159,25 @@ bool TextureData::load()
 	return retval;
 }
 
+bool TextureData::loadThumbnail()
+{
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mDataRGBA)
+			return true;
+	}
+
+	std::vector<unsigned char> imageRGBA;
+	size_t width, height;
+	if (!ThumbnailCache::load(mPath, mThumbnailResolution, imageRGBA, width, height) || imageRGBA.empty())
+		return false;
+
+	mSourceWidth = width;
+	mSourceHeight = height;
+	mScalable = false;
+	return initFromRGBA(imageRGBA.data(), width, height);
+}
+
 bool TextureData::isLoaded()
 {
 	std::unique_lock<std::mutex> lock(mMutex);
@@ -217,14 +240,14 @@ void TextureData::releaseRAM()
 
 size_t TextureData::width()
 {
-	if (mWidth == 0)
+	if (mWidth == 0 && mThumbnailResolution == 0)
 		load();
 	return mWidth;
 }
 
 size_t TextureData::height()
 {
-	if (mHeight == 0)
+	if (mHeight == 0 && mThumbnailResolution == 0)
 		load();
 	return mHeight;
 }
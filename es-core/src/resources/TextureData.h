@@ -23,6 +23,10 @@ public:
 	bool initImageFromMemory(const unsigned char* fileData, size_t length);
 	bool initFromRGBA(const unsigned char* dataRGBA, size_t width, size_t height);
 
+	// Load a downscaled copy from the thumbnail cache instead of the full image.
+	// The size of a thumbnail is unknown until it has been loaded.
+	inline void setThumbnailResolution(unsigned int resolution) { mThumbnailResolution = resolution; }
+
 	// Read the data into memory if necessary
 	bool load();
 
@@ -50,6 +54,8 @@ public:
 	bool tiled() { return mTile; }
 
 private:
+	bool loadThumbnail();
+
 	std::mutex		mMutex;
 	bool			mTile;
 	std::string		mPath;
@@ -61,5 +67,6 @@ private:
 	float			mSourceHeight;
 	bool			mScalable;
 	bool			mReloadable;
+	unsigned int	mThumbnailResolution;
 	NSVGimage*		mSVGImage;
 };
@@ -37,6 +37,8 @@ void TextureDataManager::remove(const TextureResource* key)
 	auto it = mTextureLookup.find(key);
 	if (it != mTextureLookup.end())
 	{
+		// Don't spend time loading a texture nobody wants anymore
+		mLoader->remove(*(*it).second);
 		// Remove the list entry
 		mTextures.erase((*it).second);
 		// And the lookup
@@ -127,6 +129,18 @@ void TextureDataManager::load(std::shared_ptr<TextureData> tex, bool block)
 		tex->load();
 }
 
+void TextureDataManager::release(const TextureResource* key)
+{
+	auto it = mTextureLookup.find(key);
+	if (it == mTextureLookup.end())
+		return;
+
+	std::shared_ptr<TextureData> tex = *(*it).second;
+	mLoader->remove(tex);
+	tex->releaseVRAM();
+	tex->releaseRAM();
+}
+
 TextureLoader::TextureLoader() : mExit(false)
 {
 	mThread = new std::thread(&TextureLoader::threadProc, this);
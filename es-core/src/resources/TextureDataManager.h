@@ -75,6 +75,9 @@ public:
 	size_t  getQueueSize();
 	// Load a texture, freeing resources as necessary to make space
 	void load(std::shared_ptr<TextureData> tex, bool block = false);
+	// Free a texture from VRAM and RAM, and cancel its loading if it is queued.
+	// It stays managed, so it's loaded again the next time it is bound
+	void release(const TextureResource* key);
 
 private:
 
@@ -9,12 +9,26 @@
 
 TextureDataManager		TextureResource::sTextureDataManager;
 std::map< TextureResource::TextureKeyType, std::weak_ptr<TextureResource> > TextureResource::sTextureMap;
+std::map< TextureResource::ThumbnailKeyType, std::weak_ptr<TextureResource> > TextureResource::sThumbnailMap;
 std::set<TextureResource*> 	TextureResource::sAllTextures;
+std::map< std::string, std::pair<size_t, size_t> > TextureResource::sResidencies;
 
-TextureResource::TextureResource(const std::string& path, bool tile, bool dynamic) : mTextureData(nullptr), mForceLoad(false)
+TextureResource::TextureResource(const std::string& path, bool tile, bool dynamic, bool lazy, unsigned int thumbnailResolution)
+	: mTextureData(nullptr), mForceLoad(false), mThumbnailResolution(thumbnailResolution), mHeaderSize(0), mHeaderRead(false)
 {
 // Create a texture data object for this texture
-	if (!path.empty())
+	if (!path.empty() && (lazy || thumbnailResolution != 0))
+	{
+		// Lazy textures and thumbnails are loaded in the background, the size is set when first bound
+		std::shared_ptr<TextureData> data = sTextureDataManager.add(this, tile);
+		data->initFromPath(path);
+		if (thumbnailResolution != 0)
+			data->setThumbnailResolution(thumbnailResolution);
+		mPath = path;
+		mSize << 0, 0;
+		mSourceSize << 0, 0;
+	}
+	else if (!path.empty())
 	{
 		// If there is a path then the 'dynamic' flag tells us whether to use the texture
 		// data manager to manage loading/unloading of this texture
@@ -99,12 +113,20 @@ bool TextureResource::bind()
 	}
 	else
 	{
-		return sTextureDataManager.bind(this);
+		bool bound = sTextureDataManager.bind(this);
+		if (bound && mSize.x() == 0)
+		{
+			// thumbnail loaded in the background
+			std::shared_ptr<TextureData> data = sTextureDataManager.get(this);
+			mSize << data->width(), data->height();
+			mSourceSize << data->sourceWidth(), data->sourceHeight();
+		}
+		return bound;
 	}
 }
 
 
-std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, bool tile, bool forceLoad, bool dynamic)
+std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, bool tile, bool forceLoad, bool dynamic, bool lazy)
 {
 	std::shared_ptr<ResourceManager>& rm = ResourceManager::getInstance();
 
@@ -128,7 +150,7 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 
 	// need to create it
 	std::shared_ptr<TextureResource> tex;
-	tex = std::shared_ptr<TextureResource>(new TextureResource(key.first, tile, dynamic));
+	tex = std::shared_ptr<TextureResource>(new TextureResource(key.first, tile, dynamic, lazy && !forceLoad));
 	std::shared_ptr<TextureData> data = sTextureDataManager.get(tex.get());
 
 	// is it an SVG?
@@ -150,6 +172,23 @@ std::shared_ptr<TextureResource> TextureResource::get(const std::string& path, b
 	return tex;
 }
 
+std::shared_ptr<TextureResource> TextureResource::getThumbnail(const std::string& path, unsigned int resolution)
+{
+	const std::string canonicalPath = getCanonicalPath(path);
+	if(canonicalPath.empty())
+		return get(path);
+
+	ThumbnailKeyType key(canonicalPath, resolution);
+	auto foundTexture = sThumbnailMap.find(key);
+	if(foundTexture != sThumbnailMap.end() && !foundTexture->second.expired())
+		return foundTexture->second.lock();
+
+	std::shared_ptr<TextureResource> tex(new TextureResource(canonicalPath, false, true, true, resolution));
+	sThumbnailMap[key] = std::weak_ptr<TextureResource>(tex);
+	ResourceManager::getInstance()->addReloadable(tex);
+	return tex;
+}
+
 // For scalable source images in textures we want to set the resolution to rasterize at
 void TextureResource::rasterizeAt(size_t width, size_t height)
 {
@@ -164,6 +203,39 @@ void TextureResource::rasterizeAt(size_t width, size_t height)
 		data->load();
 }
 
+size_t TextureResource::getEstimatedMemorySize()
+{
+	if (mSize.x() != 0 || mPath.empty())
+		return getMemorySize();
+
+	// at most the resolution asked
+	if (mThumbnailResolution != 0)
+		return (size_t)mThumbnailResolution * mThumbnailResolution * 4;
+
+	// a scalable image is rasterized at the size it is displayed
+	if (mSourceSize.x() != 0 && mSourceSize.y() != 0)
+		return (size_t)mSourceSize.x() * (size_t)mSourceSize.y() * 4;
+
+	// read once, packed and embedded images are in memory already
+	if (!mHeaderRead)
+	{
+		mHeaderRead = true;
+		size_t width = 0, height = 0;
+		bool known;
+		boost::system::error_code ec;
+		if (boost::filesystem::is_regular_file(mPath, ec))
+			known = ImageIO::getSize(mPath, width, height);
+		else
+		{
+			const ResourceData data = ResourceManager::getInstance()->getFileData(mPath);
+			known = data.ptr && ImageIO::getSizeFromMemory(data.ptr.get(), data.length, width, height);
+		}
+		if (known)
+			mHeaderSize = width * height * 4;
+	}
+	return mHeaderSize;
+}
+
 Eigen::Vector2f TextureResource::getSourceImageSize() const
 {
 	return mSourceSize;
@@ -174,6 +246,24 @@ bool TextureResource::isInitialized() const
 	return true;
 }
 
+void TextureResource::preload()
+{
+	if (mTextureData == nullptr)
+		sTextureDataManager.get(this);
+}
+
+void TextureResource::release()
+{
+	// Textures holding their own data may not be reloadable
+	if (mTextureData == nullptr)
+		sTextureDataManager.release(this);
+}
+
+void TextureResource::setResidency(const std::string& name, size_t used, size_t budget)
+{
+	sResidencies[name] = std::make_pair(used, budget);
+}
+
 size_t TextureResource::getTotalMemUsage()
 {
 	size_t total = 0;
@@ -16,7 +16,11 @@
 class TextureResource : public IReloadable
 {
 public:
-	static std::shared_ptr<TextureResource> get(const std::string& path, bool tile = false, bool forceLoad = false, bool dynamic = true);
+	// A lazy texture is managed and not read until it is bound or preloaded, its size is known once it is loaded.
+	static std::shared_ptr<TextureResource> get(const std::string& path, bool tile = false, bool forceLoad = false, bool dynamic = true, bool lazy = false);
+	// A managed texture loaded from the thumbnail cache, at most resolution x resolution.
+	// Nothing is read until it is bound or preloaded, its size is known once it is loaded.
+	static std::shared_ptr<TextureResource> getThumbnail(const std::string& path, unsigned int resolution);
 	void initFromPixels(const unsigned char* dataRGBA, size_t width, size_t height);
 	virtual void initFromMemory(const char* file, size_t length);
 
@@ -32,11 +36,24 @@ public:
 	const Eigen::Vector2i getSize() const;
 	bool bind();
 
+	// Residency control for textures managed by the texture data manager (no effect on the others).
+	// preload() queues the texture for loading in the background, release() frees it until it is bound again.
+	void preload();
+	void release();
+	// Bytes used by this texture once loaded
+	inline size_t getMemorySize() const { return (size_t)mSize.x() * mSize.y() * 4; }
+	// The same, estimated without loading a lazy texture: from its rasterization size, or the header of its image
+	size_t getEstimatedMemorySize();
+
 	static size_t getTotalMemUsage(); // returns an approximation of total VRAM used by textures (in bytes)
 	static size_t getTotalTextureSize(); // returns the number of bytes that would be used if all textures were in memory
 
+	// Memory a view keeps resident on purpose, against its budget (in bytes), reported in the VRAM overlay
+	static void setResidency(const std::string& name, size_t used, size_t budget);
+	static const std::map< std::string, std::pair<size_t, size_t> >& getResidencies() { return sResidencies; }
+
 protected:
-	TextureResource(const std::string& path, bool tile, bool dynamic);
+	TextureResource(const std::string& path, bool tile, bool dynamic, bool lazy = false, unsigned int thumbnailResolution = 0);
 	virtual void unload(std::shared_ptr<ResourceManager>& rm);
 	virtual void reload(std::shared_ptr<ResourceManager>& rm);
 
@@ -52,8 +69,18 @@ private:
 	Eigen::Vector2f					mSourceSize;
 	bool							mForceLoad;
 
+	// of a lazy texture or thumbnail, for its estimated size
+	std::string						mPath;
+	unsigned int					mThumbnailResolution;
+	size_t							mHeaderSize;
+	bool							mHeaderRead;
+
 	typedef std::pair<std::string, bool> TextureKeyType;
 	static std::map< TextureKeyType, std::weak_ptr<TextureResource> > sTextureMap; // map of textures, used to prevent duplicate textures
+	typedef std::pair<std::string, unsigned int> ThumbnailKeyType;
+	static std::map< ThumbnailKeyType, std::weak_ptr<TextureResource> > sThumbnailMap;
 
 	static std::set<TextureResource*> 	sAllTextures;	// Set of all textures, used for memory management
+
+	static std::map< std::string, std::pair<size_t, size_t> > sResidencies;
 };
@@ -0,0 +1,281 @@
+#include "resources/ThemePack.h"
+#include "resources/MappedFile.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+
+namespace fs = boost::filesystem;
+
+#define PACK_MAGIC		"ESPACK01"
+#define PACK_ALIGNMENT	16
+
+static inline uint64_t align(uint64_t offset)
+{
+	return (offset + PACK_ALIGNMENT - 1) & ~(uint64_t)(PACK_ALIGNMENT - 1);
+}
+
+ThemePack::ThemePack() : mLastWriteTime(0), mData(NULL), mSize(0), mEntries(NULL), mCount(0), mNames(NULL)
+{
+}
+
+ThemePack::~ThemePack()
+{
+}
+
+std::shared_ptr<ThemePack> ThemePack::open(const std::string& path)
+{
+	std::shared_ptr<ThemePack> pack(new ThemePack());
+	pack->mPath = path;
+
+	boost::system::error_code ec;
+	pack->mLastWriteTime = fs::last_write_time(path, ec);
+	if(ec)
+		return nullptr;
+
+	pack->mFile = MappedFile::open(path, sizeof(Header));
+	if(!pack->mFile)
+		return nullptr;
+	pack->mData = pack->mFile->getData();
+	pack->mSize = pack->mFile->getSize();
+
+	// everything is checked once here, lookups then trust the index
+	const Header* header = (const Header*)pack->mData;
+	if(memcmp(header->magic, PACK_MAGIC, sizeof(header->magic)) != 0)
+		return nullptr;
+
+	const uint64_t namesOffset = sizeof(Header) + (uint64_t)header->count * sizeof(Entry);
+	if(namesOffset + header->namesSize > pack->mSize)
+		return nullptr;
+
+	pack->mCount = header->count;
+	pack->mEntries = (const Entry*)(pack->mData + sizeof(Header));
+	pack->mNames = (const char*)pack->mData + namesOffset;
+
+	for(uint32_t i = 0; i < pack->mCount; i++)
+	{
+		const Entry& entry = pack->mEntries[i];
+		if(entry.offset > pack->mSize || entry.size > pack->mSize - entry.offset ||
+			(uint64_t)entry.nameOffset + entry.nameLength > header->namesSize)
+			return nullptr;
+		if(i > 0 && pack->getName(pack->mEntries[i - 1]) >= pack->getName(entry))
+			return nullptr;
+	}
+
+	return pack;
+}
+
+std::string ThemePack::normalize(const std::string& path)
+{
+	std::vector<std::string> components;
+	size_t start = 0;
+	while(start <= path.size())
+	{
+		size_t end = path.find('/', start);
+		if(end == std::string::npos)
+			end = path.size();
+
+		const std::string component = path.substr(start, end - start);
+		if(component == "..")
+		{
+			if(!components.empty())
+				components.pop_back();
+		}
+		else if(!component.empty() && component != ".")
+			components.push_back(component);
+
+		start = end + 1;
+	}
+
+	std::string normalized;
+	for(auto it = components.begin(); it != components.end(); it++)
+	{
+		if(!normalized.empty())
+			normalized += '/';
+		normalized += *it;
+	}
+	return normalized;
+}
+
+bool ThemePack::isBefore(const Entry& entry, const std::string& name) const
+{
+	// the order of std::string, the writer sorted with it
+	int order = memcmp(mNames + entry.nameOffset, name.data(), std::min((size_t)entry.nameLength, name.size()));
+	return order < 0 || (order == 0 && entry.nameLength < name.size());
+}
+
+const ThemePack::Entry* ThemePack::find(const std::string& path) const
+{
+	const std::string name = normalize(path);
+	const Entry* end = mEntries + mCount;
+	const Entry* it = std::lower_bound(mEntries, end, name, [this](const Entry& entry, const std::string& name) { return isBefore(entry, name); });
+	if(it == end || it->nameLength != name.size() || memcmp(mNames + it->nameOffset, name.data(), name.size()) != 0)
+		return NULL;
+	return it;
+}
+
+bool ThemePack::contains(const std::string& path) const
+{
+	return find(path) != NULL;
+}
+
+ResourceData ThemePack::getFileData(const std::string& path) const
+{
+	const Entry* entry = find(path);
+	if(entry == NULL)
+	{
+		ResourceData data = { NULL, 0 };
+		return data;
+	}
+
+	// shares the ownership of the pack
+	ResourceData data = {
+		std::shared_ptr<unsigned char>(shared_from_this(), const_cast<unsigned char*>(mData + entry->offset)),
+		(size_t)entry->size
+	};
+	return data;
+}
+
+std::vector<std::string> ThemePack::getDirectories(const std::string& path) const
+{
+	std::string prefix = normalize(path);
+	if(!prefix.empty())
+		prefix += '/';
+
+	// names under a directory are contiguous in the index
+	std::vector<std::string> directories;
+	const Entry* end = mEntries + mCount;
+	const Entry* it = std::lower_bound(mEntries, end, prefix, [this](const Entry& entry, const std::string& name) { return isBefore(entry, name); });
+	for(; it != end; it++)
+	{
+		const std::string name = getName(*it);
+		if(name.compare(0, prefix.size(), prefix) != 0)
+			break;
+
+		const size_t slash = name.find('/', prefix.size());
+		if(slash == std::string::npos)
+			continue;
+
+		const std::string directory = name.substr(prefix.size(), slash - prefix.size());
+		if(directories.empty() || directories.back() != directory)
+			directories.push_back(directory);
+	}
+	return directories;
+}
+
+std::vector<std::string> ThemePack::getFiles(const std::string& path) const
+{
+	std::string prefix = normalize(path);
+	if(!prefix.empty())
+		prefix += '/';
+
+	std::vector<std::string> files;
+	const Entry* end = mEntries + mCount;
+	const Entry* it = std::lower_bound(mEntries, end, prefix, [this](const Entry& entry, const std::string& name) { return isBefore(entry, name); });
+	for(; it != end; it++)
+	{
+		const std::string name = getName(*it);
+		if(name.compare(0, prefix.size(), prefix) != 0)
+			break;
+		files.push_back(name.substr(prefix.size()));
+	}
+	return files;
+}
+
+bool ThemePack::write(const std::string& directory, const std::string& path, std::string& error)
+{
+	boost::system::error_code ec;
+	if(!fs::is_directory(directory, ec))
+	{
+		error = directory + " is not a directory";
+		return false;
+	}
+
+	std::string root = fs::path(directory).generic_string();
+	while(root.size() > 1 && root[root.size() - 1] == '/')
+		root.erase(root.size() - 1);
+	const std::string output = fs::absolute(path).generic_string();
+
+	std::vector< std::pair<std::string, fs::path> > files;
+	for(fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec))
+	{
+		if(!fs::is_regular_file(it->status()) || fs::absolute(it->path()).generic_string() == output)
+			continue;
+		files.push_back(std::make_pair(it->path().generic_string().substr(root.size() + 1), it->path()));
+	}
+	if(ec)
+	{
+		error = "can't read " + root + ": " + ec.message();
+		return false;
+	}
+	std::sort(files.begin(), files.end());
+
+	Header header;
+	memcpy(header.magic, PACK_MAGIC, sizeof(header.magic));
+	header.count = (uint32_t)files.size();
+	header.namesSize = 0;
+	for(auto it = files.begin(); it != files.end(); it++)
+		header.namesSize += (uint32_t)it->first.size();
+
+	std::vector<Entry> entries(files.size());
+	uint64_t offset = align(sizeof(Header) + entries.size() * sizeof(Entry) + header.namesSize);
+	uint32_t nameOffset = 0;
+	for(size_t i = 0; i < files.size(); i++)
+	{
+		entries[i].offset = offset;
+		entries[i].size = fs::file_size(files[i].second, ec);
+		if(ec)
+		{
+			error = "can't read " + files[i].second.generic_string() + ": " + ec.message();
+			return false;
+		}
+		entries[i].nameOffset = nameOffset;
+		entries[i].nameLength = (uint32_t)files[i].first.size();
+		nameOffset += entries[i].nameLength;
+		offset = align(offset + entries[i].size);
+	}
+
+	const std::string temporary = path + ".tmp";
+	std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+	stream.write((const char*)&header, sizeof(header));
+	if(!entries.empty())
+		stream.write((const char*)&entries[0], entries.size() * sizeof(Entry));
+	for(auto it = files.begin(); it != files.end(); it++)
+		stream.write(it->first.data(), it->first.size());
+
+	static const char padding[PACK_ALIGNMENT] = { 0 };
+	for(size_t i = 0; i < files.size() && stream; i++)
+	{
+		stream.write(padding, entries[i].offset - (uint64_t)stream.tellp());
+
+		// inserting an empty buffer would fail the stream
+		if(entries[i].size == 0)
+			continue;
+		std::ifstream input(files[i].second.string(), std::ios::binary);
+		stream << input.rdbuf();
+		if((uint64_t)stream.tellp() != entries[i].offset + entries[i].size)
+		{
+			error = "can't read " + files[i].second.generic_string();
+			stream.close();
+			fs::remove(temporary, ec);
+			return false;
+		}
+	}
+	stream.close();
+
+	if(stream.fail())
+	{
+		error = "can't write " + temporary;
+		fs::remove(temporary, ec);
+		return false;
+	}
+
+	fs::rename(temporary, path, ec);
+	if(ec)
+	{
+		error = "can't write " + path + ": " + ec.message();
+		fs::remove(temporary, ec);
+		return false;
+	}
+	return true;
+}
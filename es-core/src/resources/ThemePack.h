@@ -0,0 +1,79 @@
+#pragma once
+
+#include "resources/ResourceManager.h"
+#include <stdint.h>
+#include <ctime>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+//
+// A theme directory packed in a single indexed file, mapped in memory once.
+// Files are then read without any system call, straight from the mapping.
+//
+// Layout, integers in little endian:
+//   header   "ESPACK01", uint32 entry count, uint32 names size
+//   entries  count x { uint64 offset, uint64 size, uint32 name offset, uint32 name length }, sorted by name
+//   names    paths relative to the theme directory, '/' separated, not terminated
+//   data     file contents, each aligned on 16 bytes
+//
+// Packs are written by the es-themepack tool.
+//
+class ThemePack : public std::enable_shared_from_this<ThemePack>
+{
+public:
+	// nullptr if the file can't be mapped or is not a valid pack
+	static std::shared_ptr<ThemePack> open(const std::string& path);
+
+	// Pack the files of a directory. Written to a temporary file first, the pack is replaced atomically.
+	static bool write(const std::string& directory, const std::string& path, std::string& error);
+
+	~ThemePack();
+
+	inline const std::string& getPath() const { return mPath; }
+	inline std::time_t getLastWriteTime() const { return mLastWriteTime; }
+
+	// Paths are relative to the pack root, "." and ".." components are resolved.
+	bool contains(const std::string& path) const;
+	// A view into the mapping, that keeps the pack mapped while referenced. Empty if not found.
+	ResourceData getFileData(const std::string& path) const;
+	// Names of the subdirectories of a packed directory ("" for the pack root)
+	std::vector<std::string> getDirectories(const std::string& path) const;
+	// Paths of the files under a packed directory and its subdirectories, relative to it
+	std::vector<std::string> getFiles(const std::string& path) const;
+
+private:
+	struct Header
+	{
+		char magic[8];
+		uint32_t count;
+		uint32_t namesSize;
+	};
+
+	struct Entry
+	{
+		uint64_t offset;
+		uint64_t size;
+		uint32_t nameOffset;
+		uint32_t nameLength;
+	};
+
+	ThemePack();
+
+	bool isBefore(const Entry& entry, const std::string& name) const;
+	const Entry* find(const std::string& path) const;
+	inline std::string getName(const Entry& entry) const { return std::string(mNames + entry.nameOffset, entry.nameLength); }
+
+	static std::string normalize(const std::string& path);
+
+	std::string mPath;
+	std::time_t mLastWriteTime;
+
+	std::unique_ptr<MappedFile> mFile;
+	const unsigned char* mData;
+	size_t mSize;
+	const Entry* mEntries;
+	uint32_t mCount;
+	const char* mNames;
+};
@@ -0,0 +1,243 @@
+#include "resources/ThumbnailCache.h"
+#include "ImageIO.h"
+#include "Log.h"
+#include "platform.h"
+#include "Settings.h"
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+
+#define MIN_RESOLUTION	64
+#define MAX_RESOLUTION	512
+
+static std::mutex sDisplayedMutex;
+static std::set<unsigned int> sDisplayedResolutions;
+
+struct IndexEntry
+{
+	size_t size;
+	// of the last use, the write time of the file until then
+	std::time_t time;
+};
+
+static std::mutex sIndexMutex;
+static bool sIndexLoaded = false;
+// by cache path
+static std::map<std::string, IndexEntry> sIndex;
+static size_t sIndexSize = 0;
+
+static std::string getCacheDirectory()
+{
+	return getHomePath() + "/.emulationstation/thumbnails";
+}
+
+unsigned int ThumbnailCache::getResolution(unsigned int size)
+{
+	unsigned int resolution = MIN_RESOLUTION;
+	while (resolution < size && resolution < MAX_RESOLUTION)
+		resolution *= 2;
+	return resolution;
+}
+
+void ThumbnailCache::addDisplayedResolution(unsigned int resolution)
+{
+	std::lock_guard<std::mutex> lock(sDisplayedMutex);
+	sDisplayedResolutions.insert(resolution);
+}
+
+std::vector<unsigned int> ThumbnailCache::getDisplayedResolutions()
+{
+	std::lock_guard<std::mutex> lock(sDisplayedMutex);
+	return std::vector<unsigned int>(sDisplayedResolutions.begin(), sDisplayedResolutions.end());
+}
+
+std::string ThumbnailCache::getCachePath(const std::string& imagePath, unsigned int resolution)
+{
+	std::stringstream ss;
+	ss << getCacheDirectory() << "/" << resolution << "/" << std::hex << std::hash<std::string>()(imagePath) << ".png";
+	return ss.str();
+}
+
+// Load a file as a 32 bits bitmap
+static FIBITMAP* loadBitmap(const std::string& path)
+{
+	FREE_IMAGE_FORMAT format = FreeImage_GetFileType(path.c_str(), 0);
+	if (format == FIF_UNKNOWN)
+		format = FreeImage_GetFIFFromFilename(path.c_str());
+	if (format == FIF_UNKNOWN || !FreeImage_FIFSupportsReading(format))
+		return nullptr;
+
+	FIBITMAP* bitmap = FreeImage_Load(format, path.c_str());
+	if (bitmap != nullptr && FreeImage_GetBPP(bitmap) != 32)
+	{
+		FIBITMAP* converted = FreeImage_ConvertTo32Bits(bitmap);
+		FreeImage_Unload(bitmap);
+		bitmap = converted;
+	}
+	return bitmap;
+}
+
+bool ThumbnailCache::load(const std::string& imagePath, unsigned int resolution, std::vector<unsigned char>& rgba, size_t& width, size_t& height)
+{
+	// resources embedded in the binary are small already
+	if (imagePath.empty() || imagePath[0] == ':')
+		return false;
+
+	boost::system::error_code error;
+	std::time_t imageTime = fs::last_write_time(imagePath, error);
+	if (error)
+		return false;
+
+	const std::string cachePath = getCachePath(imagePath, resolution);
+	std::time_t cacheTime = fs::last_write_time(cachePath, error);
+	if (!error && cacheTime >= imageTime)
+	{
+		FIBITMAP* cached = loadBitmap(cachePath);
+		if (cached != nullptr)
+		{
+			touch(cachePath);
+			rgba = ImageIO::toRGBA32(cached, width, height);
+			FreeImage_Unload(cached);
+			return true;
+		}
+	}
+
+	FIBITMAP* bitmap = loadBitmap(imagePath);
+	if (bitmap == nullptr)
+		return false;
+
+	FIBITMAP* scaled = scale(bitmap, resolution, cachePath);
+	if (scaled != nullptr)
+	{
+		FreeImage_Unload(bitmap);
+		bitmap = scaled;
+	}
+
+	rgba = ImageIO::toRGBA32(bitmap, width, height);
+	FreeImage_Unload(bitmap);
+	return true;
+}
+
+void ThumbnailCache::loadIndex()
+{
+	if (sIndexLoaded)
+		return;
+	sIndexLoaded = true;
+
+	boost::system::error_code error;
+	for (fs::recursive_directory_iterator it(getCacheDirectory(), error), end; !error && it != end; it.increment(error))
+	{
+		if (!fs::is_regular_file(it->status()))
+			continue;
+
+		// left by an interrupted write
+		if (it->path().extension() == ".tmp")
+		{
+			fs::remove(it->path(), error);
+			continue;
+		}
+
+		IndexEntry entry = { (size_t)fs::file_size(it->path(), error), fs::last_write_time(it->path(), error) };
+		sIndex[it->path().generic_string()] = entry;
+		sIndexSize += entry.size;
+	}
+
+	LOG(LogInfo) << "Thumbnail cache: " << sIndex.size() << " thumbnails, " << sIndexSize / 1024 << " KB";
+}
+
+void ThumbnailCache::touch(const std::string& cachePath)
+{
+	std::lock_guard<std::mutex> lock(sIndexMutex);
+	loadIndex();
+
+	auto entry = sIndex.find(cachePath);
+	if (entry != sIndex.end())
+		entry->second.time = std::time(nullptr);
+}
+
+void ThumbnailCache::added(const std::string& cachePath)
+{
+	std::lock_guard<std::mutex> lock(sIndexMutex);
+	loadIndex();
+
+	boost::system::error_code error;
+	IndexEntry entry = { (size_t)fs::file_size(cachePath, error), std::time(nullptr) };
+	if (error)
+		return;
+
+	auto previous = sIndex.find(cachePath);
+	if (previous != sIndex.end())
+		sIndexSize -= previous->second.size;
+	sIndex[cachePath] = entry;
+	sIndexSize += entry.size;
+
+	evict();
+}
+
+void ThumbnailCache::evict()
+{
+	const size_t limit = (size_t)Settings::getInstance()->getInt("ThumbnailCacheSize") * 1024 * 1024;
+	if (sIndexSize <= limit)
+		return;
+
+	// least recently used first, down to 90% of the limit so that the next thumbnails don't evict again
+	std::vector< std::pair<std::time_t, std::string> > byAge;
+	for (auto it = sIndex.begin(); it != sIndex.end(); it++)
+		byAge.push_back(std::make_pair(it->second.time, it->first));
+	std::sort(byAge.begin(), byAge.end());
+
+	boost::system::error_code error;
+	for (auto it = byAge.begin(); it != byAge.end() && sIndexSize > limit / 10 * 9; it++)
+	{
+		auto entry = sIndex.find(it->second);
+		fs::remove(entry->first, error);
+		sIndexSize -= entry->second.size;
+		sIndex.erase(entry);
+	}
+}
+
+void ThumbnailCache::store(const std::string& imagePath, FIBITMAP* image, unsigned int resolution)
+{
+	FIBITMAP* scaled = scale(image, resolution, getCachePath(imagePath, resolution));
+	if (scaled != nullptr)
+		FreeImage_Unload(scaled);
+}
+
+FIBITMAP* ThumbnailCache::scale(FIBITMAP* bitmap, unsigned int resolution, const std::string& cachePath)
+{
+	unsigned int sourceWidth = FreeImage_GetWidth(bitmap);
+	unsigned int sourceHeight = FreeImage_GetHeight(bitmap);
+	if (sourceWidth <= resolution && sourceHeight <= resolution)
+		return nullptr;
+
+	float scale = std::min((float)resolution / sourceWidth, (float)resolution / sourceHeight);
+	int scaledWidth = std::max(1, (int)(sourceWidth * scale));
+	int scaledHeight = std::max(1, (int)(sourceHeight * scale));
+	FIBITMAP* scaled = FreeImage_Rescale(bitmap, scaledWidth, scaledHeight, FILTER_BILINEAR);
+	if (scaled == nullptr)
+		return nullptr;
+
+	// written aside then renamed, a thumbnail is never read half written.
+	// The same thumbnail may be written by a texture loader and the scraper at once: each has its own temporary file
+	boost::system::error_code error;
+	fs::create_directories(fs::path(cachePath).parent_path(), error);
+	const std::string tempPath = fs::unique_path(cachePath + ".%%%%-%%%%.tmp", error).string();
+	if (!error && FreeImage_Save(FIF_PNG, scaled, tempPath.c_str(), PNG_Z_BEST_SPEED))
+	{
+		fs::rename(tempPath, cachePath, error);
+		if (error)
+			fs::remove(tempPath, error);
+		else
+			added(cachePath);
+	}
+	else
+		LOG(LogWarning) << "Could not write thumbnail " << cachePath;
+	return scaled;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <FreeImage.h>
+#include <string>
+#include <vector>
+
+//
+// Downscaled copies of images, for views showing many of them at once (the gamelist grid).
+// Thumbnails are kept on disk in a few fixed resolutions, so that an image is decoded at full
+// size once, then only its small copy is read. A thumbnail is rebuilt when its image changes.
+// The least recently used thumbnails are evicted past "ThumbnailCacheSize" (MB).
+//
+class ThumbnailCache
+{
+public:
+	// Smallest cached resolution covering a displayed size
+	static unsigned int getResolution(unsigned int size);
+
+	// Decode an image scaled down to fit resolution x resolution, from the cache when possible.
+	// Returns false if the image could not be read, the caller can then load it as usual.
+	static bool load(const std::string& imagePath, unsigned int resolution, std::vector<unsigned char>& rgba, size_t& width, size_t& height);
+
+	// Write the thumbnail of an image decoded by someone else (the scraper), so that it is not decoded again for it.
+	// Nothing is written for an image that fits the resolution already.
+	static void store(const std::string& imagePath, FIBITMAP* image, unsigned int resolution);
+
+	// Resolutions the grids display, the ones worth storing thumbnails for ahead of time
+	static void addDisplayedResolution(unsigned int resolution);
+	static std::vector<unsigned int> getDisplayedResolutions();
+
+	// Where the thumbnail of an image is kept
+	static std::string getCachePath(const std::string& imagePath, unsigned int resolution);
+
+private:
+	// Scaled down copy of a bitmap larger than resolution, saved at cachePath; nullptr if it fits already
+	static FIBITMAP* scale(FIBITMAP* bitmap, unsigned int resolution, const std::string& cachePath);
+
+	// Index of the files in the cache, built from the cache directory on first use. The index lock must be held.
+	static void loadIndex();
+	static void touch(const std::string& cachePath);
+	static void added(const std::string& cachePath);
+	static void evict();
+};
@@ -0,0 +1,38 @@
+// es-themepack: packs a theme set directory in a single file, served by ResourceManager as the directory itself.
+// A pack placed in a themes directory as <name>.pack is listed as the theme set <name>.
+
+#include "resources/ThemePack.h"
+#include <boost/filesystem.hpp>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+	if(argc < 2 || argc > 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <theme directory> [<pack file>]\n"
+			<< "The pack file defaults to <theme directory>.pack\n";
+		return 1;
+	}
+
+	std::string directory = boost::filesystem::path(argv[1]).generic_string();
+	while(directory.size() > 1 && directory[directory.size() - 1] == '/')
+		directory.erase(directory.size() - 1);
+	const std::string pack = argc == 3 ? argv[2] : directory + ".pack";
+
+	std::string error;
+	if(!ThemePack::write(directory, pack, error))
+	{
+		std::cerr << "Can't pack " << directory << ": " << error << "\n";
+		return 1;
+	}
+
+	// read it back, as it will be
+	if(!ThemePack::open(pack))
+	{
+		std::cerr << "Invalid pack written to " << pack << "\n";
+		return 1;
+	}
+
+	std::cout << "Packed " << directory << " in " << pack << "\n";
+	return 0;
+}